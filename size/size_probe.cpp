@@ -0,0 +1,61 @@
+/**
+ * Footprint probe: the smallest useful sketch for one processor configuration.
+ *
+ * Built for an ATmega328 by `size_report.py`, once per `SIZE_PROBE_CONFIG`:
+ *   0  no processor, the Arduino core and `Serial` only
+ *   1  `PMS5003T_FULL_PROCESSOR_T`, every feature and 10 observer slots
+ *   2  2 observer slots, `SENSOR_FEATURE_STATS` only
+ *   3  1 observer slot, no optional feature
+ *   4  `PMS5003T_PROCESSOR_T`, the default
+ *
+ * `OBJECT_BUDGET` is the size of the processor on a 64-bit host, where every member is at least
+ * as large as on AVR, so the assertion only fires when the object itself grew.
+ */
+#include <Arduino.h>
+#include "PMS5003T.h"
+
+#ifndef SIZE_PROBE_CONFIG
+    #define SIZE_PROBE_CONFIG 1
+#endif
+
+#if SIZE_PROBE_CONFIG == 1
+    typedef debuguear::PMS5003T_FULL_PROCESSOR_T Processor;
+    static constexpr size_t OBJECT_BUDGET = 768;
+#elif SIZE_PROBE_CONFIG == 2
+    typedef debuguear::AirQualitySensor<debuguear::LayoutPMS5003T, 2, debuguear::SENSOR_FEATURE_STATS> Processor;
+    static constexpr size_t OBJECT_BUDGET = 256;
+#elif SIZE_PROBE_CONFIG == 3
+    typedef debuguear::AirQualitySensor<debuguear::LayoutPMS5003T, 1, debuguear::SENSOR_FEATURES_NONE> Processor;
+    static constexpr size_t OBJECT_BUDGET = 160;
+#elif SIZE_PROBE_CONFIG == 4
+    typedef debuguear::PMS5003T_PROCESSOR_T Processor;
+    static constexpr size_t OBJECT_BUDGET = 288;
+#endif
+
+#if SIZE_PROBE_CONFIG != 0
+    static_assert(sizeof(Processor) <= OBJECT_BUDGET, "processor object over its RAM budget");
+
+    Processor processor(&Serial, 1);
+    volatile uint16_t lastPm25;
+
+    static void onReading(debuguear::AirQualityModel_PMS5003T *data) {
+        lastPm25 = data->pm25_standard;
+    }
+#endif
+
+void setup() {
+    Serial.begin(9600);
+#if SIZE_PROBE_CONFIG != 0
+    processor.addObserver(onReading);
+#endif
+}
+
+void loop() {
+#if SIZE_PROBE_CONFIG != 0
+    processor.loop();
+#else
+    if (Serial.available() > 0) {
+        Serial.read();
+    }
+#endif
+}
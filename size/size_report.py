@@ -0,0 +1,69 @@
+#!/usr/bin/env python3
+"""Builds size_probe.cpp for an ATmega328 in each processor configuration, reports its RAM
+and flash usage, and exits with 1 when a configuration fails to build or grows past its budget.
+
+The budgets are ceilings, not measurements: 256 bytes of RAM for the Arduino core and `Serial`,
+plus the processor object budget of size_probe.cpp (the object size on a 64-bit host, which
+no AVR build exceeds), and generous flash figures. Lower them to the measured figures plus a
+small margin once a nanoatmega328 report is at hand.
+
+    python size/size_report.py            # all configurations
+    python size/size_report.py minimal    # only some of them
+
+Needs PlatformIO (`pip install platformio`).
+"""
+import os
+import re
+import subprocess
+import sys
+
+BOARD = "nanoatmega328"
+
+# name: (SIZE_PROBE_CONFIG, RAM budget, flash budget), in bytes
+CONFIGURATIONS = {
+    "baseline": (0, 256, 2048),
+    "full": (1, 1024, 16384),
+    "stats": (2, 512, 8192),
+    "minimal": (3, 448, 6144),
+    "default": (4, 544, 8192),
+}
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+ROOT = os.path.dirname(HERE)
+USAGE = re.compile(r"^(RAM|Flash):.*\(used (\d+) bytes", re.MULTILINE)
+
+
+def measure(config):
+    command = [
+        "pio", "ci", os.path.join(HERE, "size_probe.cpp"),
+        "--lib", os.path.join(ROOT, "src"),
+        "--board", BOARD,
+        "--project-option", "build_flags=-DSIZE_PROBE_CONFIG=%d" % config,
+    ]
+    result = subprocess.run(command, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+    if result.returncode != 0:
+        sys.stdout.write(result.stdout)
+        return None
+    usage = dict((kind, int(used)) for kind, used in USAGE.findall(result.stdout))
+    return usage.get("RAM"), usage.get("Flash")
+
+
+def main(names):
+    failed = False
+    print("%-10s %11s %13s" % ("config", "RAM/budget", "flash/budget"))
+    for name in names or CONFIGURATIONS:
+        config, ram_budget, flash_budget = CONFIGURATIONS[name]
+        measured = measure(config)
+        if measured is None or None in measured:
+            print("%-10s build failed" % name)
+            failed = True
+            continue
+        ram, flash = measured
+        over = ram > ram_budget or flash > flash_budget
+        print("%-10s %5d/%-5d %6d/%-6d%s" % (name, ram, ram_budget, flash, flash_budget, "  OVER BUDGET" if over else ""))
+        failed = failed or over
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
@@ -0,0 +1,8 @@
+
+#ifndef AIR_QUALITY_SENSOR_STATISTICS_HELPERS_H
+#define AIR_QUALITY_SENSOR_STATISTICS_HELPERS_H
+
+// Just expose the statistics engine included in the internal directory.
+#include "./internal/AirQualityStatistics.h"
+
+#endif
@@ -0,0 +1,9 @@
+
+#ifndef AIR_QUALITY_SENSOR_BINARY_LOG_HELPERS_H
+#define AIR_QUALITY_SENSOR_BINARY_LOG_HELPERS_H
+
+// Just expose the binary log encoder and decoder included in the internal directory.
+#include "./internal/BinaryLog.h"
+#include "./internal/PMSFrameLayouts.h"
+
+#endif
@@ -0,0 +1,8 @@
+
+#ifndef AIR_QUALITY_SENSOR_CALIBRATION_HELPERS_H
+#define AIR_QUALITY_SENSOR_CALIBRATION_HELPERS_H
+
+// Just expose the calibration included in the internal directory.
+#include "./internal/Calibration.h"
+
+#endif
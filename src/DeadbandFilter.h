@@ -0,0 +1,8 @@
+
+#ifndef AIR_QUALITY_SENSOR_DEADBAND_FILTER_HELPERS_H
+#define AIR_QUALITY_SENSOR_DEADBAND_FILTER_HELPERS_H
+
+// Just expose the deadband filter included in the internal directory.
+#include "./internal/DeadbandFilter.h"
+
+#endif
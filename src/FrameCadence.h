@@ -0,0 +1,8 @@
+
+#ifndef AIR_QUALITY_SENSOR_FRAME_CADENCE_HELPERS_H
+#define AIR_QUALITY_SENSOR_FRAME_CADENCE_HELPERS_H
+
+// Just expose the frame cadence estimator and sleep functions included in the internal directory.
+#include "./internal/FrameCadence.h"
+
+#endif
@@ -0,0 +1,8 @@
+
+#ifndef AIR_QUALITY_SENSOR_LINUX_SERIAL_HELPERS_H
+#define AIR_QUALITY_SENSOR_LINUX_SERIAL_HELPERS_H
+
+// Just expose the Linux serial port and epoll hub included in the internal directory.
+#include "./internal/LinuxSerial.h"
+
+#endif
@@ -0,0 +1,24 @@
+
+#ifndef AIR_QUALITY_SENSOR_PMS5003_HELPERS_H
+#define AIR_QUALITY_SENSOR_PMS5003_HELPERS_H
+#include "./internal/AirQualityModel_PMS5003.h"
+#include "./internal/AirQualityPMSProcessor.h"
+#include "./internal/PMSFrameLayouts.h"
+
+
+namespace debuguear {
+
+    // The PMS5003, PMS7003 and PMSA003 share the same frame and data model.
+    using PMS5003_PROCESSOR_T = AirQualitySensor<LayoutPMS5003>;
+    using PMS7003_PROCESSOR_T = AirQualitySensor<LayoutPMS7003>;
+    using PMSA003_PROCESSOR_T = AirQualitySensor<LayoutPMSA003>;
+
+    // Every optional feature and `FULL_MAX_OBSERVERS` observer slots, see "Footprint" in the readme.
+    using PMS5003_FULL_PROCESSOR_T = AirQualitySensor<LayoutPMS5003, FULL_MAX_OBSERVERS, SENSOR_FEATURES_ALL>;
+    using PMS7003_FULL_PROCESSOR_T = AirQualitySensor<LayoutPMS7003, FULL_MAX_OBSERVERS, SENSOR_FEATURES_ALL>;
+    using PMSA003_FULL_PROCESSOR_T = AirQualitySensor<LayoutPMSA003, FULL_MAX_OBSERVERS, SENSOR_FEATURES_ALL>;
+
+}
+
+
+#endif
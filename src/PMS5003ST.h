@@ -0,0 +1,17 @@
+
+#ifndef AIR_QUALITY_SENSOR_PMS5003ST_HELPERS_H
+#define AIR_QUALITY_SENSOR_PMS5003ST_HELPERS_H
+#include "./internal/AirQualityModel_PMS5003ST.h"
+#include "./internal/AirQualityPMSProcessor.h"
+#include "./internal/PMSFrameLayouts.h"
+
+
+namespace debuguear {
+
+    using PMS5003ST_PROCESSOR_T = AirQualitySensor<LayoutPMS5003ST>;
+    using PMS5003ST_FULL_PROCESSOR_T = AirQualitySensor<LayoutPMS5003ST, FULL_MAX_OBSERVERS, SENSOR_FEATURES_ALL>;
+
+}
+
+
+#endif
@@ -3,36 +3,39 @@
 #define AIR_QUALITY_SENSOR_PMS5003T_HELPERS_H
 #include "./internal/AirQualityModel_PMS5003T.h"
 #include "./internal/AirQualityPMSProcessor.h"
+#include "./internal/PMSFrameLayouts.h"
 
 
 namespace debuguear {
 
-    using PMS5003T_PROCESSOR_T = AirQualitySensor<AdapterPMS5003T, AirQualityModel_PMS5003T, uint16_t, 12>;
-    AdapterPMS5003T adapterPMS5003T;
+    // Processors are constructed in place, one per sensor and never copied:
+    // `debuguear::PMS5003T_PROCESSOR_T processor(&pmsSerial, 1);`
+
+    // `DEFAULT_MAX_OBSERVERS` observer slots and the dispatch policies only.
+    using PMS5003T_PROCESSOR_T = AirQualitySensor<LayoutPMS5003T>;
+    // Every optional feature and `FULL_MAX_OBSERVERS` observer slots, see "Footprint" in the readme.
+    using PMS5003T_FULL_PROCESSOR_T = AirQualitySensor<LayoutPMS5003T, FULL_MAX_OBSERVERS, SENSOR_FEATURES_ALL>;
 
     /**
-     * @brief Creates and returns a reference to the PMS5003T air quality sensor processor.
-     * 
-     * @param sensorStream A reference to a Stream object used for reading sensor data.
-     *                      Typically, this will be a hardware serial stream.
-     * 
-     * @return PMS5003T_PROCESSOR_T&  A reference to the static instance of the air quality sensor processor.
-     * 
-     * 
-     * @note
-     * - The airQualitySensor instance is static, ensuring it persists ofr the lifetime of the program.
-     * - This design avoids redundant object creation and ensure single, consistent processor instance.
-     * - This function is not thread-safe, it may required synchronization in multi-threaded systems.
+     * @brief Stand-in for the 0.0.x adapter, which `LayoutPMS5003T` replaced.
+     * @deprecated Removed in the next release together with `adapterPMS5003T`.
+     */
+    struct AdapterPMS5003T {};
+
+    AIR_QUALITY_DEPRECATED("the adapter is ignored, construct the processor with (sensorStream, maxHandlers)")
+    constexpr AdapterPMS5003T adapterPMS5003T{};
+
+    /**
+     * @brief The 0.0.x factory: one processor per program, reading from `sensorStream`.
      * 
-     * @example
-     * ```cpp
-     * PMS5003T_PROCESSOR_T& processor = debuguear::pms5003TProcessor(pmsStreamSerial);
-     * processor.loop();
-     * ```
+     * Only the first call constructs the processor, later calls return it unchanged.
+     * Bind the result to a reference, processors cannot be copied anymore.
      * 
+     * @deprecated Construct a `PMS5003T_PROCESSOR_T` in place; removed in the next release.
      */
-    PMS5003T_PROCESSOR_T& pms5003TProcessor(Stream *sensorStream, size_t max_observers) {
-        static PMS5003T_PROCESSOR_T airQualitySensor(sensorStream, adapterPMS5003T, max_observers);
+    AIR_QUALITY_DEPRECATED("construct a PMS5003T_PROCESSOR_T in place, see 'Migrating from 0.0.x' in the readme")
+    inline PMS5003T_PROCESSOR_T &pms5003TProcessor(Stream *sensorStream, size_t max_observers = DEFAULT_MAX_OBSERVERS) {
+        static PMS5003T_PROCESSOR_T airQualitySensor(sensorStream, max_observers);
         return airQualitySensor;
     }
 
@@ -0,0 +1,8 @@
+
+#ifndef AIR_QUALITY_SENSOR_READING_FORMAT_HELPERS_H
+#define AIR_QUALITY_SENSOR_READING_FORMAT_HELPERS_H
+
+// Just expose the formatters included in the internal directory.
+#include "./internal/ReadingFormat.h"
+
+#endif
@@ -0,0 +1,8 @@
+
+#ifndef AIR_QUALITY_SENSOR_READING_LATCH_HELPERS_H
+#define AIR_QUALITY_SENSOR_READING_LATCH_HELPERS_H
+
+// Just expose the latest reading latch included in the internal directory.
+#include "./internal/ReadingLatch.h"
+
+#endif
\ No newline at end of file
@@ -0,0 +1,8 @@
+
+#ifndef AIR_QUALITY_SENSOR_REQUEST_SCHEDULER_HELPERS_H
+#define AIR_QUALITY_SENSOR_REQUEST_SCHEDULER_HELPERS_H
+
+// Just expose the request scheduler included in the internal directory.
+#include "./internal/RequestScheduler.h"
+
+#endif
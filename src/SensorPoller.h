@@ -0,0 +1,8 @@
+
+#ifndef AIR_QUALITY_SENSOR_POLLER_HELPERS_H
+#define AIR_QUALITY_SENSOR_POLLER_HELPERS_H
+
+// Just expose the poller included in the internal directory.
+#include "./internal/SensorPoller.h"
+
+#endif
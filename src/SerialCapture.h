@@ -0,0 +1,8 @@
+
+#ifndef AIR_QUALITY_SENSOR_SERIAL_CAPTURE_HELPERS_H
+#define AIR_QUALITY_SENSOR_SERIAL_CAPTURE_HELPERS_H
+
+// Just expose the capture recorder and replay stream included in the internal directory.
+#include "./internal/SerialCapture.h"
+
+#endif
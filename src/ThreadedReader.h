@@ -0,0 +1,8 @@
+
+#ifndef AIR_QUALITY_SENSOR_THREADED_READER_HELPERS_H
+#define AIR_QUALITY_SENSOR_THREADED_READER_HELPERS_H
+
+// Just expose the threaded reader and reading queue included in the internal directory.
+#include "./internal/ThreadedReader.h"
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef AIR_QUALITY_SENSOR_INDEX_H
+#define AIR_QUALITY_SENSOR_INDEX_H
+#include "Arduino.h"
+
+namespace debuguear {
+
+    /**
+     * @brief One row of an EPA breakpoint table: concentrations `[cLow, cHigh]` map linearly
+     *        onto index values `[iLow, iHigh]`.
+     */
+    struct AqiBreakpoint {
+        uint16_t cLow, cHigh, iLow, iHigh;
+    };
+
+    /**
+     * @brief Copies a breakpoint row out of a `PROGMEM` table.
+     */
+    inline AqiBreakpoint loadBreakpoint(const AqiBreakpoint *row) {
+        AqiBreakpoint copy;
+#if defined(ARDUINO)
+        // Flash reads on AVR and ESP8266, a plain copy where PROGMEM is ordinary memory.
+        memcpy_P(&copy, row, sizeof(copy));
+#else
+        copy = *row;
+#endif
+        return copy;
+    }
+
+    /**
+     * @brief Interpolates an index value from a breakpoint table.
+     *
+     * @param c Truncated concentration, in the unit of the table.
+     * @param table The breakpoint rows, in `PROGMEM`.
+     * @return The index, capped at the top of the last row.
+     */
+    inline uint16_t aqiFromBreakpoints(uint16_t c, const AqiBreakpoint *table, uint8_t rows) {
+        for (uint8_t i = 0; i < rows; ++i) {
+            const AqiBreakpoint row = loadBreakpoint(&table[i]);
+            if (c <= row.cHigh) {
+                if (c < row.cLow) {
+                    c = row.cLow;
+                }
+                uint32_t span = (uint32_t)(row.cHigh - row.cLow);
+                return (uint16_t)(row.iLow + ((uint32_t)(row.iHigh - row.iLow) * (c - row.cLow) + span / 2) / span);
+            }
+        }
+        return loadBreakpoint(&table[rows - 1]).iHigh;
+    }
+
+    /**
+     * @brief US EPA AQI of a PM2.5 concentration in µg/m³ (2024 breakpoints).
+     *
+     * The concentration is truncated to 0.1 µg/m³ as the EPA specifies. Negative values
+     * (an unavailable NowCast) yield -1.
+     */
+    inline int16_t aqiFromPm25(float concentration) {
+        static const AqiBreakpoint table[] PROGMEM = {
+            {0, 90, 0, 50},
+            {91, 354, 51, 100},
+            {355, 554, 101, 150},
+            {555, 1254, 151, 200},
+            {1255, 2254, 201, 300},
+            {2255, 3254, 301, 500}
+        };
+        if (concentration < 0) {
+            return -1;
+        }
+        float tenths = concentration * 10.0f;
+        uint16_t c = tenths >= 65535.0f ? 65535 : (uint16_t)tenths;
+        return (int16_t)aqiFromBreakpoints(c, table, sizeof(table) / sizeof(table[0]));
+    }
+
+    /**
+     * @brief US EPA AQI of a PM10 concentration in µg/m³, truncated to an integer.
+     *        Negative values yield -1.
+     */
+    inline int16_t aqiFromPm100(float concentration) {
+        static const AqiBreakpoint table[] PROGMEM = {
+            {0, 54, 0, 50},
+            {55, 154, 51, 100},
+            {155, 254, 101, 150},
+            {255, 354, 151, 200},
+            {355, 424, 201, 300},
+            {425, 604, 301, 500}
+        };
+        if (concentration < 0) {
+            return -1;
+        }
+        uint16_t c = concentration >= 65535.0f ? 65535 : (uint16_t)concentration;
+        return (int16_t)aqiFromBreakpoints(c, table, sizeof(table) / sizeof(table[0]));
+    }
+
+}
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef AIR_QUALITY_SENSOR_MODEL_PMS5003_H
+#define AIR_QUALITY_SENSOR_MODEL_PMS5003_H
+#include "Arduino.h"
+
+
+namespace debuguear {
+
+
+    /**
+     * @brief Readings of the PMS5003, PMS7003 and PMSA003 sensors, which share the same 32-byte frame.
+     */
+    struct AirQualityModel_PMS5003 {
+
+        uint16_t pm10_standard, pm25_standard, pm100_standard; // refers PM1.0, PM2.5 , PM10 concentration unit μ g/m³ （CF=1，standard particle）
+        uint16_t pm10_env, pm25_env, pm100_env; // refers to PM1.0, PM2.5  concentration unit μ g/m3（under atmospheric environment）
+        uint16_t particles_03um, particles_05um, particles_10um, particles_25um, particles_50um, particles_100um; // indicates the number of particles with diameter beyond (0.3, 0.5, 1.0, 2.5, 5.0, 10) um in 0.1 L of air.
+        uint16_t reserved; // Byte reserved by protocol.
+
+        static constexpr uint8_t FORMAT_FIELDS = 12; // fields reported by `visit`
+
+        /**
+         * @brief Resets all fields of the air quality model to zero.
+         * @return void
+        */
+        void clean() {
+                pm10_standard = 0;
+                pm25_standard = 0;
+                pm100_standard = 0;
+                pm10_env = 0;
+                pm25_env = 0;
+                pm100_env = 0;
+                particles_03um = 0;
+                particles_05um = 0;
+                particles_10um = 0;
+                particles_25um = 0;
+                particles_50um = 0;
+                particles_100um = 0;
+                reserved = 0;
+        }
+
+
+        /**
+         * @brief Calls `visitor.value(name, v)` for every integer field and
+         *        `visitor.fixed(name, v, decimals)` for fixed-point ones, in output order.
+         *
+         * Used by the allocation-free formatters in `ReadingFormat.h`.
+         */
+        template <typename Visitor>
+        void visit(Visitor &visitor) const {
+            visitor.value("pm10_standard", pm10_standard);
+            visitor.value("pm25_standard", pm25_standard);
+            visitor.value("pm100_standard", pm100_standard);
+            visitor.value("pm10_env", pm10_env);
+            visitor.value("pm25_env", pm25_env);
+            visitor.value("pm100_env", pm100_env);
+            visitor.value("particles_03um", particles_03um);
+            visitor.value("particles_05um", particles_05um);
+            visitor.value("particles_10um", particles_10um);
+            visitor.value("particles_25um", particles_25um);
+            visitor.value("particles_50um", particles_50um);
+            visitor.value("particles_100um", particles_100um);
+        }
+
+
+        /**
+         * @brief Converts the air quality model data into a formatted string, one field per line.
+         * 
+         * @return String A formatted string containing all the data in the model.
+         */
+        String toString() const {
+            String result = "PM10 (std): " + String(pm10_standard) + "\n";
+            result += "PM2.5 (std): " + String(pm25_standard) + "\n";
+            result += "PM100 (std): " + String(pm100_standard) + "\n";
+            result += "PM10 (env): " + String(pm10_env) + "\n";
+            result += "PM2.5 (env): " + String(pm25_env) + "\n";
+            result += "PM100 (env): " + String(pm100_env) + "\n";
+            result += ">0.3um: " + String(particles_03um) + "\n";
+            result += ">0.5um: " + String(particles_05um) + "\n";
+            result += ">1.0um: " + String(particles_10um) + "\n";
+            result += ">2.5um: " + String(particles_25um) + "\n";
+            result += ">5.0um: " + String(particles_50um) + "\n";
+            result += ">10um: " + String(particles_100um) + "\n";
+            return result;
+        }
+    };
+
+}
+
+#endif
@@ -1,7 +1,6 @@
 #ifndef AIR_QUALITY_SENSOR_MODEL_PMS5003T_H
 #define AIR_QUALITY_SENSOR_MODEL_PMS5003T_H
-#define PMS5003T_DATA_BLOCKS 12
-#include "DataAdapterBase.h"
+#include "Arduino.h"
 
 
 namespace debuguear {
@@ -16,6 +15,8 @@ namespace debuguear {
         uint16_t humedity; //  Range: (0, 99) %, resolution=0.1 , error=±2 
         uint16_t reserved; // Byte reserved by protocol.
 
+        static constexpr uint8_t FORMAT_FIELDS = 12; // fields reported by `visit`
+
         /**
          * @brief Resets all fields of the air quality model to zero.
          * 
@@ -41,6 +42,29 @@ namespace debuguear {
         }
 
 
+        /**
+         * @brief Calls `visitor.value(name, v)` for every integer field and
+         *        `visitor.fixed(name, v, decimals)` for fixed-point ones, in output order.
+         *
+         * Used by the allocation-free formatters in `ReadingFormat.h`.
+         */
+        template <typename Visitor>
+        void visit(Visitor &visitor) const {
+            visitor.value("pm10_standard", pm10_standard);
+            visitor.value("pm25_standard", pm25_standard);
+            visitor.value("pm100_standard", pm100_standard);
+            visitor.value("pm10_env", pm10_env);
+            visitor.value("pm25_env", pm25_env);
+            visitor.value("pm100_env", pm100_env);
+            visitor.value("particles_03um", particles_03um);
+            visitor.value("particles_05um", particles_05um);
+            visitor.value("particles_10um", particles_10um);
+            visitor.value("particles_25um", particles_25um);
+            visitor.fixed("temperature", temperature, 1);
+            visitor.fixed("humidity", humedity, 1);
+        }
+
+
         /**
          * @brief Converts the air quality model data into a formatted string.
          * 
@@ -64,6 +88,9 @@ namespace debuguear {
          *       - >2.5um: <value>
          *       - Temp <value>
          *       - H% <value>
+         *
+         * @note Every call builds the text out of a couple dozen temporary `String`s. In an
+         *       observer, prefer the allocation-free `formatCsv`/`formatJson` (`ReadingFormat.h`).
          */
         String toString() const {
             String result = "PM10 (std): " + String(pm10_standard) + "\n";
@@ -82,24 +109,6 @@ namespace debuguear {
         }
     };
 
-    class AdapterPMS5003T: public SensorDataAdapterBase<uint16_t, PMS5003T_DATA_BLOCKS, AirQualityModel_PMS5003T> {
-        public:
-            void adapt(const uint16_t (&data)[PMS5003T_DATA_BLOCKS], AirQualityModel_PMS5003T *dst) override {
-                dst->pm10_standard = data[0];
-                dst->pm25_standard = data[1];
-                dst->pm100_standard = data[2];
-                dst->pm10_env = data[3];
-                dst->pm25_env = data[4];
-                dst->pm100_env = data[5];
-                dst->particles_03um = data[6];
-                dst->particles_05um = data[7];
-                dst->particles_10um = data[8];
-                dst->particles_25um = data[9];
-                dst->temperature = data[10];
-                dst->humedity = data[11];
-            }
-    };
-
 }
 
 #endif
\ No newline at end of file
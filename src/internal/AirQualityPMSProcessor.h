@@ -1,11 +1,11 @@
 #ifdef DEBUG
-    #define DEBUG_PRINT(x) Serial.print("[DEBUG] "); Serial.print(x)
-    #define DEBUG_PRINTLN(x) Serial.print("[DEBUG] "); Serial.println(x)
-    #define DEBUG_PRINT_HEX(x) Serial.print("0x"); if ((x) < 0x10) Serial.print("0"); Serial.print((x), HEX)
+    #define DEBUG_PRINT(x) Serial.print(F("[DEBUG] ")); Serial.print(x)
+    #define DEBUG_PRINTLN(x) Serial.print(F("[DEBUG] ")); Serial.println(x)
+    #define DEBUG_PRINT_HEX(x) Serial.print(F("0x")); if ((x) < 0x10) Serial.print('0'); Serial.print((x), HEX)
 
     #define PRINT_FRAME_HEX(frame, length)                                   \
         do {                                                                \
-            Serial.print("[DEBUG] Frame data in hex: ");                    \
+            Serial.print(F("[DEBUG] Frame data in hex: "));                 \
             for (size_t i = 0; i < (length); i++) {                         \
                 if ((frame)[i] < 0x10) {                                    \
                     Serial.print('0');                                      \
@@ -24,69 +24,462 @@
 
 #ifndef AIR_QUALITY_SENSOR_H
 #define AIR_QUALITY_SENSOR_H
-#include "AirQualityModel_PMS5003T.h"
+#include "ByteRingBuffer.h"
+#include "DeadbandFilter.h"
+#include "FrameLayout.h"
+#include "FrameScan.h"
+#include "PMSCommands.h"
+#include "SensorFeatures.h"
 
 #define BIG_ENDIAN_16(hi, lo) (((hi) << 8) | (lo))
 
+// Marks the 0.0.x entry points kept for one release; `[[deprecated]]` needs C++14.
+#if __cplusplus >= 201402L
+    #define AIR_QUALITY_DEPRECATED(message) [[deprecated(message)]]
+#else
+    #define AIR_QUALITY_DEPRECATED(message) __attribute__((deprecated(message)))
+#endif
+
 namespace debuguear {
 
-    template <typename Adapter, typename AdapteeType, typename T, size_t DATA_N>
-    class AirQualitySensor {
+    /**
+     * @brief Frame processor for a PMS sensor.
+     * 
+     * @tparam Layout A `FrameLayout` descriptor of the sensor frame. It provides the data
+     *                model, the frame length and the decoding of each field.
+     * @tparam MAX_OBSERVERS Observer slots reserved in the processor; `maxHandlers` is clamped to it.
+     * @tparam FEATURES The `SensorFeature` flags compiled in. On small MCUs, leaving out the
+     *                  unused ones saves RAM and flash; see "Footprint" in the readme.
+     */
+    template <typename Layout, uint8_t MAX_OBSERVERS = DEFAULT_MAX_OBSERVERS, uint8_t FEATURES = SENSOR_FEATURES_DEFAULT>
+    class AirQualitySensor
+        : private features::ParserStats<(FEATURES & SENSOR_FEATURE_STATS) != 0>,
+          private features::LatestFrame<(FEATURES & SENSOR_FEATURE_BACKLOG) != 0, Layout::FRAME_LENGTH>,
+          private features::Observers<Layout, MAX_OBSERVERS, (FEATURES & SENSOR_FEATURE_DISPATCH) != 0>,
+          private features::CommandLink<(FEATURES & SENSOR_FEATURE_COMMANDS) != 0>,
+          private features::DeadbandHook<(FEATURES & SENSOR_FEATURE_DEADBAND) != 0, Layout>,
+          private features::CadenceTracker<(FEATURES & SENSOR_FEATURE_CADENCE) != 0>,
+          private features::LatestReading<(FEATURES & SENSOR_FEATURE_SNAPSHOT) != 0, Layout> {
+        static_assert(MAX_OBSERVERS > 0, "AirQualitySensor needs at least one observer slot");
+
         public:
+            typedef typename Layout::Model AdapteeType;
+
+                AirQualitySensor(Stream *sensorStream, size_t maxHandlers)
+                    : sensorStream(sensorStream), ring(nullptr), parserState(WAIT_HEADER_1), framePos(0), frameEnd(FRAME_LENGHT),
+                      replayPos(0), replayLength(0), runningChecksum(0), lastByteAt(0), framesCount(0) {
+                    this->setCommandSink(sensorStream);
+                    this->initObservers(maxHandlers);
+                    this->resetStats();
+            };
 
-                AirQualitySensor(Stream *sensorStream, Adapter& adapterRef, size_t maxHandlers)
-                    : sensorStream(sensorStream), adapter(adapterRef), maxHandlers(maxHandlers) {
-    
-                    if (maxHandlers > MAX_OBSERVERS_PHYSIC) {
-                        maxHandlers = MAX_OBSERVERS_PHYSIC;
-                    }
-                    this->maxHandlers = maxHandlers;
-                    for (uint8_t i = 0; i < maxHandlers; ++i) {
-                        observers[i] = nullptr;
-                    }
+            /**
+             * @brief The 0.0.x constructor. Frames are decoded by `Layout` now and the adapter is ignored.
+             * @deprecated Use `AirQualitySensor(sensorStream, maxHandlers)`; removed in the next release.
+             */
+            template <typename Adapter>
+            AIR_QUALITY_DEPRECATED("the adapter is ignored, use AirQualitySensor(sensorStream, maxHandlers)")
+            AirQualitySensor(Stream *sensorStream, Adapter &, size_t maxHandlers)
+                : AirQualitySensor(sensorStream, maxHandlers) {}
+
+            /**
+             * @brief Creates a processor fed from a ring buffer instead of a `Stream`.
+             * 
+             * The ring is filled by a UART RX interrupt or a DMA callback, and `loop()` parses
+             * frames directly out of the ring storage.
+             * 
+             * @param ringRef The ring buffer receiving the raw sensor bytes. It must outlive the processor.
+             * @param maxHandlers Maximum number of observers.
+             * @param commandSink The UART transmit side, used by the sensor commands. Without
+             *                    it the commands fail and the sensor must stay in active mode.
+             */
+                AirQualitySensor(ByteRingBuffer &ringRef, size_t maxHandlers, Print *commandSink = nullptr)
+                    : sensorStream(nullptr), ring(&ringRef), parserState(WAIT_HEADER_1), framePos(0), frameEnd(FRAME_LENGHT),
+                      replayPos(0), replayLength(0), runningChecksum(0), lastByteAt(0), framesCount(0) {
+                    this->setCommandSink(commandSink);
+                    this->initObservers(maxHandlers);
+                    this->resetStats();
             };
 
             /**
              * @brief Main loop function for reading and processing sensor data.
              * 
-             * This method continuously attempts to read and process a complete frame from the sensor stream.
-             * If a valid frame is read, the processed sensor data is passed to all registered observers.
-             * The method retries reading up to three times or until a timeout occurs.
+             * This method consumes the bytes currently buffered in the sensor stream and feeds
+             * them into an incremental frame parser. It never waits for missing bytes: a frame
+             * that is only partially received is kept in the parser and completed on a later call.
+             * Every complete and valid frame is passed to all registered observers.
              * 
              * @note
              * - Ensure the `sensorStream` is initialized and provides data from the sensor.
              * - Observers registered using `addObserver` will be notified upon successful data processing.
+             * - A partial frame is discarded when a poll finds no byte more than `FRAME_TIMEOUT_MS`
+             *   after the last one. Bytes found after a longer stall of the loop may well be its
+             *   tail, so they are parsed first: a broken frame fails its checksum and the parser
+             *   resynchronizes on the next header.
+             * - When the processor was built on a `ByteRingBuffer`, frames are parsed from the ring instead.
              */
             void loop() {
-                AdapteeType data = {};
-                int retry = 3;
-                uint8_t buffer[FRAME_LENGHT];
-                long unsigned timeoutTime = millis() + 1000;
-                // Block the this loop until read the whole stream.
-                // or timeout.
-                DEBUG_PRINTLN("::loop");
-                while ((retry != 0) && (timeoutTime >= millis())) {
-                    retry--;
-                    if (sensorStream->available() > 0) {
-                        DEBUG_PRINTLN("::readPMSdata");
-                        if (this->readPMSAvailableData(&data, buffer))  {
-                            DEBUG_PRINTLN("::readPMSdata succeed");
-                            this->notifyNewValue(&data);
-                            break;
-                        } else {
-                            DEBUG_PRINTLN("::readPMSdata failed");
-                        }
+                this->poll((size_t)-1);
+            }
+
+            /**
+             * @brief Same as `loop()`, but consumes at most `maxBytes` bytes.
+             * 
+             * Used to share one main loop between several sensors (see `SensorPoller`): a sensor
+             * with a large backlog or a desynchronized stream cannot hold the loop for longer
+             * than its byte budget. Unconsumed bytes are left for the next call.
+             * 
+             * @param maxBytes Maximum number of bytes to consume in this call.
+             * 
+             * @return The number of bytes consumed.
+             */
+            size_t poll(size_t maxBytes) {
+                if (this->ring != nullptr) {
+                    return this->pollRing(maxBytes);
+                }
+
+                int pending = this->sensorStream->available();
+                if (pending <= 0) {
+                    // Unsigned subtraction keeps the comparison valid across millis() overflow.
+                    if (this->parserState != WAIT_HEADER_1 && (unsigned long)(millis() - this->lastByteAt) > FRAME_TIMEOUT_MS) {
+                        DEBUG_PRINTLN(F("Partial frame timed out"));
+                        this->countDiscarded(this->framePos);
+                        this->resetParser();
                     }
-                    DEBUG_PRINTLN("--retry");
-                } 
+                    this->trackIdlePoll();
+                    return 0;
+                }
+
+#if defined(SERIAL_RX_BUFFER_SIZE)
+                if ((size_t)pending >= SERIAL_RX_BUFFER_SIZE - 1) {
+                    // The core RX buffer is full: incoming bytes are being dropped.
+                    this->countOverrun();
+                }
+#endif
+
+                unsigned long now = millis();
+                this->lastByteAt = now;
+
+                size_t budget = (size_t)pending < maxBytes ? (size_t)pending : maxBytes;
+                size_t consumed = 0;
+                uint32_t framesBefore = this->framesCount;
+                uint8_t window[FRAME_LENGHT];
+                while (consumed < budget) {
+                    size_t chunk = budget - consumed < sizeof(window) ? budget - consumed : sizeof(window);
+                    // Never blocks: at most `available()` bytes are requested.
+                    size_t received = this->sensorStream->readBytes(window, chunk);
+                    if (received == 0) {
+                        break;
+                    }
+                    consumed += received;
+                    this->parseWindow(window, received, now);
+                }
+                this->notifyLatest(now);
+                this->trackPoll(now, this->framesCount != framesBefore);
+                return consumed;
+            }
+
+            typedef void (*ObserverFn)(AdapteeType *data);
+            typedef void (*ContextObserverFn)(void *context, const AdapteeType *data);
+
+            /**
+             * @brief Registers a plain observer, called for every frame from inside `loop()`.
+             * 
+             * @return `false` if the observer is null or the observer capacity is exhausted.
+             */
+            bool addObserver(ObserverFn fn) {
+                if (fn == nullptr) {
+                    return false;
+                }
+                return this->insertObserver(fn, nullptr, nullptr, DISPATCH_IMMEDIATE, 1);
+            }
+
+            /**
+             * @brief Registers an observer receiving `context` along with the reading.
+             * 
+             * @param fn Callback, called as `fn(context, data)`.
+             * @param context Opaque pointer handed back to `fn`, typically the consumer object.
+             * @param policy When `fn` is called, see `DispatchPolicy`. Deferred observers move
+             *               slow consumers (uplink, logging) out of the parsing path: they are
+             *               only flagged by `loop()` and called from `dispatch()`.
+             * @param n For `DISPATCH_EVERY_NTH`, call `fn` with every `n`-th frame.
+             * 
+             * @return `false` if the observer is null, the observer capacity is exhausted, or
+             *         `policy` is not `DISPATCH_IMMEDIATE` and `SENSOR_FEATURE_DISPATCH` is left out.
+             */
+            bool addObserver(ContextObserverFn fn, void *context, DispatchPolicy policy = DISPATCH_IMMEDIATE, uint8_t n = 1) {
+                if (fn == nullptr) {
+                    return false;
+                }
+                return this->insertObserver(nullptr, fn, context, policy, n != 0 ? n : 1);
+            }
+
+            /**
+             * @brief Unregisters a plain observer.
+             * @return `false` if it was not registered.
+             */
+            bool removeObserver(ObserverFn fn) {
+                for (uint8_t idx = 0; idx < this->observersCount; ++idx) {
+                    if (this->observers[idx].plain == fn && this->observers[idx].withContext == nullptr) {
+                        this->eraseObserver(idx);
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            /**
+             * @brief Unregisters the observer registered with `fn` and `context`.
+             * @return `false` if it was not registered.
+             */
+            bool removeObserver(ContextObserverFn fn, void *context) {
+                for (uint8_t idx = 0; idx < this->observersCount; ++idx) {
+                    if (this->observers[idx].withContext == fn && this->observers[idx].context == context) {
+                        this->eraseObserver(idx);
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            /**
+             * @brief Calls the deferred observers flagged since the last call.
+             * 
+             * Deferred observers receive the latest reading only: if several frames arrived
+             * since the previous `dispatch()`, the older ones are not replayed to them.
+             * 
+             * @return The number of observers called.
+             */
+            size_t dispatch() {
+                static_assert((FEATURES & SENSOR_FEATURE_DISPATCH) != 0, "dispatch() needs SENSOR_FEATURE_DISPATCH");
+                return this->dispatchPending();
+            }
+
+            size_t observerCount() const {
+                return this->observersCount;
+            }
+
+            /**
+             * @brief Sends a raw command frame to the sensor, see `PmsCommand`.
+             * 
+             * @return `false` if the processor has no transmit side or the frame was not fully written.
+             */
+            bool sendCommand(uint8_t command, uint16_t data) {
+                static_assert((FEATURES & SENSOR_FEATURE_COMMANDS) != 0, "sensor commands need SENSOR_FEATURE_COMMANDS");
+                if (this->commandSink == nullptr) {
+                    return false;
+                }
+                uint8_t buf[PMS_COMMAND_FRAME_LENGTH];
+                buildCommandFrame(command, data, buf);
+                return this->commandSink->write(buf, sizeof(buf)) == sizeof(buf);
+            }
+
+            /**
+             * @brief Stops the periodic frames; the sensor then only answers `requestReading()`.
+             */
+            bool setPassiveMode() {
+                return this->sendCommand(PMS_CMD_CHANGE_MODE, 0);
+            }
+
+            /**
+             * @brief Makes the sensor stream frames on its own again (the power-on default).
+             */
+            bool setActiveMode() {
+                return this->sendCommand(PMS_CMD_CHANGE_MODE, 1);
+            }
+
+            /**
+             * @brief In passive mode, asks the sensor for one data frame.
+             * 
+             * The frame arrives later and is processed by `loop()`/`poll()` as any other; see
+             * `framesReceived()` and `RequestScheduler` to match it with the request.
+             */
+            bool requestReading() {
+                return this->sendCommand(PMS_CMD_READ, 0);
+            }
+
+            /**
+             * @brief Stops the fan and the laser.
+             */
+            bool sleep() {
+                return this->sendCommand(PMS_CMD_SLEEP, 0);
+            }
+
+            /**
+             * @brief Restarts the fan. Readings are only reliable about 30 s after waking up.
+             */
+            bool wakeUp() {
+                return this->sendCommand(PMS_CMD_SLEEP, 1);
+            }
+
+            /**
+             * @brief Chooses what happens to the frames that queued up while the loop was stalled.
+             * 
+             * Every call to `loop()`/`poll()` always validates all the complete frames it finds.
+             * With `BACKLOG_ALL_FRAMES` (the default) each one is notified, in order. With
+             * `BACKLOG_LATEST_WINS` only the newest is decoded and notified when the call
+             * returns, so the processor catches up in one iteration at any backlog depth; the
+             * older ones are counted in `ProcessorStats::framesSuperseded`.
+             */
+            void setBacklogPolicy(BacklogPolicy policy) {
+                static_assert((FEATURES & SENSOR_FEATURE_BACKLOG) != 0, "setBacklogPolicy() needs SENSOR_FEATURE_BACKLOG");
+                this->setPolicy(policy);
+            }
+
+            /**
+             * @brief Snapshot of the parser health counters since construction or `resetStats()`.
+             * 
+             * The counters cost a few increments per frame; the latency adds two `micros()`
+             * calls per frame. Both go away without `SENSOR_FEATURE_STATS`. `overruns` comes
+             * from the ring buffer for ring processors; on a `Stream` it counts the polls that
+             * found the core RX buffer full (AVR cores, which define `SERIAL_RX_BUFFER_SIZE`),
+             * and stays 0 elsewhere.
+             */
+            ProcessorStats stats() const {
+                static_assert((FEATURES & SENSOR_FEATURE_STATS) != 0, "stats() needs SENSOR_FEATURE_STATS");
+                return this->snapshot(this->ring);
+            }
+
+            void resetStats() {
+                this->resetCounters(this->ring != nullptr ? this->ring->overrunCount() : 0);
+            }
+
+            /**
+             * @brief Number of valid data frames received, including those dropped by the deadband filter.
+             * 
+             * Unlike `stats()`, it is never reset.
+             */
+            uint32_t framesReceived() const {
+                return this->framesCount;
+            }
+
+            /**
+             * @brief Number of command acknowledgements received.
+             */
+            uint32_t acksReceived() const {
+                static_assert((FEATURES & SENSOR_FEATURE_COMMANDS) != 0, "acknowledgements need SENSOR_FEATURE_COMMANDS");
+                return this->acksCount;
+            }
+
+            /**
+             * @brief Command and data byte of the last acknowledgement, e.g. `PMS_CMD_CHANGE_MODE` and 0.
+             */
+            uint8_t lastAcknowledgedCommand() const {
+                static_assert((FEATURES & SENSOR_FEATURE_COMMANDS) != 0, "acknowledgements need SENSOR_FEATURE_COMMANDS");
+                return this->lastAckCommand;
+            }
+
+            uint8_t lastAcknowledgedData() const {
+                static_assert((FEATURES & SENSOR_FEATURE_COMMANDS) != 0, "acknowledgements need SENSOR_FEATURE_COMMANDS");
+                return this->lastAckData;
+            }
+
+            /**
+             * @brief Filters the frames before they reach the observers.
+             * 
+             * Frames rejected by `filter` are neither decoded nor notified to any observer,
+             * deferred ones included. `decodeFrames` and `processFrame` are not filtered.
+             * 
+             * @param filter The filter, which must outlive the processor, or `nullptr` to
+             *               notify every frame.
+             */
+            void setDeadband(DeadbandFilter<Layout> *filter) {
+                static_assert((FEATURES & SENSOR_FEATURE_DEADBAND) != 0, "setDeadband() needs SENSOR_FEATURE_DEADBAND");
+                this->setFilter(filter);
+            }
+
+
+            /**
+             * @brief `millis()` time the next data frame is expected at.
+             * 
+             * The sensor cadence is learned from the arrival times seen by `loop()`/`poll()`,
+             * see `FrameCadence`. Until a few frames were seen, or while the sensor changes its
+             * pace, this is the current time: keep polling.
+             */
+            unsigned long nextExpectedFrameAt() const {
+                static_assert((FEATURES & SENSOR_FEATURE_CADENCE) != 0, "frame prediction needs SENSOR_FEATURE_CADENCE");
+                return this->cadence.nextExpectedAt(millis());
+            }
+
+            /**
+             * @brief Milliseconds until `nextExpectedFrameAt()`, 0 when a frame is due.
+             */
+            unsigned long msUntilNextFrame() const {
+                static_assert((FEATURES & SENSOR_FEATURE_CADENCE) != 0, "frame prediction needs SENSOR_FEATURE_CADENCE");
+                return this->cadence.msUntilNext(millis());
             }
 
-            void addObserver(void (*fn)(AdapteeType *data) ) {
-                if (fn != nullptr && observersCount < maxHandlers) {
-                    observers[observersCount++] = fn;
+            /**
+             * @brief Sleeps until `guardMs` before the next expected frame starts, for loops
+             *        that only serve the sensor.
+             * 
+             * Frames are timed when they complete, so the sleep also ends `FRAME_AIRTIME_MS`
+             * earlier, the time the frame takes on the wire, and the guard is widened by three
+             * times the observed jitter. When a frame is due, or the cadence is not learned
+             * yet, it naps `FRAME_NAP_MS` with `delay()` instead, so the loop still polls often
+             * enough to time the arrivals: `sleepFn` may stop the UART (`cadence::lightSleep`)
+             * and is only called for sleeps that end before the next frame.
+             * 
+             * @param sleepFn How to sleep: `cadence::delaySleep`, `cadence::idleSleep` (AVR),
+             *                `cadence::lightSleep` (ESP32) or your own.
+             * 
+             * @return The milliseconds slept.
+             * 
+             * @example
+             * ```cpp
+             * void loop() {
+             *     processor.loop();
+             *     processor.sleepUntilNextFrame(debuguear::cadence::idleSleep);
+             * }
+             * ```
+             */
+            unsigned long sleepUntilNextFrame(FrameSleepFn sleepFn = cadence::delaySleep, unsigned long guardMs = FRAME_GUARD_MS) {
+                static_assert((FEATURES & SENSOR_FEATURE_CADENCE) != 0, "frame prediction needs SENSOR_FEATURE_CADENCE");
+                unsigned long remaining = this->cadence.msUntilNext(millis());
+                unsigned long guard = FRAME_AIRTIME_MS + guardMs + 3 * this->cadence.jitterMs();
+                if (remaining <= guard + FRAME_NAP_MS) {
+                    delay(FRAME_NAP_MS);
+                    return FRAME_NAP_MS;
                 }
+                sleepFn(remaining - guard);
+                return remaining - guard;
+            }
+
+            /**
+             * @brief The learned sensor cadence: interval, jitter, inferred missed frames.
+             */
+            const FrameCadence &frameCadence() const {
+                static_assert((FEATURES & SENSOR_FEATURE_CADENCE) != 0, "frame prediction needs SENSOR_FEATURE_CADENCE");
+                return this->cadence;
+            }
+
+            /**
+             * @brief Copies the latest valid reading, with its sequence number and `millis()` time.
+             *
+             * Safe to call from any task or ISR while the parser runs, and constant time: see
+             * `ReadingLatch`. Readings filtered out by the deadband are published here too.
+             *
+             * @return `false` if no reading was parsed yet.
+             */
+            bool latestReading(ReadingSnapshot<AdapteeType> &snapshot) const {
+                static_assert((FEATURES & SENSOR_FEATURE_SNAPSHOT) != 0, "latestReading() needs SENSOR_FEATURE_SNAPSHOT");
+                return this->latest.read(snapshot);
             }
 
+            /**
+             * @brief The latch behind `latestReading()`, for readers that should not depend on
+             *        the processor type, such as an ISR or a display task.
+             */
+            const ReadingLatch<AdapteeType> &readingLatch() const {
+                static_assert((FEATURES & SENSOR_FEATURE_SNAPSHOT) != 0, "latestReading() needs SENSOR_FEATURE_SNAPSHOT");
+                return this->latest;
+            }
+
+            static constexpr unsigned long SENSOR_BAUD = 9600;
+            // A frame on the wire, 10 bits per byte (8N1), rounded up.
+            static constexpr unsigned long FRAME_AIRTIME_MS = (Layout::FRAME_LENGTH * 10UL * 1000 + SENSOR_BAUD - 1) / SENSOR_BAUD;
+            static constexpr unsigned long FRAME_GUARD_MS = 20;
+            static constexpr unsigned long FRAME_NAP_MS = 1;
 
             /**
              * @brief Processes and validates a raw data frame from the sensor.
@@ -94,7 +487,7 @@ namespace debuguear {
              * This method validates the structure, header, length, and checksum of a raw data frame.
              * If valid, the sensor values are extracted and stored in the provided `dataDst` structure.
              * 
-             * @param frame A pointer to a buffer containing the raw sensor data frame (32 bytes).
+             * @param frame A pointer to a buffer containing the raw sensor data frame (`Layout::FRAME_LENGTH` bytes).
              * @param dataDst A reference to an `AdapteeType` structure to store the processed sensor values.
              *                The structure is cleared before storing new data.
              * 
@@ -103,185 +496,482 @@ namespace debuguear {
              * 
              * @note
              * - This method does not read directly from the stream; it operates on the provided `frame`.
-             * - Ensure the `frame` buffer contains exactly 32 bytes of data before calling this method.
+             * - Ensure the `frame` buffer contains exactly `Layout::FRAME_LENGTH` bytes of data before calling this method.
              */
             bool processFrame(uint8_t *frame, AdapteeType *dataDst) {
                 PRINT_FRAME_HEX(frame, FRAME_LENGHT);
-                uint16_t checksum = 0;
-                for (size_t i = 0; i < FRAME_LENGHT -2; i++) { // avoid sum the last 2 bytes (checksun)
-                    checksum += frame[i];
-                }
+                uint16_t checksum = sumFrameBytes(frame, FRAME_LENGHT - 2); // avoid sum the last 2 bytes (checksun)
                 // ensure data is clean;
                 dataDst->clean();
 
                 if (frame[0] != AirQualitySensor::FRAME_STARTING_BYTE_1 || frame[1] != AirQualitySensor::FRAME_STARTING_BYTE_2) {
-                    DEBUG_PRINTLN("Frame header is incorrect!");
+                    DEBUG_PRINTLN(F("Frame header is incorrect!"));
                     return false;
                 }
 
                 uint16_t framelen = BIG_ENDIAN_16(frame[2], frame[3]); // Bytes 2 y 3 para la longitud del frame (según protocolo).
 
-                if (framelen != 28) {
+                if (framelen != Layout::DATA_LENGTH) {
                     // Longitud de frame inválida
-                    DEBUG_PRINT("invalid framelen ");
+                    DEBUG_PRINT(F("invalid framelen "));
                     DEBUG_PRINTLN(framelen);
                     return false;
                 }
 
-                T theData[DATA_N];
-                for (size_t idx = 0; idx < DATA_N; ++idx) {
-                    theData[idx] = BIG_ENDIAN_16(frame[4 + idx * 2], frame[5 + idx * 2]);
-                }
-
-                //uint16_t reserved = BIG_ENDIAN_16(frame[28], frame[29]); // Bytes 28 y 29 (Reservado) Firmware version && error code
-                uint16_t expectedChecksum = BIG_ENDIAN_16(frame[30], frame[31]);
+                uint16_t expectedChecksum = BIG_ENDIAN_16(frame[FRAME_LENGHT - 2], frame[FRAME_LENGHT - 1]);
 
-                DEBUG_PRINT("Calculated checksum: ");
+                DEBUG_PRINT(F("Calculated checksum: "));
                 DEBUG_PRINTLN(checksum);
 
-                DEBUG_PRINT("Expected checksum: ");
+                DEBUG_PRINT(F("Expected checksum: "));
                 DEBUG_PRINTLN(expectedChecksum);
 
                 if (checksum != expectedChecksum) {
-                    DEBUG_PRINTLN("Bad checksum!");
+                    DEBUG_PRINTLN(F("Bad checksum!"));
                     return false;
                 }
 
                 // now the data is safe to read it.
-                this->adapter.adapt(theData, dataDst);
+                this->decodeFrame(frame, dataDst);
 
                 return true;
             }
 
+            /**
+             * @brief Decodes every valid frame found in a contiguous capture buffer.
+             * 
+             * The buffer is scanned for headers with `memchr`, each candidate is checked with a
+             * vectorized checksum and valid frames are decoded into consecutive entries of `out`.
+             * Garbage and frames failing validation are skipped.
+             * 
+             * @param buf The raw serial bytes.
+             * @param len Number of bytes in `buf`.
+             * @param out Destination array for the decoded readings.
+             * @param cap Number of entries available in `out`.
+             * @param resumeOffset If not null, receives the offset of the first byte not consumed:
+             *                     the start of a trailing partial frame, or of the next frame when
+             *                     `cap` was reached. Pass `buf + *resumeOffset` (plus the following
+             *                     data) in the next call to continue a chunked capture.
+             * 
+             * @return The number of readings written to `out`.
+             * 
+             * @note Static: it needs no processor, touches no sensor stream and notifies no observer.
+             */
+            static size_t decodeFrames(const uint8_t *buf, size_t len, AdapteeType *out, size_t cap, size_t *resumeOffset = nullptr) {
+                const uint8_t *end = buf + len;
+                const uint8_t *pos = buf;
+                size_t count = 0;
+
+                while (count < cap) {
+                    const uint8_t *candidate = findFrameHeader(pos, end, AirQualitySensor::FRAME_STARTING_BYTE_1, AirQualitySensor::FRAME_STARTING_BYTE_2);
+                    if (candidate == nullptr) {
+                        pos = end;
+                        break;
+                    }
+                    pos = candidate;
+                    if ((size_t)(end - pos) < FRAME_LENGHT) {
+                        break;
+                    }
+                    if (AirQualitySensor::isValidFrame(pos)) {
+                        AirQualitySensor::decodeFrame(pos, &out[count++]);
+                        pos += FRAME_LENGHT;
+                    } else {
+                        pos += 1;
+                    }
+                }
+
+                if (resumeOffset != nullptr) {
+                    *resumeOffset = (size_t)(pos - buf);
+                }
+                return count;
+            }
+
             ~AirQualitySensor() {
             }
 
         private:
             Stream *sensorStream;
-            static const uint8_t MAX_OBSERVERS_PHYSIC = 10; //physic limit
-            Adapter& adapter;
+            ByteRingBuffer *ring;
             static constexpr uint8_t FRAME_STARTING_BYTE_1 = 0x42;
             static constexpr uint8_t FRAME_STARTING_BYTE_2 = 0x4D;
-            static constexpr uint8_t FRAME_LENGHT = 32;
-            size_t maxHandlers;
-            void (*observers[MAX_OBSERVERS_PHYSIC])(AdapteeType *data);
-            size_t observersCount;
-
-            bool resynchronizeStream() {
-                bool found = false;
-                DEBUG_PRINT("Resynchronizing: discarding bytes...");
-                // Mientras no se haya encontrado el byte de inicio y haya datos en el buffer
-                while (!found && this->sensorStream->available()) {
-                    if (this->sensorStream->peek() == AirQualitySensor::FRAME_STARTING_BYTE_1) {
-                        // Si encontramos el primer byte de inicio, intentamos leer el segundo byte
-                        this->sensorStream->read(); // Consumir el primer byte
-                        if (this->sensorStream->peek() == AirQualitySensor::FRAME_STARTING_BYTE_2) {
-                            // Encontramos el encabezado completo, estamos alineados
-                            this->sensorStream->read(); // Consumir el segundo byte
-                            found = true;
-                            DEBUG_PRINTLN("OK");
-                        }
-                    } else {
-                        // discard byte
-                        this->sensorStream->read();
-                    }
-                }
+            static constexpr uint8_t FRAME_LENGHT = Layout::FRAME_LENGTH;
+            static constexpr unsigned long FRAME_TIMEOUT_MS = 1000;
+            enum ParserState : uint8_t {
+                WAIT_HEADER_1,
+                WAIT_HEADER_2,
+                READ_LENGTH,
+                READ_PAYLOAD,
+                READ_CHECKSUM
+            };
 
-                DEBUG_PRINTLN("end");
+            ParserState parserState;
+            uint8_t framePos;
+            uint8_t frameEnd;
+            uint8_t replayPos;
+            uint8_t replayLength;
+            uint8_t replay[FRAME_LENGHT];
+            uint16_t runningChecksum;
+            unsigned long lastByteAt;
+            uint32_t framesCount;
+            uint8_t frame[FRAME_LENGHT];
+
+            void initObservers(size_t maxHandlers) {
+                this->maxHandlers = maxHandlers < MAX_OBSERVERS ? (uint8_t)maxHandlers : MAX_OBSERVERS;
+            }
 
-                if (!found) {
-                    DEBUG_PRINTLN("Desynchronized");
-                    this->sensorStream->flush();
+            bool insertObserver(ObserverFn plain, ContextObserverFn withContext, void *context, DispatchPolicy policy, uint8_t every) {
+                if (!this->insert(plain, withContext, context, policy, every)) {
+                    DEBUG_PRINTLN(F("Observer rejected: capacity exhausted or policy not compiled in"));
+                    return false;
                 }
+                return true;
+            }
 
-                return found;
+            void eraseObserver(uint8_t idx) {
+                for (uint8_t i = idx; i + 1 < this->observersCount; ++i) {
+                    this->observers[i] = this->observers[i + 1];
+                }
+                this->observersCount--;
+            }
+
+            void resetParser() {
+                this->parserState = WAIT_HEADER_1;
+                this->framePos = 0;
+                this->runningChecksum = 0;
             }
 
             /**
-             * @brief Reads available data from the sensor stream and processes it into a frame.
+             * @brief Feeds one byte into the incremental frame parser.
              * 
-             * This method reads data from the sensor stream, resynchronizes the stream if necessary, 
-             * and validates the complete frame. If successful, the frame is processed and stored in the
-             * provided data structure.
+             * The parser walks through the header, length, payload and checksum fields of the
+             * frame, accumulating the checksum as bytes arrive. Unexpected bytes while looking
+             * for the header are discarded, and a bad length or checksum restarts the search
+             * from the second byte of the rejected candidate (see `rescanRejected`).
+             * Command acknowledgements share the header and are recorded on the way.
              * 
-             * @param data A pointer to an `AdapteeType` structure where the processed sensor values will be stored.
-             * @param buffer A pointer to a 32-byte buffer used to store the raw sensor data frame.
+             * @param value The next byte received from the sensor.
              * 
-             * @return `true` if the frame was read, validated, and processed successfully.
-             *         `false` if the frame is invalid, incomplete, or the stream is desynchronized.
-             * 
-             * @note
-             * - The method resynchronizes the stream if it detects a desynchronization based on the header bytes.
-             * - Ensure the `buffer` has enough space (32 bytes) to hold the raw frame data.
+             * @return `true` when `value` completes a frame whose length and checksum are valid.
+             *         The raw frame is then available in `frame`.
              */
-            bool readPMSAvailableData(AdapteeType *data, uint8_t *buffer) {
-                DEBUG_PRINTLN("::readPMSdata");
-
-                if (this->sensorStream->available() < AirQualitySensor::FRAME_LENGHT) {
-                    DEBUG_PRINTLN(":::Not enough data available.");
-                    return false;
-                }
-
-                // Check if the buffer contains more data than the frame size. This could 
-                // occur if the stream is not read at regular intervals.
-                // Failing to read the stream periodically may result in buffer overflow
-                // and desynchronization.
-
-                // Resynchronize if there are more bytes than the frame size in the buffer
-                if (this->sensorStream->available() > AirQualitySensor::FRAME_LENGHT) {
-                    DEBUG_PRINTLN("::Invalid frame lenght");
-
-                    if (!resynchronizeStream()) {
+            bool consumeByte(uint8_t value) {
+                switch (this->parserState) {
+                    case WAIT_HEADER_1:
+                        if (value == AirQualitySensor::FRAME_STARTING_BYTE_1) {
+                            this->frame[0] = value;
+                            this->runningChecksum = value;
+                            this->framePos = 1;
+                            this->parserState = WAIT_HEADER_2;
+                            this->markFrameStart();
+                        } else {
+                            this->countDiscarded(1);
+                        }
                         return false;
-                    }
-
-                    // Verificar que haya datos suficientes después de la resincronización
-                    if (this->sensorStream->available() < AirQualitySensor::FRAME_LENGHT -2) {
 
-                        DEBUG_PRINT("Not enough data available after resynchronization. ");
-                        DEBUG_PRINTLN(this->sensorStream->available());
+                    case WAIT_HEADER_2:
+                        if (value == AirQualitySensor::FRAME_STARTING_BYTE_2) {
+                            this->frame[1] = value;
+                            this->runningChecksum += value;
+                            this->framePos = 2;
+                            this->parserState = READ_LENGTH;
+                        } else if (value == AirQualitySensor::FRAME_STARTING_BYTE_1) {
+                            // A repeated first byte may still be the start of a frame.
+                            this->countDiscarded(1);
+                            this->markFrameStart();
+                        } else {
+                            this->countHeaderError();
+                            this->countDiscarded(2);
+                            this->resetParser();
+                        }
+                        return false;
 
+                    case READ_LENGTH:
+                        this->frame[this->framePos++] = value;
+                        this->runningChecksum += value;
+                        if (this->framePos == 4) {
+                            uint16_t framelen = BIG_ENDIAN_16(this->frame[2], this->frame[3]);
+                            if (framelen == Layout::DATA_LENGTH) {
+                                this->frameEnd = FRAME_LENGHT;
+                                this->parserState = READ_PAYLOAD;
+                            } else if (framelen == PMS_ACK_DATA_LENGTH) {
+                                this->frameEnd = PMS_ACK_FRAME_LENGTH;
+                                this->parserState = READ_PAYLOAD;
+                            } else {
+                                DEBUG_PRINT(F("invalid framelen "));
+                                DEBUG_PRINTLN(framelen);
+                                this->countLengthError();
+                                this->rescanRejected(4);
+                            }
+                        }
                         return false;
-                    }
 
-                    buffer[0] = AirQualitySensor::FRAME_STARTING_BYTE_1;
-                    buffer[1] = AirQualitySensor::FRAME_STARTING_BYTE_2;
-                    if (this->sensorStream->readBytes(&buffer[2], FRAME_LENGHT-2) != FRAME_LENGHT-2) {
-                        // Couldn't read all bytes
-                        DEBUG_PRINT("failed to extract all frame bytes after sync");
+                    case READ_PAYLOAD:
+                        this->frame[this->framePos++] = value;
+                        this->runningChecksum += value;
+                        if (this->framePos == this->frameEnd - 2) {
+                            this->parserState = READ_CHECKSUM;
+                        }
                         return false;
+
+                    case READ_CHECKSUM:
+                        this->frame[this->framePos++] = value;
+                        if (this->framePos < this->frameEnd) {
+                            return false;
+                        }
+                        {
+                            uint16_t expectedChecksum = BIG_ENDIAN_16(this->frame[this->frameEnd - 2], this->frame[this->frameEnd - 1]);
+                            if (this->runningChecksum != expectedChecksum) {
+                                DEBUG_PRINTLN(F("Bad checksum!"));
+                                this->countChecksumError();
+                                this->rescanRejected(this->frameEnd);
+                                return false;
+                            }
+                            bool isData = this->frameEnd == FRAME_LENGHT;
+                            if (!isData) {
+                                this->recordAck(this->frame);
+                            }
+                            this->resetParser();
+                            return isData;
+                        }
+                }
+                return false;
+            }
+
+            /**
+             * @brief Runs a window of stream bytes through the parser and notifies the frames found.
+             * 
+             * While looking for a header, the garbage up to the next `0x42` is skipped with a
+             * single `memchr`. Bytes of a rejected candidate that may hold the next header are
+             * queued in `replay` and parsed again before the rest of the window, so a false or
+             * truncated candidate never hides the valid frame that follows it.
+             */
+            void parseWindow(const uint8_t *buf, size_t length, unsigned long now) {
+                size_t pos = 0;
+                while (pos < length || this->replayPos < this->replayLength) {
+                    uint8_t value;
+                    if (this->replayPos < this->replayLength) {
+                        value = this->replay[this->replayPos++];
+                    } else {
+                        if (this->parserState == WAIT_HEADER_1) {
+                            const uint8_t *next = (const uint8_t *)memchr(buf + pos, AirQualitySensor::FRAME_STARTING_BYTE_1, length - pos);
+                            size_t skip = next != nullptr ? (size_t)(next - (buf + pos)) : length - pos;
+                            this->countDiscarded(skip);
+                            pos += skip;
+                            if (pos == length) {
+                                break;
+                            }
+                        }
+                        value = buf[pos++];
                     }
-                } else {
-                    DEBUG_PRINTLN("::reading bytes");
-                    if (this->sensorStream->readBytes(buffer, FRAME_LENGHT) != FRAME_LENGHT) {
-                        // Couldn't read all bytes
-                        DEBUG_PRINT("failed to extract all frame bytes");
-                        return false;
+                    if (this->consumeByte(value)) {
+                        this->acceptFrame(this->frame, now);
                     }
                 }
-                return this->processFrame(buffer, data);
             }
 
+            /**
+             * @brief Drops a rejected candidate of `length` bytes held in `frame`, keeping for
+             *        `parseWindow` the bytes from the next `0x42` on.
+             */
+            void rescanRejected(uint8_t length) {
+                const uint8_t *next = (const uint8_t *)memchr(this->frame + 1, AirQualitySensor::FRAME_STARTING_BYTE_1, length - 1);
+                uint8_t offset = next != nullptr ? (uint8_t)(next - this->frame) : length;
+                this->countDiscarded(offset);
+                uint8_t tail = length - offset;
+                if (tail != 0) {
+                    // The tail and the replay bytes not parsed yet never exceed one frame.
+                    uint8_t remaining = this->replayLength - this->replayPos;
+                    memmove(this->replay + tail, this->replay + this->replayPos, remaining);
+                    memcpy(this->replay, this->frame + offset, tail);
+                    this->replayPos = 0;
+                    this->replayLength = tail + remaining;
+                }
+                this->resetParser();
+            }
 
             /**
-             * @brief Notifies all registered observers with the latest sensor data.
+             * @brief Parses every complete frame currently buffered in the ring.
              * 
-             * This method iterates through all registered observers (callbacks) and invokes each one,
-             * passing the processed sensor data as a parameter.
+             * Frames are validated and decoded in place, straight from the ring storage; only a
+             * frame that wraps around the end of the storage is first copied into `frame`.
+             * Bytes are consumed only once a candidate frame has been accepted or rejected, so a
+             * partially received frame simply stays in the ring until the next call.
              * 
-             * @param data A pointer to the `AdapteeType` structure containing the latest processed sensor data.
+             * @param maxBytes Byte budget; a started frame is always completed, so it may be
+             *                 exceeded by less than one frame.
              * 
-             * @note
-             * - Observers are stored as function pointers and must be registered using `addObserver`.
-             * - Observers are only called if they are non-null.
+             * @return The number of bytes consumed from the ring.
              */
-            void notifyNewValue(AdapteeType *data) {
-                for (uint8_t idx = 0; idx < observersCount; ++idx){
-                    if (this->observers[idx] != nullptr){
-                        this->observers[idx](data);                
+            size_t pollRing(size_t maxBytes) {
+                unsigned long now = millis();
+                size_t avail = this->ring->available();
+                size_t consumed = 0;
+                uint32_t framesBefore = this->framesCount;
+                while (avail >= PMS_ACK_FRAME_LENGTH && consumed < maxBytes) {
+                    size_t runLength;
+                    const uint8_t *run = this->ring->contiguous(runLength);
+                    if (run[0] != AirQualitySensor::FRAME_STARTING_BYTE_1) {
+                        // Skip the garbage up to the next candidate header in a single step.
+                        const uint8_t *next = (const uint8_t *)memchr(run, AirQualitySensor::FRAME_STARTING_BYTE_1, runLength);
+                        size_t discard = next != nullptr ? (size_t)(next - run) : runLength;
+                        if (discard > maxBytes - consumed) {
+                            discard = maxBytes - consumed;
+                        }
+                        this->ring->skip(discard);
+                        this->countDiscarded(discard);
+                        this->forgetFrameSeen();
+                        avail -= discard;
+                        consumed += discard;
+                        continue;
+                    }
+
+                    if (this->ring->peek(1) == AirQualitySensor::FRAME_STARTING_BYTE_2 && this->ring->peek(2) == 0 &&
+                        this->ring->peek(3) == PMS_ACK_DATA_LENGTH) {
+                        const uint8_t *ack = this->ring->linearize(PMS_ACK_FRAME_LENGTH, this->frame);
+                        size_t skip = 1;
+                        if (sumFrameBytes(ack, PMS_ACK_FRAME_LENGTH - 2) == loadBigEndian16(&ack[PMS_ACK_FRAME_LENGTH - 2])) {
+                            this->recordAck(ack);
+                            skip = PMS_ACK_FRAME_LENGTH;
+                        } else {
+                            this->countChecksumError();
+                            this->countDiscarded(1);
+                        }
+                        this->ring->skip(skip);
+                        this->forgetFrameSeen();
+                        avail -= skip;
+                        consumed += skip;
+                        continue;
                     }
+                    // The latency of a frame counts from the poll that first finds its header,
+                    // which may be before the rest of it is in the ring.
+                    this->markFrameSeen();
+                    if (avail < FRAME_LENGHT) {
+                        break;
+                    }
+
+                    const uint8_t *candidate = this->ring->linearize(FRAME_LENGHT, this->frame);
+                    FrameCheck check = this->checkFrame(candidate);
+                    if (check != FRAME_OK) {
+                        this->countError(check);
+                        this->ring->skip(1);
+                        this->forgetFrameSeen();
+                        avail -= 1;
+                        consumed += 1;
+                        continue;
+                    }
+
+                    this->acceptFrame(candidate, now);
+                    this->ring->skip(FRAME_LENGHT);
+                    this->forgetFrameSeen();
+                    avail -= FRAME_LENGHT;
+                    consumed += FRAME_LENGHT;
                 }
+                this->notifyLatest(now);
+                this->trackPoll(now, this->framesCount != framesBefore);
+                return consumed;
             }
+
+            enum FrameCheck : uint8_t {
+                FRAME_OK,
+                FRAME_BAD_HEADER,
+                FRAME_BAD_LENGTH,
+                FRAME_BAD_CHECKSUM
+            };
+
+            /**
+             * @brief Checks header, length and checksum of a complete frame.
+             */
+            static FrameCheck checkFrame(const uint8_t *frame) {
+                if (frame[0] != AirQualitySensor::FRAME_STARTING_BYTE_1 || frame[1] != AirQualitySensor::FRAME_STARTING_BYTE_2) {
+                    return FRAME_BAD_HEADER;
+                }
+                if (BIG_ENDIAN_16(frame[2], frame[3]) != Layout::DATA_LENGTH) {
+                    return FRAME_BAD_LENGTH;
+                }
+                if (sumFrameBytes(frame, FRAME_LENGHT - 2) != loadBigEndian16(&frame[FRAME_LENGHT - 2])) {
+                    return FRAME_BAD_CHECKSUM;
+                }
+                return FRAME_OK;
+            }
+
+            static bool isValidFrame(const uint8_t *frame) {
+                return AirQualitySensor::checkFrame(frame) == FRAME_OK;
+            }
+
+            /**
+             * @brief Counts a rejected candidate; only its first byte is discarded.
+             */
+            void countError(FrameCheck check) {
+                this->countDiscarded(1);
+                switch (check) {
+                    case FRAME_BAD_HEADER:
+                        this->countHeaderError();
+                        break;
+                    case FRAME_BAD_LENGTH:
+                        this->countLengthError();
+                        break;
+                    case FRAME_BAD_CHECKSUM:
+                        this->countChecksumError();
+                        break;
+                    default:
+                        break;
+                }
+            }
+
+            /**
+             * @brief Takes a valid data frame: notifies it, or under `BACKLOG_LATEST_WINS`
+             *        keeps it until the end of the current `poll()`.
+             */
+            void acceptFrame(const uint8_t *frame, unsigned long now) {
+                this->framesCount++;
+                this->countFrameOk();
+                if (this->keepsLatestOnly()) {
+                    if (this->keepLatest(frame, this->frameStart())) {
+                        this->countSuperseded();
+                    }
+                    return;
+                }
+                this->notifyFrame(frame, now, this->frameStart());
+            }
+
+            void notifyLatest(unsigned long now) {
+                unsigned long startUs;
+                const uint8_t *latest = this->takeLatest(&startUs);
+                if (latest != nullptr) {
+                    this->notifyFrame(latest, now, startUs);
+                }
+            }
+
+            /**
+             * @brief Publishes a data frame as the latest reading and, if it passes the deadband
+             *        filter, decodes it and notifies the observers.
+             */
+            void notifyFrame(const uint8_t *frame, unsigned long now, unsigned long startUs) {
+                this->publishReading(frame, now);
+                if (!this->passesDeadband(frame, now)) {
+                    return;
+                }
+                AdapteeType data;
+                this->decodeFrame(frame, &data);
+                this->recordLatency(startUs);
+                this->notifyObservers(&data);
+            }
+
+            /**
+             * @brief Converts the payload of an already validated frame into the data model.
+             * 
+             * @param frame A pointer to a frame whose header, length and checksum were checked.
+             * @param dataDst The structure receiving the sensor values. Every field mapped by
+             *                the layout is overwritten.
+             */
+            static void decodeFrame(const uint8_t *frame, AdapteeType *dataDst) {
+                Layout::decode(frame, dataDst);
+            }
+
+            // A copy would share the stream with the original and tear the latch being
+            // published to: construct processors in place instead.
+            AirQualitySensor(const AirQualitySensor &) = delete;
+            AirQualitySensor &operator=(const AirQualitySensor &) = delete;
         };
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,181 @@
+#ifndef AIR_QUALITY_SENSOR_STATISTICS_H
+#define AIR_QUALITY_SENSOR_STATISTICS_H
+#include "Arduino.h"
+#include "AirQualityIndex.h"
+#include "RollingStatistics.h"
+
+namespace debuguear {
+
+    /**
+     * @brief PM fields tracked by `AirQualityStatistics`, combined into its `FIELDS` argument.
+     */
+    enum StatFields : uint8_t {
+        STAT_PM10_STANDARD = 0x01,
+        STAT_PM25_STANDARD = 0x02,
+        STAT_PM100_STANDARD = 0x04,
+        STAT_PM10_ENV = 0x08,
+        STAT_PM25_ENV = 0x10,
+        STAT_PM100_ENV = 0x20,
+        STAT_FIELDS_AQI = STAT_PM25_ENV | STAT_PM100_ENV,  // both inputs of `aqi()`
+        STAT_FIELDS_ALL = 0x3F
+    };
+
+    /**
+     * @brief Rolling statistics, NowCast and AQI for the PM fields of a sensor model.
+     *
+     * Subscribes to a processor as an observer and keeps, for each tracked PM field, the
+     * 1 min, 15 min and 24 h sliding mean, min, max and EMA (see `FieldStatistics`). The NowCast
+     * and AQI of `pm25_env` and `pm100_env` are kept up to date as hours close, so every query
+     * is O(1).
+     *
+     * @tparam ModelT Any model with the `pm*_standard` and `pm*_env` fields.
+     * @tparam FIELDS The `StatFields` tracked. Each one takes a `FieldStatistics`, 424 bytes on
+     *                a 64-bit host and slightly less on AVR, so only `pm25_env` is tracked by
+     *                default: all six would not fit in the 2 KB of an ATmega328.
+     *
+     * @example
+     * ```cpp
+     * debuguear::PMS5003T_PROCESSOR_T processor(&pmsSerial, 1);
+     * debuguear::AirQualityStatistics<debuguear::AirQualityModel_PMS5003T> stats;
+     *
+     * void setup() {
+     *     processor.addObserver(decltype(stats)::onReading, &stats);
+     * }
+     * ```
+     */
+    template <typename ModelT, uint8_t FIELDS = STAT_PM25_ENV>
+    class AirQualityStatistics {
+        static_assert((FIELDS & STAT_FIELDS_ALL) != 0 && (FIELDS & ~STAT_FIELDS_ALL) == 0,
+                      "AirQualityStatistics needs a non-empty set of StatFields");
+
+        public:
+            typedef ModelT Model;
+
+            enum Field : uint8_t {
+                PM10_STANDARD,
+                PM25_STANDARD,
+                PM100_STANDARD,
+                PM10_ENV,
+                PM25_ENV,
+                PM100_ENV,
+                FIELD_COUNT
+            };
+
+            /**
+             * @brief Context observer feeding the statistics object passed as `context`,
+             *        with `millis()` timestamps.
+             */
+            static void onReading(void *context, const Model *data) {
+                static_cast<AirQualityStatistics *>(context)->add(*data, millis());
+            }
+
+            void add(const Model &data, unsigned long nowMs) {
+                this->addTo(PM10_STANDARD, data.pm10_standard, nowMs);
+                this->addTo(PM25_STANDARD, data.pm25_standard, nowMs);
+                this->addTo(PM100_STANDARD, data.pm100_standard, nowMs);
+                this->addTo(PM10_ENV, data.pm10_env, nowMs);
+                this->addTo(PM25_ENV, data.pm25_env, nowMs);
+                this->addTo(PM100_ENV, data.pm100_env, nowMs);
+            }
+
+            static constexpr bool tracks(Field field) {
+                return (FIELDS & (1 << field)) != 0;
+            }
+
+            /**
+             * @brief Ages the windows up to `nowMs` when no reading arrived.
+             */
+            void advance(unsigned long nowMs) {
+                for (uint8_t i = 0; i < TRACKED; ++i) {
+                    fields[i].advance(nowMs);
+                }
+            }
+
+            void clear() {
+                for (uint8_t i = 0; i < TRACKED; ++i) {
+                    fields[i].clear();
+                }
+            }
+
+            /**
+             * @brief Summary of a window, never `valid` for a field that is not tracked.
+             */
+            WindowSummary summary(Field field, StatWindow window) const {
+                if (!tracks(field)) {
+                    WindowSummary none = {0, 0, 0, 0, false};
+                    return none;
+                }
+                return fields[slotOf(field)].summary(window);
+            }
+
+            /**
+             * @return The statistics of `field`, `nullptr` if it is not tracked.
+             */
+            const FieldStatistics *field(Field field) const {
+                return tracks(field) ? &fields[slotOf(field)] : nullptr;
+            }
+
+            /**
+             * @brief NowCast of `pm25_env` in µg/m³, negative while unavailable or not tracked.
+             */
+            float nowcastPm25() const {
+                return tracks(PM25_ENV) ? fields[slotOf(PM25_ENV)].nowcast() : -1;
+            }
+
+            /**
+             * @brief NowCast of `pm100_env` in µg/m³, negative while unavailable or not tracked.
+             */
+            float nowcastPm100() const {
+                return tracks(PM100_ENV) ? fields[slotOf(PM100_ENV)].nowcast() : -1;
+            }
+
+            /**
+             * @brief Current US EPA AQI from the PM2.5 NowCast, -1 while unavailable.
+             */
+            int16_t aqiPm25() const {
+                return aqiFromPm25(this->nowcastPm25());
+            }
+
+            /**
+             * @brief Current US EPA AQI from the PM10 NowCast, -1 while unavailable.
+             */
+            int16_t aqiPm100() const {
+                return aqiFromPm100(this->nowcastPm100());
+            }
+
+            /**
+             * @brief The overall AQI, i.e. the worst of the PM2.5 and PM10 ones. With the
+             *        default `FIELDS`, the PM2.5 one only.
+             */
+            int16_t aqi() const {
+                int16_t pm25 = this->aqiPm25();
+                int16_t pm100 = this->aqiPm100();
+                return pm25 > pm100 ? pm25 : pm100;
+            }
+
+        private:
+            static constexpr uint8_t countBits(uint8_t bits) {
+                return bits == 0 ? 0 : (uint8_t)((bits & 1) + countBits(bits >> 1));
+            }
+
+            static constexpr uint8_t TRACKED = countBits(FIELDS);
+
+            /**
+             * @brief Index in `fields` of a tracked field: the tracked fields before it.
+             */
+            static constexpr uint8_t slotOf(Field field) {
+                return countBits(FIELDS & ((1 << field) - 1));
+            }
+
+            void addTo(Field field, uint16_t value, unsigned long nowMs) {
+                if (tracks(field)) {
+                    fields[slotOf(field)].add(value, nowMs);
+                }
+            }
+
+            FieldStatistics fields[TRACKED];
+    };
+
+}
+
+#endif
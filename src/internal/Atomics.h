@@ -0,0 +1,102 @@
+#ifndef AIR_QUALITY_SENSOR_ATOMICS_H
+#define AIR_QUALITY_SENSOR_ATOMICS_H
+#include "Arduino.h"
+
+#if defined(__AVR__)
+    // avr-libstdc++ does not ship <atomic>. AVR is single core and byte sized
+    // loads/stores cannot be torn, so volatile plus a compiler barrier is enough
+    // for values shared with an ISR as long as they are one byte wide.
+    #define AIR_QUALITY_HAS_STD_ATOMIC 0
+    #define AIR_QUALITY_COMPILER_BARRIER() __asm__ __volatile__("" ::: "memory")
+#else
+    #include <atomic>
+    #define AIR_QUALITY_HAS_STD_ATOMIC 1
+#endif
+
+namespace debuguear {
+
+    /**
+     * @brief Minimal acquire/release cell shared between an ISR (or thread) and the main loop.
+     * 
+     * Wraps `std::atomic<T>` where the toolchain provides it, and a volatile variable
+     * fenced by compiler barriers on AVR.
+     * 
+     * @note On AVR `T` must be a single byte to be read and written atomically.
+     */
+    template <typename T>
+    class AtomicCell {
+        public:
+            AtomicCell() : value(T()) {}
+            explicit AtomicCell(T initial) : value(initial) {}
+
+#if AIR_QUALITY_HAS_STD_ATOMIC
+            T load() const { return value.load(std::memory_order_acquire); }
+            void store(T v) { value.store(v, std::memory_order_release); }
+            T loadRelaxed() const { return value.load(std::memory_order_relaxed); }
+            void storeRelaxed(T v) { value.store(v, std::memory_order_relaxed); }
+
+            /**
+             * @brief Replaces the value with `desired` if it still equals `expected`, otherwise
+             *        loads the current value into `expected`. May fail spuriously.
+             *
+             * @note Only available where `std::atomic` is, for the multi-producer queues.
+             */
+            bool compareExchange(T &expected, T desired) {
+                return value.compare_exchange_weak(expected, desired, std::memory_order_relaxed);
+            }
+
+            T fetchAdd(T delta) { return value.fetch_add(delta, std::memory_order_relaxed); }
+
+        private:
+            std::atomic<T> value;
+#else
+            T load() const { T v = value; AIR_QUALITY_COMPILER_BARRIER(); return v; }
+            void store(T v) { AIR_QUALITY_COMPILER_BARRIER(); value = v; }
+            T loadRelaxed() const { return value; }
+            void storeRelaxed(T v) { value = v; }
+
+        private:
+            volatile T value;
+#endif
+            AtomicCell(const AtomicCell &) = delete;
+            AtomicCell &operator=(const AtomicCell &) = delete;
+    };
+
+    /**
+     * @brief Orders the memory writes before the fence before those after it, for data that is
+     *        not itself in an `AtomicCell` (see `ReadingLatch`).
+     */
+    inline void releaseFence() {
+#if AIR_QUALITY_HAS_STD_ATOMIC
+        std::atomic_thread_fence(std::memory_order_release);
+#else
+        AIR_QUALITY_COMPILER_BARRIER();
+#endif
+    }
+
+    /**
+     * @brief Orders the memory reads before the fence before those after it.
+     */
+    inline void acquireFence() {
+#if AIR_QUALITY_HAS_STD_ATOMIC
+        std::atomic_thread_fence(std::memory_order_acquire);
+#else
+        AIR_QUALITY_COMPILER_BARRIER();
+#endif
+    }
+
+    /**
+     * @brief Orders every memory access before the fence before every one after it, including a
+     *        store before a load, which release and acquire fences do not (see `ReadingQueue`).
+     */
+    inline void fullFence() {
+#if AIR_QUALITY_HAS_STD_ATOMIC
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+#else
+        AIR_QUALITY_COMPILER_BARRIER();
+#endif
+    }
+
+}
+
+#endif
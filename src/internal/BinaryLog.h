@@ -0,0 +1,420 @@
+#ifndef AIR_QUALITY_SENSOR_BINARY_LOG_H
+#define AIR_QUALITY_SENSOR_BINARY_LOG_H
+#include "Arduino.h"
+#include "FrameLayout.h"
+
+namespace debuguear {
+
+    /**
+     * Binary log format
+     * -----------------
+     *
+     * A log is a sequence of independent blocks:
+     *
+     *     0xA5  wordCount  keyframe  record*  0x00  crcH crcL
+     *
+     * - `wordCount` is the number of frame data words per reading (`Layout::DATA_WORDS_N`).
+     * - The keyframe is the first reading of the block: a 32-bit timestamp followed by every
+     *   data word, all little-endian.
+     * - Each following record is a varint `control`, optionally followed by a varint `mask` and
+     *   one varint per bit set in `mask`:
+     *   - `control - 1` holds the zig-zag change of the interval between timestamps, shifted
+     *     left by one, and in bit 0 whether any word changed. `control == 0` ends the block.
+     *   - bit `i` of `mask` tells that word `i` changed; its varint is the zig-zag difference
+     *     from the previous reading, modulo 2^16.
+     * - The CRC-16/CCITT-FALSE covers everything from `0xA5` to the end marker.
+     *
+     * A reading whose words and interval did not change is a single byte, which is the common
+     * case as PMS sensors repeat a reading for a few frames.
+     */
+    namespace binarylog {
+        static constexpr uint8_t BLOCK_SYNC = 0xA5;
+        static constexpr uint8_t BLOCK_END = 0x00;
+        // A writer closes its block after `recordsPerBlock` readings, a `uint8_t`.
+        static constexpr size_t MAX_BLOCK_RECORDS = 255;
+
+        inline uint16_t crc16Update(uint16_t crc, const uint8_t *data, size_t length) {
+            while (length--) {
+                crc ^= (uint16_t)(*data++) << 8;
+                for (uint8_t bit = 0; bit < 8; ++bit) {
+                    crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+                }
+            }
+            return crc;
+        }
+
+        inline uint8_t putVarint(uint8_t *dst, uint32_t value) {
+            uint8_t n = 0;
+            while (value >= 0x80) {
+                dst[n++] = (uint8_t)(value | 0x80);
+                value >>= 7;
+            }
+            dst[n++] = (uint8_t)value;
+            return n;
+        }
+
+        /**
+         * @return The number of bytes read, 0 if the varint runs past `end` and -1 if it is
+         *         longer than five bytes.
+         */
+        inline int getVarint(const uint8_t *p, const uint8_t *end, uint32_t *value) {
+            uint32_t result = 0;
+            for (uint8_t i = 0; i < 5; ++i) {
+                if (p + i >= end) {
+                    return 0;
+                }
+                result |= (uint32_t)(p[i] & 0x7F) << (7 * i);
+                if ((p[i] & 0x80) == 0) {
+                    *value = result;
+                    return i + 1;
+                }
+            }
+            return -1;
+        }
+
+        inline uint32_t zigzag32(int32_t v) {
+            return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+        }
+
+        inline int32_t unzigzag32(uint32_t v) {
+            return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+        }
+
+        inline uint16_t zigzag16(int16_t v) {
+            return (uint16_t)(((uint16_t)v << 1) ^ (uint16_t)(v >> 15));
+        }
+
+        inline int16_t unzigzag16(uint16_t v) {
+            return (int16_t)((v >> 1) ^ (uint16_t)-(int16_t)(v & 1));
+        }
+    }
+
+    /**
+     * @brief One decoded entry of a binary log.
+     */
+    template <typename Model>
+    struct BinaryLogRecord {
+        uint32_t timestamp;
+        Model data;
+    };
+
+    /**
+     * @brief Streaming encoder of the binary log format (see above) to any `Print`.
+     *
+     * Every reading is encoded into a small stack buffer and handed to the sink in a single
+     * `write`, so the encoder is cheap enough to run inside an observer. A block is closed
+     * every `recordsPerBlock` readings or on `flush()`.
+     *
+     * @tparam Layout The `FrameLayout` of the sensor; readings are stored as its data words.
+     *
+     * @example
+     * ```cpp
+     * File logFile = SD.open("pms.bin", FILE_WRITE);
+     * debuguear::BinaryLogWriter<debuguear::LayoutPMS5003T> logWriter(logFile);
+     *
+     * void setup() {
+     *     processor.addObserver(decltype(logWriter)::onReading, &logWriter);
+     * }
+     * ```
+     */
+    template <typename Layout>
+    class BinaryLogWriter {
+        public:
+            typedef typename Layout::Model Model;
+
+            static constexpr uint8_t WORDS = Layout::DATA_WORDS_N;
+
+            /**
+             * @param sink Destination of the encoded bytes. It must outlive the writer.
+             * @param recordsPerBlock Readings per block, keyframe included (at least 1).
+             *                        Larger blocks amortize the keyframe; smaller ones lose
+             *                        less data when a block is damaged.
+             */
+            BinaryLogWriter(Print &sink, uint8_t recordsPerBlock = 64)
+                : out(&sink), recordsPerBlock(recordsPerBlock ? recordsPerBlock : 1),
+                  recordsInBlock(0), crc(0xFFFF), lastTimestamp(0), lastInterval(0) {}
+
+            /**
+             * @brief Context observer appending every reading to the writer passed as `context`,
+             *        stamped with `millis()`.
+             */
+            static void onReading(void *context, const Model *data) {
+                static_cast<BinaryLogWriter *>(context)->write(*data, millis());
+            }
+
+            /**
+             * @brief Appends a reading.
+             *
+             * @return The number of bytes handed to the sink.
+             */
+            size_t write(const Model &data, uint32_t timestamp) {
+                uint16_t words[WORDS];
+                Layout::toWords(&data, words);
+
+                uint8_t record[RECORD_CAPACITY];
+                uint8_t length = 0;
+                size_t written = 0;
+                uint32_t interval = timestamp - lastTimestamp;
+                int32_t intervalChange = (int32_t)(interval - lastInterval);
+                uint32_t zigzagChange = binarylog::zigzag32(intervalChange);
+                if (recordsInBlock != 0 && zigzagChange >= 0x7FFFFFFFUL) {
+                    // The interval jump does not fit the control varint: start over with a keyframe.
+                    written += this->closeBlock();
+                }
+
+                if (recordsInBlock == 0) {
+                    crc = 0xFFFF;
+                    record[length++] = binarylog::BLOCK_SYNC;
+                    record[length++] = WORDS;
+                    for (uint8_t i = 0; i < 4; ++i) {
+                        record[length++] = (uint8_t)(timestamp >> (8 * i));
+                    }
+                    for (uint8_t i = 0; i < WORDS; ++i) {
+                        record[length++] = (uint8_t)words[i];
+                        record[length++] = (uint8_t)(words[i] >> 8);
+                    }
+                    lastInterval = 0;
+                } else {
+                    uint32_t mask = 0;
+                    uint8_t deltas[WORDS * 3];
+                    uint8_t deltaLength = 0;
+                    for (uint8_t i = 0; i < WORDS; ++i) {
+                        if (words[i] != lastWords[i]) {
+                            mask |= (uint32_t)1 << i;
+                            deltaLength += binarylog::putVarint(&deltas[deltaLength], binarylog::zigzag16((int16_t)(words[i] - lastWords[i])));
+                        }
+                    }
+                    length += binarylog::putVarint(&record[length], ((zigzagChange << 1) | (mask != 0 ? 1 : 0)) + 1);
+                    if (mask != 0) {
+                        length += binarylog::putVarint(&record[length], mask);
+                        memcpy(&record[length], deltas, deltaLength);
+                        length += deltaLength;
+                    }
+                    lastInterval = interval;
+                }
+
+                memcpy(lastWords, words, sizeof(words));
+                lastTimestamp = timestamp;
+                crc = binarylog::crc16Update(crc, record, length);
+                written += out->write(record, length);
+                if (++recordsInBlock >= recordsPerBlock) {
+                    written += this->closeBlock();
+                }
+                return written;
+            }
+
+            /**
+             * @brief Closes the current block so everything written so far can be decoded.
+             *
+             * @return The number of bytes handed to the sink.
+             */
+            size_t flush() {
+                return this->closeBlock();
+            }
+
+        private:
+            static constexpr uint8_t KEYFRAME_LENGTH = 2 + 4 + WORDS * 2;
+            static constexpr uint8_t DELTA_LENGTH = 5 + 5 + WORDS * 3;
+            static constexpr uint8_t RECORD_CAPACITY = KEYFRAME_LENGTH > DELTA_LENGTH ? KEYFRAME_LENGTH : DELTA_LENGTH;
+
+            static_assert(WORDS <= 32, "Change mask is limited to 32 words");
+
+            Print *out;
+            uint8_t recordsPerBlock;
+            uint8_t recordsInBlock;
+            uint16_t crc;
+            uint32_t lastTimestamp;
+            uint32_t lastInterval;
+            uint16_t lastWords[WORDS];
+
+            size_t closeBlock() {
+                if (recordsInBlock == 0) {
+                    return 0;
+                }
+                uint8_t trailer[3];
+                trailer[0] = binarylog::BLOCK_END;
+                crc = binarylog::crc16Update(crc, trailer, 1);
+                trailer[1] = (uint8_t)(crc >> 8);
+                trailer[2] = (uint8_t)crc;
+                recordsInBlock = 0;
+                return out->write(trailer, sizeof(trailer));
+            }
+    };
+
+    /**
+     * @brief Decoder of binary logs written by `BinaryLogWriter`, meant for host tools.
+     *
+     * Only blocks whose CRC matches are returned. Damaged blocks are counted and skipped, and
+     * decoding resynchronizes on the next block.
+     */
+    template <typename Layout>
+    class BinaryLogReader {
+        public:
+            typedef typename Layout::Model Model;
+            typedef BinaryLogRecord<Model> Record;
+
+            static constexpr uint8_t WORDS = Layout::DATA_WORDS_N;
+
+            BinaryLogReader() : corrupted(0) {}
+
+            /**
+             * @brief Decodes every complete block of `buf` into consecutive entries of `out`.
+             *
+             * @param buf The log bytes.
+             * @param len Number of bytes in `buf`.
+             * @param out Destination array for the decoded readings.
+             * @param cap Number of entries available in `out`. It should hold at least one whole
+             *            block (`recordsPerBlock` of the writer), otherwise no progress is made.
+             *            A candidate block is parsed to its end (at most `MAX_BLOCK_RECORDS`
+             *            readings) whatever `cap`, so a damaged end marker is always detected.
+             * @param resumeOffset If not null, receives the offset of the first block not decoded:
+             *                     a trailing partial block, or the next block once `out` is full.
+             *
+             * @return The number of readings written to `out`.
+             */
+            size_t decode(const uint8_t *buf, size_t len, Record *out, size_t cap, size_t *resumeOffset = nullptr) {
+                const uint8_t *end = buf + len;
+                const uint8_t *pos = buf;
+                size_t count = 0;
+
+                while (pos < end) {
+                    const uint8_t *sync = (const uint8_t *)memchr(pos, binarylog::BLOCK_SYNC, (size_t)(end - pos));
+                    if (sync == nullptr) {
+                        pos = end;
+                        break;
+                    }
+                    pos = sync;
+                    size_t decoded = 0;
+                    BlockResult result = this->decodeBlock(pos, end, &out[count], cap - count, &decoded);
+                    if (result == BLOCK_OK) {
+                        count += decoded;
+                        continue;
+                    }
+                    if (result == BLOCK_INCOMPLETE) {
+                        break;
+                    }
+                    corrupted++;
+                    pos++;
+                }
+
+                if (resumeOffset != nullptr) {
+                    *resumeOffset = (size_t)(pos - buf);
+                }
+                return count;
+            }
+
+            /**
+             * @brief Number of block candidates rejected so far because of a bad CRC or encoding.
+             */
+            size_t corruptedBlocks() const {
+                return corrupted;
+            }
+
+        private:
+            enum BlockResult : uint8_t {
+                BLOCK_OK,
+                BLOCK_INCOMPLETE,   // runs past the end of the buffer, or is valid but exceeds `cap`
+                BLOCK_CORRUPTED
+            };
+
+            size_t corrupted;
+
+            /**
+             * @brief Decodes the block starting at `pos`, advancing `pos` past it on success.
+             */
+            BlockResult decodeBlock(const uint8_t *&pos, const uint8_t *end, Record *out, size_t cap, size_t *decoded) {
+                const uint8_t *p = pos;
+                if ((size_t)(end - p) < 2u + 4u + WORDS * 2u) {
+                    return BLOCK_INCOMPLETE;
+                }
+                if (p[1] != WORDS) {
+                    return BLOCK_CORRUPTED;
+                }
+                p += 2;
+
+                uint32_t timestamp = 0;
+                for (uint8_t i = 0; i < 4; ++i) {
+                    timestamp |= (uint32_t)p[i] << (8 * i);
+                }
+                p += 4;
+                uint16_t words[WORDS];
+                for (uint8_t i = 0; i < WORDS; ++i) {
+                    words[i] = (uint16_t)(p[0] | (p[1] << 8));
+                    p += 2;
+                }
+
+                size_t count = 0;
+                uint32_t interval = 0;
+                while (true) {
+                    if (count >= binarylog::MAX_BLOCK_RECORDS) {
+                        // No writer produces such a block: its end marker was damaged.
+                        return BLOCK_CORRUPTED;
+                    }
+                    if (count < cap) {
+                        out[count].timestamp = timestamp;
+                        out[count].data.clean();
+                        Layout::fromWords(words, &out[count].data);
+                    }
+                    count++;
+
+                    uint32_t control;
+                    int n = binarylog::getVarint(p, end, &control);
+                    if (n <= 0) {
+                        return n == 0 ? BLOCK_INCOMPLETE : BLOCK_CORRUPTED;
+                    }
+                    p += n;
+                    if (control == binarylog::BLOCK_END) {
+                        break;
+                    }
+                    control -= 1;
+                    interval += (uint32_t)binarylog::unzigzag32(control >> 1);
+                    timestamp += interval;
+                    if ((control & 1) == 0) {
+                        continue;
+                    }
+
+                    uint32_t mask;
+                    n = binarylog::getVarint(p, end, &mask);
+                    if (n <= 0) {
+                        return n == 0 ? BLOCK_INCOMPLETE : BLOCK_CORRUPTED;
+                    }
+                    p += n;
+                    if (mask == 0 || (WORDS < 32 && (mask >> WORDS) != 0)) {
+                        return BLOCK_CORRUPTED;
+                    }
+                    for (uint8_t i = 0; i < WORDS; ++i) {
+                        if ((mask & ((uint32_t)1 << i)) == 0) {
+                            continue;
+                        }
+                        uint32_t delta;
+                        n = binarylog::getVarint(p, end, &delta);
+                        if (n <= 0) {
+                            return n == 0 ? BLOCK_INCOMPLETE : BLOCK_CORRUPTED;
+                        }
+                        if (delta > 0xFFFF) {
+                            return BLOCK_CORRUPTED;
+                        }
+                        p += n;
+                        words[i] = (uint16_t)(words[i] + binarylog::unzigzag16((uint16_t)delta));
+                    }
+                }
+
+                if (end - p < 2) {
+                    return BLOCK_INCOMPLETE;
+                }
+                uint16_t crc = binarylog::crc16Update(0xFFFF, pos, (size_t)(p - pos));
+                if (crc != (uint16_t)((p[0] << 8) | p[1])) {
+                    return BLOCK_CORRUPTED;
+                }
+                if (count > cap) {
+                    return BLOCK_INCOMPLETE;
+                }
+                pos = p + 2;
+                *decoded = count;
+                return BLOCK_OK;
+            }
+    };
+
+}
+
+#endif
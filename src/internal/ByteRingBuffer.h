@@ -0,0 +1,226 @@
+#ifndef AIR_QUALITY_SENSOR_BYTE_RING_BUFFER_H
+#define AIR_QUALITY_SENSOR_BYTE_RING_BUFFER_H
+#include "Arduino.h"
+#include "Atomics.h"
+
+namespace debuguear {
+
+#if defined(__AVR__)
+    typedef uint8_t ring_index_t;
+    #define AIR_QUALITY_RING_MAX_SIZE 128
+#else
+    typedef uint32_t ring_index_t;
+    #define AIR_QUALITY_RING_MAX_SIZE 0x40000000UL
+#endif
+
+    /**
+     * @brief Lock-free single-producer/single-consumer byte queue.
+     *
+     * The producer side (`push`) is meant to run from a UART RX interrupt or a DMA
+     * half/full-transfer callback, the consumer side (`available`, `peek`, `skip`, ...)
+     * from the code that owns the `AirQualitySensor`. Head and tail are free running
+     * counters, each written by a single side only, so no lock is needed.
+     *
+     * The storage is provided by `SpscRingBuffer<SIZE>`; this base class lets the
+     * processor work with any ring size without being templated on it.
+     *
+     * @note When the ring is full the incoming byte is dropped and counted as an overrun.
+     */
+    class ByteRingBuffer {
+        public:
+
+            /**
+             * @brief Producer side: appends one byte. Safe to call from an ISR.
+             *
+             * @return `false` if the ring was full and the byte was dropped.
+             */
+            bool push(uint8_t value) {
+                ring_index_t h = head.loadRelaxed();
+                if ((ring_index_t)(h - tail.load()) >= capacity) {
+                    overruns.storeRelaxed(overruns.loadRelaxed() + 1);
+                    return false;
+                }
+                storage[h & mask] = value;
+                head.store((ring_index_t)(h + 1));
+                return true;
+            }
+
+            /**
+             * @brief Producer side: appends a block of bytes, e.g. from a DMA callback.
+             *
+             * @return The number of bytes stored. Bytes that did not fit are counted as overruns.
+             */
+            size_t push(const uint8_t *data, size_t length) {
+                ring_index_t h = head.loadRelaxed();
+                size_t space = capacity - (ring_index_t)(h - tail.load());
+                size_t count = length < space ? length : space;
+                for (size_t i = 0; i < count; ++i) {
+                    storage[(ring_index_t)(h + i) & mask] = data[i];
+                }
+                head.store((ring_index_t)(h + count));
+                if (count < length) {
+                    overruns.storeRelaxed(overruns.loadRelaxed() + 1);
+                }
+                return count;
+            }
+
+            /**
+             * @brief Producer side: the longest free run that is contiguous in storage.
+             *
+             * Lets a DMA transfer or a `read(2)` write straight into the ring; publish the
+             * bytes with `commit()`.
+             *
+             * @param length Receives the number of bytes writable through the returned pointer.
+             */
+            uint8_t *writable(size_t &length) {
+                ring_index_t h = head.loadRelaxed();
+                size_t space = capacity - (ring_index_t)(h - tail.load());
+                size_t offset = h & mask;
+                size_t toEnd = capacity - offset;
+                length = space < toEnd ? space : toEnd;
+                return &storage[offset];
+            }
+
+            /**
+             * @brief Producer side: makes `count` bytes written through `writable()` available.
+             */
+            void commit(size_t count) {
+                head.store((ring_index_t)(head.loadRelaxed() + count));
+            }
+
+            /**
+             * @brief Consumer side: number of bytes ready to be read.
+             */
+            size_t available() const {
+                return (ring_index_t)(head.load() - tail.loadRelaxed());
+            }
+
+            /**
+             * @brief Consumer side: reads the byte `offset` positions after the tail without consuming it.
+             *
+             * @note The caller must ensure `offset < available()`.
+             */
+            uint8_t peek(size_t offset = 0) const {
+                return storage[(ring_index_t)(tail.loadRelaxed() + offset) & mask];
+            }
+
+            /**
+             * @brief Consumer side: removes and returns the next byte, or -1 when empty.
+             */
+            int pop() {
+                ring_index_t t = tail.loadRelaxed();
+                if (head.load() == t) {
+                    return -1;
+                }
+                uint8_t value = storage[t & mask];
+                tail.store((ring_index_t)(t + 1));
+                return value;
+            }
+
+            /**
+             * @brief Consumer side: discards `count` bytes. The caller must ensure `count <= available()`.
+             */
+            void skip(size_t count) {
+                tail.store((ring_index_t)(tail.loadRelaxed() + count));
+            }
+
+            /**
+             * @brief Consumer side: pointer to the longest run of buffered bytes that is contiguous in storage.
+             *
+             * @param length Receives the number of bytes readable through the returned pointer.
+             */
+            const uint8_t *contiguous(size_t &length) const {
+                ring_index_t t = tail.loadRelaxed();
+                size_t avail = (ring_index_t)(head.load() - t);
+                size_t offset = t & mask;
+                size_t toEnd = capacity - offset;
+                length = avail < toEnd ? avail : toEnd;
+                return &storage[offset];
+            }
+
+            /**
+             * @brief Consumer side: gives access to the next `length` bytes as one linear block.
+             *
+             * Returns a pointer straight into the ring storage when those bytes do not wrap
+             * around its end, so the common case costs no copy. Otherwise the bytes are copied
+             * into `scratch`, which must hold at least `length` bytes.
+             *
+             * @note The caller must ensure `length <= available()`.
+             */
+            const uint8_t *linearize(size_t length, uint8_t *scratch) const {
+                size_t offset = tail.loadRelaxed() & mask;
+                if (offset + length <= capacity) {
+                    return &storage[offset];
+                }
+                size_t first = capacity - offset;
+                memcpy(scratch, &storage[offset], first);
+                memcpy(scratch + first, storage, length - first);
+                return scratch;
+            }
+
+            /**
+             * @brief Number of push attempts that found the ring full since construction.
+             */
+            ring_index_t overrunCount() const {
+                return overruns.loadRelaxed();
+            }
+
+            size_t size() const {
+                return capacity;
+            }
+
+        protected:
+            ByteRingBuffer(uint8_t *storage, size_t capacity)
+                : storage(storage), capacity((ring_index_t)capacity), mask((ring_index_t)(capacity - 1)),
+                  head(0), tail(0), overruns(0) {}
+
+        private:
+            uint8_t *storage;
+            const ring_index_t capacity;
+            const ring_index_t mask;
+            AtomicCell<ring_index_t> head; // written by the producer only
+            AtomicCell<ring_index_t> tail; // written by the consumer only
+            AtomicCell<ring_index_t> overruns; // written by the producer only
+
+            ByteRingBuffer(const ByteRingBuffer &) = delete;
+            ByteRingBuffer &operator=(const ByteRingBuffer &) = delete;
+    };
+
+    /**
+     * @brief `ByteRingBuffer` with inline storage.
+     *
+     * @tparam SIZE Capacity in bytes. Must be a power of two, and at most 128 on AVR so the
+     *              indices stay single byte (and therefore ISR safe).
+     *
+     * @example
+     * ```cpp
+     * debuguear::SpscRingBuffer<128> pmsRing;
+     *
+     * void setup() {
+     *     UBRR0 = F_CPU / 16 / 9600 - 1;          // 9600 baud
+     *     UCSR0C = _BV(UCSZ01) | _BV(UCSZ00);      // 8N1
+     *     UCSR0B = _BV(RXEN0) | _BV(RXCIE0);       // receiver and RX complete interrupt
+     * }
+     *
+     * ISR(USART_RX_vect) {
+     *     pmsRing.push(UDR0);
+     * }
+     * ```
+     * The sketch owns USART0 and must not reference `Serial`, whose HardwareSerial also
+     * defines `USART_RX_vect`. Use a second UART (`USART1_RX_vect`, `UDR1`) to keep `Serial`.
+     */
+    template <size_t SIZE>
+    class SpscRingBuffer : public ByteRingBuffer {
+        static_assert(SIZE >= 2 && (SIZE & (SIZE - 1)) == 0, "SpscRingBuffer size must be a power of two");
+        static_assert(SIZE <= AIR_QUALITY_RING_MAX_SIZE, "SpscRingBuffer size is too large for this platform");
+
+        public:
+            SpscRingBuffer() : ByteRingBuffer(buffer, SIZE) {}
+
+        private:
+            uint8_t buffer[SIZE];
+    };
+
+}
+
+#endif
@@ -0,0 +1,239 @@
+#ifndef AIR_QUALITY_SENSOR_CALIBRATION_H
+#define AIR_QUALITY_SENSOR_CALIBRATION_H
+#include "Arduino.h"
+
+namespace debuguear {
+
+    namespace calibration {
+
+        /**
+         * @brief Converts a constant to a fixed-point integer with `bits` fractional bits.
+         *        Meant for compile-time use only.
+         */
+        constexpr int32_t toFixed(double value, uint8_t bits) {
+            return (int32_t)(value * (double)(1UL << bits) + (value < 0 ? -0.5 : 0.5));
+        }
+
+        /**
+         * @brief Multiplies `value` by the Q15 factor `factor` (0 to 2), with rounding.
+         *
+         * Splits `value` so that both partial products fit in 32 bits as long as
+         * `|value| < 2^27`, which every quantity handled here respects.
+         */
+        inline int32_t mulQ15(int32_t value, uint16_t factor) {
+            bool negative = value < 0;
+            uint32_t magnitude = negative ? (uint32_t)-value : (uint32_t)value;
+            uint32_t product = (magnitude >> 15) * factor + (((magnitude & 0x7FFF) * factor + 0x4000) >> 15);
+            return negative ? -(int32_t)product : (int32_t)product;
+        }
+
+        /**
+         * @brief Converts between fixed-point formats, rounding when bits are dropped.
+         */
+        inline int32_t rescale(int32_t value, uint8_t fromBits, uint8_t toBits) {
+            if (toBits >= fromBits) {
+                return value << (toBits - fromBits);
+            }
+            uint8_t shift = fromBits - toBits;
+            return (value + ((int32_t)1 << (shift - 1))) >> shift;
+        }
+
+        /**
+         * @brief Coefficients of the US EPA correction for PMS sensors (Barkjohn et al., 2021,
+         *        with the 2022 extension for smoke), in Q16 unless noted.
+         */
+        struct EpaPm25 {
+            static constexpr uint8_t BITS = 16;
+            static constexpr int32_t SLOPE_LOW = toFixed(0.524, 16);       // below 30 µg/m³
+            static constexpr int32_t SLOPE_MID = toFixed(0.786, 16);       // 50 to 210 µg/m³
+            static constexpr int32_t SLOPE_HIGH = toFixed(0.69, 16);       // from 260 µg/m³
+            static constexpr int32_t OFFSET = toFixed(5.75, 16);
+            static constexpr int32_t OFFSET_HIGH = toFixed(2.966, 16);
+            static constexpr int32_t RH_PER_TENTH_Q20 = toFixed(0.00862, 20); // 0.0862 per %RH
+            static constexpr int32_t QUADRATIC_Q24 = toFixed(8.84e-4, 24);
+            static constexpr uint16_t MAX_INPUT = 1000;                    // top of the sensor range
+        };
+
+        /**
+         * @brief US EPA humidity-corrected PM2.5 in Q16 µg/m³, never negative.
+         *
+         * @param pm25Cf1 The CF=1 PM2.5 reading (`pm25_standard`), which the EPA fit uses.
+         *                Values above 1000 µg/m³ are clamped.
+         * @param rhTenths Relative humidity in 0.1 %RH, clamped to 100 %.
+         */
+        inline int32_t epaPm25Q16(uint16_t pm25Cf1, uint16_t rhTenths) {
+            typedef EpaPm25 E;
+            int32_t x = pm25Cf1 > E::MAX_INPUT ? E::MAX_INPUT : pm25Cf1;
+            int32_t rh = rhTenths > 1000 ? 1000 : rhTenths;
+            int32_t rhTerm = (E::RH_PER_TENTH_Q20 * rh + 0x8) >> 4;
+            // c * x^2: c * x in Q20 stays below 2^20, so the product with x fits in 32 bits.
+            int32_t quadratic = (((E::QUADRATIC_Q24 * x + 8) >> 4) * x + 8) >> 4;
+            int32_t result;
+            if (x < 30) {
+                result = E::SLOPE_LOW * x - rhTerm + E::OFFSET;
+            } else if (x < 50) {
+                int32_t slope = E::SLOPE_LOW + ((E::SLOPE_MID - E::SLOPE_LOW) * (x - 30)) / 20;
+                result = slope * x - rhTerm + E::OFFSET;
+            } else if (x < 210) {
+                result = E::SLOPE_MID * x - rhTerm + E::OFFSET;
+            } else if (x < 260) {
+                // Blend of the middle and high fits, with weight (x - 210) / 50.
+                int32_t n = x - 210;
+                int32_t slope = E::SLOPE_MID + ((E::SLOPE_HIGH - E::SLOPE_MID) * n) / 50;
+                result = slope * x + ((E::OFFSET - rhTerm) * (50 - n) + (E::OFFSET_HIGH + quadratic) * n) / 50;
+            } else {
+                result = E::OFFSET_HIGH + E::SLOPE_HIGH * x + quadratic;
+            }
+            return result < 0 ? 0 : result;
+        }
+
+    }
+
+    /**
+     * @brief Per-device linear correction `gain * value + offset`, see `Calibrator::linear()`.
+     */
+    struct LinearCalibration {
+        uint16_t gainQ15;   // gain in [0, 2)
+        int32_t offset;     // in the calibrator's fixed-point format
+    };
+
+    /**
+     * @brief Calibrated values, fixed-point with the calibrator's `FRACTION_BITS` fractional bits.
+     */
+    struct CalibratedReading {
+        int32_t pm25;           // µg/m³, humidity corrected
+        int32_t temperature;    // °C
+        int32_t humidity;       // %RH
+    };
+
+    /**
+     * @brief Humidity-corrected PM2.5, °C and %RH in integer fixed-point.
+     *
+     * Temperature and humidity are scaled from the sensor tenths and go through their own
+     * device calibration; PM2.5 is corrected with the US EPA fit for PMS sensors using the
+     * calibrated humidity, then goes through its device calibration. Everything is integer
+     * math with constant coefficients folded at compile time, so AVR boards avoid the
+     * software floating point.
+     *
+     * @tparam FRAC_BITS Fractional bits of the results, up to 16. The default 8 gives a
+     *                   resolution of 0.004.
+     *
+     * @example
+     * ```cpp
+     * typedef debuguear::Calibrator<8> Calibrator;
+     * const Calibrator calibrator(Calibrator::linear(0.97, 0.4));   // from a co-location
+     *
+     * void observerFunction(debuguear::AirQualityModel_PMS5003T *data) {
+     *     debuguear::CalibratedReading cal = calibrator.calibrate(*data);
+     *     uint8_t n = debuguear::format::formatFixed(Calibrator::toDecimal(cal.pm25, 1), 1, buf);   // "12.3"
+     * }
+     * ```
+     */
+    template <uint8_t FRAC_BITS = 8>
+    class Calibrator {
+        static_assert(FRAC_BITS <= 16, "At most 16 fractional bits keep the intermediate values in 32 bits");
+
+        public:
+            static constexpr uint8_t FRACTION_BITS = FRAC_BITS;
+
+            /**
+             * @brief Builds a device calibration at compile time.
+             *
+             * @param gain Multiplier, in [0, 2).
+             * @param offset Added after the gain, in the unit of the calibrated value.
+             */
+            static constexpr LinearCalibration linear(double gain, double offset) {
+                return LinearCalibration{(uint16_t)calibration::toFixed(gain, 15), calibration::toFixed(offset, FRAC_BITS)};
+            }
+
+            static constexpr LinearCalibration identity() {
+                return linear(1.0, 0.0);
+            }
+
+            explicit Calibrator(LinearCalibration pm25 = identity(), LinearCalibration temperature = identity(),
+                                LinearCalibration humidity = identity())
+                : pm25Calibration(pm25), temperatureCalibration(temperature), humidityCalibration(humidity) {}
+
+            /**
+             * @brief Calibrates a reading of a model with `temperature` and `humedity` fields.
+             */
+            template <typename Model>
+            CalibratedReading calibrate(const Model &data) const {
+                CalibratedReading result;
+                result.temperature = this->temperature(data.temperature);
+                result.humidity = this->humidity(data.humedity);
+                result.pm25 = this->pm25(data.pm25_standard, result.humidity);
+                return result;
+            }
+
+            /**
+             * @brief Calibrated temperature from the sensor value in 0.1 °C.
+             */
+            int32_t temperature(int16_t tenths) const {
+                return this->apply(fromTenths(tenths), temperatureCalibration);
+            }
+
+            /**
+             * @brief Calibrated relative humidity from the sensor value in 0.1 %RH.
+             */
+            int32_t humidity(uint16_t tenths) const {
+                return this->apply(fromTenths(tenths > 1000 ? 1000 : (int16_t)tenths), humidityCalibration);
+            }
+
+            /**
+             * @brief Corrected PM2.5 from the CF=1 reading and a calibrated humidity.
+             */
+            int32_t pm25(uint16_t pm25Cf1, int32_t humidity) const {
+                int32_t rhTenths = toDecimal(humidity, 1);
+                rhTenths = rhTenths < 0 ? 0 : rhTenths;
+                int32_t corrected = calibration::rescale(calibration::epaPm25Q16(pm25Cf1, (uint16_t)rhTenths),
+                                                         calibration::EpaPm25::BITS, FRAC_BITS);
+                return this->apply(corrected, pm25Calibration);
+            }
+
+            /**
+             * @brief Rounds a fixed-point value to an integer with `decimals` decimal places,
+             *        e.g. 12.34 with 1 decimal gives 123 (for `format::formatFixed`).
+             */
+            static int32_t toDecimal(int32_t value, uint8_t decimals) {
+                int32_t scale = 1;
+                for (uint8_t i = 0; i < decimals; ++i) {
+                    scale *= 10;
+                }
+                bool negative = value < 0;
+                uint32_t magnitude = negative ? (uint32_t)-value : (uint32_t)value;
+                uint32_t mask = ((uint32_t)1 << FRAC_BITS) - 1;
+                uint32_t fraction = FRAC_BITS != 0 ? ((magnitude & mask) * (uint32_t)scale + (mask + 1) / 2) >> FRAC_BITS : 0;
+                int32_t result = (int32_t)((magnitude >> FRAC_BITS) * (uint32_t)scale + fraction);
+                return negative ? -result : result;
+            }
+
+        private:
+            // x / 10 as (x * 2^22 / 10) >> (22 - FRAC_BITS), exact to 1e-6 over the clamped range.
+            static constexpr uint32_t TENTH_Q22 = (uint32_t)calibration::toFixed(0.1, 22);
+            static constexpr int16_t MAX_TENTHS = 5000;
+
+            /**
+             * @brief Sensor tenths to fixed-point, clamped to ±500 units.
+             */
+            static int32_t fromTenths(int16_t tenths) {
+                bool negative = tenths < 0;
+                uint32_t magnitude = negative ? (uint32_t)-(int32_t)tenths : (uint32_t)tenths;
+                magnitude = magnitude > (uint32_t)MAX_TENTHS ? (uint32_t)MAX_TENTHS : magnitude;
+                uint8_t shift = 22 - FRAC_BITS;
+                int32_t value = (int32_t)((magnitude * TENTH_Q22 + ((uint32_t)1 << (shift - 1))) >> shift);
+                return negative ? -value : value;
+            }
+
+            int32_t apply(int32_t value, const LinearCalibration &coefficients) const {
+                return calibration::mulQ15(value, coefficients.gainQ15) + coefficients.offset;
+            }
+
+            LinearCalibration pm25Calibration;
+            LinearCalibration temperatureCalibration;
+            LinearCalibration humidityCalibration;
+    };
+
+}
+
+#endif
@@ -0,0 +1,162 @@
+#ifndef AIR_QUALITY_SENSOR_DEADBAND_FILTER_H
+#define AIR_QUALITY_SENSOR_DEADBAND_FILTER_H
+#include "Arduino.h"
+#include "FrameScan.h"
+
+namespace debuguear {
+
+    /**
+     * @brief Per-field deadband deciding which frames are worth notifying.
+     *
+     * A frame passes when one of its data words moved away from the last notified frame by more
+     * than that word's band, `max(absolute, |reference| * relativePercent / 100)`, or when nothing
+     * was notified for `maxSilenceMs` (heartbeat). Words are compared straight from the raw
+     * frame, before decoding, so a suppressed frame costs neither a model decode nor a copy; a
+     * frame identical to the reference is rejected by a single `memcmp`. Words holding a signed
+     * field, such as the PMS5003T temperature, are compared as signed values.
+     *
+     * By default every word has a zero band, i.e. any change passes and only repeated frames are
+     * dropped.
+     *
+     * @tparam Layout The `FrameLayout` of the processor the filter is attached to.
+     *
+     * @example
+     * ```cpp
+     * debuguear::DeadbandFilter<debuguear::LayoutPMS5003T> deadband(60000);
+     *
+     * void setup() {
+     *     deadband.setAll(2, 10);                                          // ±2 or ±10 %
+     *     deadband.ignore(&debuguear::AirQualityModel_PMS5003T::particles_03um);
+     *     processor.setDeadband(&deadband);
+     * }
+     * ```
+     */
+    template <typename Layout>
+    class DeadbandFilter {
+        public:
+            typedef typename Layout::Model Model;
+
+            /**
+             * @param maxSilenceMs Longest time without a notification; 0 disables the heartbeat.
+             */
+            explicit DeadbandFilter(unsigned long maxSilenceMs = 0)
+                : maxSilenceMs(maxSilenceMs), lastPassAt(0), hasReference(false), suppressedCount(0) {
+                this->setAll(0, 0);
+            }
+
+            /**
+             * @brief Sets the band of one model field.
+             *
+             * @param member The model field, e.g. `&AirQualityModel_PMS5003T::pm25_env`.
+             * @param absolute Changes up to this many raw units are ignored.
+             * @param relativePercent Changes up to this percentage of the reference are ignored.
+             *
+             * @return `false` if the layout does not map `member`.
+             */
+            template <typename T>
+            bool set(T Model::*member, uint16_t absolute, uint8_t relativePercent = 0) {
+                int8_t word = Layout::wordOf(member);
+                if (word < 0) {
+                    return false;
+                }
+                this->absolute[word] = absolute;
+                this->relative[word] = relativePercent;
+                return true;
+            }
+
+            /**
+             * @brief Sets the same band on every data word.
+             */
+            void setAll(uint16_t absolute, uint8_t relativePercent = 0) {
+                for (uint8_t i = 0; i < WORDS; ++i) {
+                    this->absolute[i] = absolute;
+                    this->relative[i] = relativePercent;
+                }
+            }
+
+            /**
+             * @brief Changes of `member` alone never pass the filter.
+             */
+            template <typename T>
+            bool ignore(T Model::*member) {
+                return this->set(member, 0xFFFF, 0);
+            }
+
+            void setMaxSilence(unsigned long maxSilenceMs) {
+                this->maxSilenceMs = maxSilenceMs;
+            }
+
+            /**
+             * @brief Decides whether a validated frame is notified.
+             *
+             * A frame that passes becomes the new reference.
+             *
+             * @param frame A complete frame whose header, length and checksum were checked.
+             * @param nowMs Current time, for the heartbeat.
+             */
+            bool accept(const uint8_t *frame, unsigned long nowMs) {
+                const uint8_t *payload = frame + 4;
+                bool pass = !this->hasReference ||
+                            (this->maxSilenceMs != 0 && (unsigned long)(nowMs - this->lastPassAt) >= this->maxSilenceMs);
+
+                if (!pass && memcmp(payload, this->reference, sizeof(this->reference)) != 0) {
+                    for (uint8_t i = 0; i < WORDS; ++i) {
+                        int32_t value = wordAt(payload, i);
+                        int32_t previous = wordAt(this->reference, i);
+                        uint32_t delta = (uint32_t)(value > previous ? value - previous : previous - value);
+                        uint32_t magnitude = (uint32_t)(previous < 0 ? -previous : previous);
+                        uint32_t band = magnitude * this->relative[i] / 100;
+                        if (band < this->absolute[i]) {
+                            band = this->absolute[i];
+                        }
+                        if (delta > band) {
+                            pass = true;
+                            break;
+                        }
+                    }
+                }
+
+                if (!pass) {
+                    this->suppressedCount++;
+                    return false;
+                }
+                memcpy(this->reference, payload, sizeof(this->reference));
+                this->lastPassAt = nowMs;
+                this->hasReference = true;
+                return true;
+            }
+
+            /**
+             * @brief Forgets the reference, so the next frame passes.
+             */
+            void reset() {
+                this->hasReference = false;
+            }
+
+            /**
+             * @brief Number of frames dropped by the filter.
+             */
+            uint32_t suppressed() const {
+                return suppressedCount;
+            }
+
+        private:
+            static constexpr uint8_t WORDS = Layout::DATA_WORDS_N;
+
+            static int32_t wordAt(const uint8_t *payload, uint8_t word) {
+                uint16_t raw = loadBigEndian16(&payload[word * 2]);
+                return (Layout::SIGNED_WORDS >> word) & 1 ? (int32_t)(int16_t)raw : (int32_t)raw;
+            }
+
+            uint16_t absolute[WORDS];
+            uint8_t relative[WORDS];
+            uint8_t reference[WORDS * 2];
+            unsigned long maxSilenceMs;
+            unsigned long lastPassAt;
+            bool hasReference;
+            uint32_t suppressedCount;
+    };
+
+}
+
+#endif
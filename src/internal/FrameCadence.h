@@ -0,0 +1,205 @@
+#ifndef AIR_QUALITY_SENSOR_FRAME_CADENCE_H
+#define AIR_QUALITY_SENSOR_FRAME_CADENCE_H
+#include "Arduino.h"
+
+#if defined(__AVR__)
+    #include <avr/sleep.h>
+#elif defined(ESP_PLATFORM) || defined(ARDUINO_ARCH_ESP32)
+    #include "esp_sleep.h"
+#endif
+
+namespace debuguear {
+
+    /**
+     * @brief Learns the interval between the data frames of a sensor in active mode, and
+     *        predicts when the next one arrives.
+     *
+     * PMS sensors send a frame every 200 to 800 ms while the readings move, and about every
+     * 2.3 s once they are stable. The interval is an exponential average (gain 1/8) of the
+     * observed gaps, in 1/16 ms; gaps of a whole number of intervals count as frames the
+     * parser missed (a corrupted frame) and do not disturb it. A gap off by more than a
+     * quarter of the interval means the sensor changed its pace, and learning starts over.
+     *
+     * Arrivals are only as precise as the polling: each one comes with the time since the
+     * previous poll, and an arrival known to less than an eighth of the interval only moves
+     * the phase of the prediction, not the interval.
+     */
+    class FrameCadence {
+        public:
+            static constexpr uint8_t MIN_SAMPLES = 3;   // intervals needed before predicting
+
+            FrameCadence() {
+                this->reset();
+            }
+
+            void reset() {
+                this->lastArrival = 0;
+                this->interval16 = 0;
+                this->deviation16 = 0;
+                this->missedCount = 0;
+                this->samples = 0;
+                this->hasArrival = false;
+            }
+
+            /**
+             * @brief Records a frame found by a poll.
+             *
+             * @param arrivalMs `millis()` when the frame was found.
+             * @param uncertaintyMs Time since the previous poll: the frame was completed
+             *                      somewhere in between.
+             */
+            void recordArrival(unsigned long arrivalMs, unsigned long uncertaintyMs) {
+                if (!this->hasArrival) {
+                    this->lastArrival = arrivalMs;
+                    this->hasArrival = true;
+                    return;
+                }
+                uint32_t delta = (uint32_t)(arrivalMs - this->lastArrival);
+                this->lastArrival = arrivalMs;
+                if (delta == 0) {
+                    return;
+                }
+                bool precise = (uint32_t)uncertaintyMs * 8 <= delta;
+                if (this->samples == 0) {
+                    this->seed(delta, precise);
+                    return;
+                }
+
+                uint32_t interval = this->intervalMs();
+                uint32_t frames = (delta + interval / 2) / interval;
+                if (frames == 0) {
+                    frames = 1;
+                }
+                uint32_t sample = delta / frames;
+                uint32_t error = sample > interval ? sample - interval : interval - sample;
+                if (error > interval / 4) {
+                    this->seed(delta, precise);
+                    return;
+                }
+                this->missedCount += frames - 1;
+                if ((uint32_t)uncertaintyMs * 8 > interval) {
+                    return;
+                }
+
+                int32_t error16 = (int32_t)(sample << 4) - (int32_t)this->interval16;
+                this->interval16 = (uint32_t)((int32_t)this->interval16 + error16 / 8);
+                uint32_t absError16 = error16 < 0 ? (uint32_t)-error16 : (uint32_t)error16;
+                this->deviation16 = (uint32_t)((int32_t)this->deviation16 + ((int32_t)absError16 - (int32_t)this->deviation16) / 4);
+                if (this->samples < 0xFF) {
+                    this->samples++;
+                }
+            }
+
+            /**
+             * @return `true` once enough intervals were observed to predict the next frame.
+             */
+            bool isLocked() const {
+                return this->samples >= MIN_SAMPLES;
+            }
+
+            uint32_t intervalMs() const {
+                return (this->interval16 + 8) >> 4;
+            }
+
+            /**
+             * @brief Mean deviation of the observed intervals from the learned one.
+             */
+            uint32_t jitterMs() const {
+                return (this->deviation16 + 8) >> 4;
+            }
+
+            /**
+             * @brief Frames inferred from gaps of several intervals, since the last `reset()`.
+             */
+            uint32_t missedFrames() const {
+                return this->missedCount;
+            }
+
+            /**
+             * @brief `millis()` time the next frame is expected at.
+             *
+             * When a frame is more than half an interval late, the prediction moves on to the
+             * next one of the same cadence. Without a lock, `nowMs`.
+             */
+            unsigned long nextExpectedAt(unsigned long nowMs) const {
+                if (!this->isLocked()) {
+                    return nowMs;
+                }
+                uint32_t interval = this->intervalMs();
+                unsigned long expected = this->lastArrival + interval;
+                long late = (long)(nowMs - expected);
+                if (late > (long)(interval / 2)) {
+                    expected += ((uint32_t)late + interval / 2) / interval * interval;
+                }
+                return expected;
+            }
+
+            /**
+             * @return Milliseconds until `nextExpectedAt()`, 0 when it is due or without a lock.
+             */
+            unsigned long msUntilNext(unsigned long nowMs) const {
+                long remaining = (long)(this->nextExpectedAt(nowMs) - nowMs);
+                return remaining > 0 ? (unsigned long)remaining : 0;
+            }
+
+        private:
+            unsigned long lastArrival;
+            uint32_t interval16;
+            uint32_t deviation16;
+            uint32_t missedCount;
+            uint8_t samples;
+            bool hasArrival;
+
+            void seed(uint32_t delta, bool precise) {
+                this->interval16 = precise ? delta << 4 : 0;
+                this->deviation16 = 0;
+                this->samples = precise ? 1 : 0;
+            }
+    };
+
+    typedef void (*FrameSleepFn)(unsigned long ms);
+
+    /**
+     * Sleep functions for `AirQualitySensor::sleepUntilNextFrame()`.
+     */
+    namespace cadence {
+
+        /**
+         * @brief `delay()`: no power saving by itself, but yields to the RTOS on ESP32 and
+         *        follows the virtual clock of the native shim.
+         */
+        inline void delaySleep(unsigned long ms) {
+            delay(ms);
+        }
+
+#if defined(__AVR__)
+        /**
+         * @brief AVR idle mode: the CPU clock stops until the next interrupt, the millis
+         *        timer waking it up every millisecond. The UART keeps receiving.
+         */
+        inline void idleSleep(unsigned long ms) {
+            unsigned long start = millis();
+            set_sleep_mode(SLEEP_MODE_IDLE);
+            while (millis() - start < ms) {
+                sleep_mode();
+            }
+        }
+#elif defined(ESP_PLATFORM) || defined(ARDUINO_ARCH_ESP32)
+        /**
+         * @brief ESP32 light sleep with a timer wake-up.
+         *
+         * Unlike the other two, the UART is clock gated: bytes arriving during the sleep are
+         * lost. `sleepUntilNextFrame()` only calls it for sleeps that end, jitter included,
+         * before the next frame starts, and naps with `delay()` otherwise.
+         */
+        inline void lightSleep(unsigned long ms) {
+            esp_sleep_enable_timer_wakeup((uint64_t)ms * 1000);
+            esp_light_sleep_start();
+        }
+#endif
+
+    }
+
+}
+
+#endif
@@ -0,0 +1,161 @@
+#ifndef AIR_QUALITY_SENSOR_FRAME_LAYOUT_H
+#define AIR_QUALITY_SENSOR_FRAME_LAYOUT_H
+#include "Arduino.h"
+#include "FrameScan.h"
+
+namespace debuguear {
+
+    /**
+     * @brief Maps one big-endian data word of a frame onto a field of the model.
+     *
+     * @tparam Model The data model receiving the value.
+     * @tparam FieldT The type of the model field.
+     * @tparam Member Pointer to the model field.
+     * @tparam WORD Index of the data word, counted from the first word after the length field.
+     */
+    template <typename Model, typename FieldT, FieldT Model::*Member, uint8_t WORD>
+    struct FrameField {
+        static constexpr uint8_t word = WORD;
+        // Signed fields (the PMS5003T temperature) are two's complement on the wire.
+        static constexpr bool isSigned = (FieldT)-1 < (FieldT)0;
+
+        static void decode(const uint8_t *data, Model *dst) {
+            dst->*Member = (FieldT)loadBigEndian16(&data[WORD * 2]);
+        }
+
+        static void toWords(const Model *src, uint16_t *words) {
+            words[WORD] = (uint16_t)(src->*Member);
+        }
+
+        static void fromWords(const uint16_t *words, Model *dst) {
+            dst->*Member = (FieldT)words[WORD];
+        }
+
+        template <typename T>
+        static bool is(T Model::*) {
+            return false;
+        }
+
+        static bool is(FieldT Model::*member) {
+            return member == Member;
+        }
+    };
+
+    /**
+     * @brief Compile-time list of `FrameField`s. `decode` expands into one load and store per field.
+     */
+    template <typename Model, typename... Fields>
+    struct FrameFieldList;
+
+    template <typename Model>
+    struct FrameFieldList<Model> {
+        static constexpr uint8_t maxWord = 0;
+        static constexpr uint32_t signedWords = 0;
+
+        static void decode(const uint8_t *, Model *) {}
+        static void toWords(const Model *, uint16_t *) {}
+        static void fromWords(const uint16_t *, Model *) {}
+
+        template <typename T>
+        static int8_t wordOf(T Model::*) {
+            return -1;
+        }
+    };
+
+    template <typename Model, typename Field, typename... Rest>
+    struct FrameFieldList<Model, Field, Rest...> {
+        static constexpr uint8_t maxWord = Field::word > FrameFieldList<Model, Rest...>::maxWord
+            ? Field::word : FrameFieldList<Model, Rest...>::maxWord;
+        static constexpr uint32_t signedWords = (Field::isSigned ? (uint32_t)1 << Field::word : 0) |
+                                                FrameFieldList<Model, Rest...>::signedWords;
+
+        static void decode(const uint8_t *data, Model *dst) {
+            Field::decode(data, dst);
+            FrameFieldList<Model, Rest...>::decode(data, dst);
+        }
+
+        static void toWords(const Model *src, uint16_t *words) {
+            Field::toWords(src, words);
+            FrameFieldList<Model, Rest...>::toWords(src, words);
+        }
+
+        static void fromWords(const uint16_t *words, Model *dst) {
+            Field::fromWords(words, dst);
+            FrameFieldList<Model, Rest...>::fromWords(words, dst);
+        }
+
+        template <typename T>
+        static int8_t wordOf(T Model::*member) {
+            return Field::is(member) ? (int8_t)Field::word : FrameFieldList<Model, Rest...>::wordOf(member);
+        }
+    };
+
+    /**
+     * @brief Describes a PMS frame: its size and where each model field lives in it.
+     *
+     * PMS frames are laid out as `0x42 0x4D lenH lenL data[DATA_WORDS] chkH chkL`, where the
+     * length counts the data words plus the checksum. Everything the processor needs to know
+     * about a sensor is derived from this descriptor at compile time, so decoding a frame is
+     * straight-line code writing into the model.
+     *
+     * @tparam ModelT The data model produced by the sensor.
+     * @tparam DATA_WORDS Number of 16-bit data words in the frame.
+     * @tparam Fields A `FrameFieldList` mapping data words onto model fields.
+     */
+    template <typename ModelT, uint8_t DATA_WORDS, typename Fields>
+    struct FrameLayout {
+        typedef ModelT Model;
+
+        static constexpr uint8_t DATA_WORDS_N = DATA_WORDS;
+        static constexpr uint16_t DATA_LENGTH = DATA_WORDS * 2 + 2;
+        static constexpr uint8_t FRAME_LENGTH = 4 + DATA_LENGTH;
+        // Bit `i` is set when data word `i` holds a signed field.
+        static constexpr uint32_t SIGNED_WORDS = Fields::signedWords;
+
+        static_assert(Fields::maxWord < DATA_WORDS, "Frame field mapped outside of the data words");
+        static_assert(DATA_WORDS <= 32, "SIGNED_WORDS holds one bit per data word");
+
+        /**
+         * @brief Decodes a validated frame into `dst`.
+         * @param frame Pointer to the first header byte of the frame.
+         */
+        static void decode(const uint8_t *frame, Model *dst) {
+            Fields::decode(&frame[4], dst);
+        }
+
+        /**
+         * @brief Writes the model back as the `DATA_WORDS` data words it was decoded from.
+         *        Words not mapped by the layout are set to zero.
+         */
+        static void toWords(const Model *src, uint16_t *words) {
+            for (uint8_t i = 0; i < DATA_WORDS; ++i) {
+                words[i] = 0;
+            }
+            Fields::toWords(src, words);
+        }
+
+        /**
+         * @brief Inverse of `toWords`: fills the mapped model fields from `DATA_WORDS` data words.
+         */
+        static void fromWords(const uint16_t *words, Model *dst) {
+            Fields::fromWords(words, dst);
+        }
+
+        /**
+         * @brief Index of the data word holding `member`, or -1 if the layout does not map it.
+         */
+        template <typename T>
+        static int8_t wordOf(T Model::*member) {
+            return Fields::wordOf(member);
+        }
+    };
+
+}
+
+/**
+ * @brief Shorthand for a `FrameField` of `Model::member` located at data word `word`.
+ */
+#define PMS_FRAME_FIELD(Model, member, word) \
+    ::debuguear::FrameField<Model, decltype(Model::member), &Model::member, word>
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef AIR_QUALITY_SENSOR_FRAME_SCAN_H
+#define AIR_QUALITY_SENSOR_FRAME_SCAN_H
+#include "Arduino.h"
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+namespace debuguear {
+
+    /**
+     * @brief Reads a big-endian 16-bit word. Compilers lower this to a load plus byte swap.
+     */
+    inline uint16_t loadBigEndian16(const uint8_t *p) {
+        return (uint16_t)(((uint16_t)p[0] << 8) | p[1]);
+    }
+
+    /**
+     * @brief Sums `length` bytes modulo 2^16, as the PMS frame checksum does.
+     *
+     * Uses `psadbw` on SSE2 hosts and 64-bit SWAR lanes on other 32/64-bit targets.
+     * AVR keeps the plain byte loop, which is already the cheapest option there.
+     */
+    inline uint16_t sumFrameBytes(const uint8_t *p, size_t length) {
+        uint32_t sum = 0;
+#if defined(__SSE2__)
+        __m128i zero = _mm_setzero_si128();
+        __m128i acc = zero;
+        while (length >= 16) {
+            acc = _mm_add_epi64(acc, _mm_sad_epu8(_mm_loadu_si128((const __m128i *)p), zero));
+            p += 16;
+            length -= 16;
+        }
+        sum += (uint32_t)_mm_cvtsi128_si32(acc) + (uint32_t)_mm_cvtsi128_si32(_mm_srli_si128(acc, 8));
+#endif
+#if !defined(__AVR__)
+        while (length >= 8) {
+            uint64_t x;
+            memcpy(&x, p, sizeof(x));
+            // Fold bytes into four 16-bit lanes, then add the lanes with one multiply.
+            x = (x & 0x00FF00FF00FF00FFULL) + ((x >> 8) & 0x00FF00FF00FF00FFULL);
+            sum += (uint32_t)((x * 0x0001000100010001ULL) >> 48);
+            p += 8;
+            length -= 8;
+        }
+#endif
+        while (length--) {
+            sum += *p++;
+        }
+        return (uint16_t)sum;
+    }
+
+    /**
+     * @brief Finds the next frame header candidate in `[p, end)`.
+     *
+     * @return A pointer to the first `first` byte followed by `second`, or to a `first` byte
+     *         sitting at the very end of the range (the header may continue in the next buffer).
+     *         `nullptr` when there is no candidate at all.
+     */
+    inline const uint8_t *findFrameHeader(const uint8_t *p, const uint8_t *end, uint8_t first, uint8_t second) {
+        while (p < end) {
+            p = (const uint8_t *)memchr(p, first, (size_t)(end - p));
+            if (p == nullptr) {
+                return nullptr;
+            }
+            if (p + 1 == end || p[1] == second) {
+                return p;
+            }
+            ++p;
+        }
+        return nullptr;
+    }
+
+}
+
+#endif
@@ -0,0 +1,306 @@
+#ifndef AIR_QUALITY_SENSOR_LINUX_SERIAL_H
+#define AIR_QUALITY_SENSOR_LINUX_SERIAL_H
+#include "Arduino.h"
+#include "AirQualityPMSProcessor.h"
+#include "ByteRingBuffer.h"
+
+#if !defined(__linux__)
+    #error "LinuxSerial.h needs Linux (termios and epoll)"
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace debuguear {
+
+    /**
+     * @brief A `/dev/tty*` serial port opened raw, 8N1 and non-blocking, for gateways running
+     *        the parser natively (Raspberry Pi and USB-serial adapters).
+     *
+     * Bytes are read by `LinuxSerialHub` straight into the ring buffer of a processor. The
+     * port is also a `Print`, to be passed as the processor's command sink.
+     */
+    class LinuxSerialPort : public Print {
+        public:
+            LinuxSerialPort() : fd(-1) {}
+
+            ~LinuxSerialPort() {
+                this->close();
+            }
+
+            /**
+             * @brief Opens and configures the port; an already open one is closed first.
+             *
+             * @return `false` on failure, with `errno` set (`EINVAL` for an unsupported baud rate).
+             */
+            bool open(const char *path, uint32_t baud = 9600) {
+                this->close();
+                speed_t speed;
+                if (!speedOf(baud, &speed)) {
+                    errno = EINVAL;
+                    return false;
+                }
+                int handle = ::open(path, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+                if (handle < 0) {
+                    return false;
+                }
+                struct termios tio;
+                if (tcgetattr(handle, &tio) != 0) {
+                    return failClose(handle);
+                }
+                cfmakeraw(&tio);
+                tio.c_cflag |= CLOCAL | CREAD;
+                tio.c_cflag &= ~(CSTOPB | CRTSCTS);
+                tio.c_cc[VMIN] = 0;
+                tio.c_cc[VTIME] = 0;
+                if (cfsetispeed(&tio, speed) != 0 || cfsetospeed(&tio, speed) != 0 ||
+                    tcsetattr(handle, TCSANOW, &tio) != 0) {
+                    return failClose(handle);
+                }
+                tcflush(handle, TCIFLUSH);
+                this->fd = handle;
+                return true;
+            }
+
+            void close() {
+                if (this->fd >= 0) {
+                    ::close(this->fd);
+                    this->fd = -1;
+                }
+            }
+
+            bool isOpen() const {
+                return this->fd >= 0;
+            }
+
+            int handle() const {
+                return this->fd;
+            }
+
+            size_t write(uint8_t c) override {
+                return this->write(&c, 1);
+            }
+
+            /**
+             * @brief Non-blocking write, e.g. of a 7-byte sensor command.
+             *
+             * @return The number of bytes written, 0 if the port is closed or its buffer full.
+             */
+            size_t write(const uint8_t *buffer, size_t size) override {
+                if (this->fd < 0) {
+                    return 0;
+                }
+                ssize_t written = ::write(this->fd, buffer, size);
+                return written > 0 ? (size_t)written : 0;
+            }
+
+            using Print::write;
+
+        private:
+            int fd;
+
+            static bool failClose(int handle) {
+                int error = errno;
+                ::close(handle);
+                errno = error;
+                return false;
+            }
+
+            static bool speedOf(uint32_t baud, speed_t *speed) {
+                switch (baud) {
+                    case 1200: *speed = B1200; return true;
+                    case 2400: *speed = B2400; return true;
+                    case 4800: *speed = B4800; return true;
+                    case 9600: *speed = B9600; return true;
+                    case 19200: *speed = B19200; return true;
+                    case 38400: *speed = B38400; return true;
+                    case 57600: *speed = B57600; return true;
+                    case 115200: *speed = B115200; return true;
+                    default: return false;
+                }
+            }
+
+            LinuxSerialPort(const LinuxSerialPort &) = delete;
+            LinuxSerialPort &operator=(const LinuxSerialPort &) = delete;
+    };
+
+    /**
+     * @brief Serves many serial sensors from one thread with a single `epoll_wait`.
+     *
+     * Each sensor is a `LinuxSerialPort`, a ring buffer and a processor built on that ring.
+     * When a port becomes readable, the hub `read(2)`s as much as fits straight into the
+     * ring storage and has the processor parse the frames in place: no `Stream`, and no
+     * virtual call per byte or per chunk. The work per wake-up only depends on the ports
+     * that are ready, so the CPU per sensor stays flat as ports are added.
+     *
+     * A port that hangs up (USB adapter unplugged) is closed and left out of later waits;
+     * reopen and `add()` it again to resume.
+     *
+     * @tparam MAX_PORTS Maximum number of ports.
+     *
+     * @example
+     * ```cpp
+     * debuguear::LinuxSerialPort port;
+     * debuguear::SpscRingBuffer<1024> ring;
+     * debuguear::PMS5003T_FULL_PROCESSOR_T sensor(ring, 1, &port);
+     * debuguear::LinuxSerialHub<16> hub;
+     *
+     * port.open("/dev/ttyUSB0");
+     * sensor.addObserver(publish, &port);     // and so on for every sensor
+     * hub.add(port, ring, sensor);
+     * while (hub.run(-1) >= 0 || errno == EINTR) {
+     * }
+     * ```
+     */
+    template <uint8_t MAX_PORTS>
+    class LinuxSerialHub {
+        public:
+            LinuxSerialHub() : epollFd(::epoll_create1(EPOLL_CLOEXEC)), count(0), bytesCount(0) {}
+
+            ~LinuxSerialHub() {
+                if (this->epollFd >= 0) {
+                    ::close(this->epollFd);
+                }
+            }
+
+            /**
+             * @return `false` if the epoll instance could not be created.
+             */
+            bool isValid() const {
+                return this->epollFd >= 0;
+            }
+
+            /**
+             * @brief Registers an open port and the processor fed from `ring`. All three must
+             *        outlive the hub, and `ring` must be the one `sensor` was built on.
+             *
+             * @return `false` if `MAX_PORTS` ports are registered, the port is closed, or
+             *         `epoll_ctl` failed (e.g. `EEXIST`: the port is already being served).
+             */
+            template <typename Layout, uint8_t MAX_OBSERVERS, uint8_t FEATURES>
+            bool add(LinuxSerialPort &port, ByteRingBuffer &ring, AirQualitySensor<Layout, MAX_OBSERVERS, FEATURES> &sensor) {
+                typedef AirQualitySensor<Layout, MAX_OBSERVERS, FEATURES> Sensor;
+                // A port closed after a hang-up gets its slot back.
+                uint8_t slot = 0;
+                while (slot < this->count && this->ports[slot].port != &port) {
+                    slot++;
+                }
+                if (slot >= MAX_PORTS || !port.isOpen() || !this->isValid()) {
+                    return false;
+                }
+                struct epoll_event event;
+                memset(&event, 0, sizeof(event));
+                event.events = EPOLLIN;
+                event.data.u32 = slot;
+                if (::epoll_ctl(this->epollFd, EPOLL_CTL_ADD, port.handle(), &event) != 0) {
+                    return false;
+                }
+                if (slot == this->count) {
+                    this->count++;
+                }
+                Entry &entry = this->ports[slot];
+                entry.port = &port;
+                entry.ring = &ring;
+                entry.sensor = &sensor;
+                entry.poll = &LinuxSerialHub::pollThunk<Sensor>;
+                return true;
+            }
+
+            /**
+             * @brief Waits up to `timeoutMs` (-1: forever) for any port to become readable, then
+             *        serves every ready port.
+             *
+             * @return The number of ports served, 0 on timeout, -1 if `epoll_wait` failed
+             *         (`errno` is set; `EINTR` just means a signal arrived).
+             */
+            int run(int timeoutMs) {
+                struct epoll_event events[MAX_PORTS];
+                int ready = ::epoll_wait(this->epollFd, events, MAX_PORTS, timeoutMs);
+                if (ready < 0) {
+                    return -1;
+                }
+                for (int i = 0; i < ready; ++i) {
+                    Entry &entry = this->ports[events[i].data.u32];
+                    if (!this->serve(entry) || (events[i].events & (EPOLLHUP | EPOLLERR)) != 0) {
+                        ::epoll_ctl(this->epollFd, EPOLL_CTL_DEL, entry.port->handle(), nullptr);
+                        entry.port->close();
+                    }
+                }
+                return ready;
+            }
+
+            uint8_t size() const {
+                return this->count;
+            }
+
+            /**
+             * @brief Bytes read from all ports since construction.
+             */
+            uint64_t bytesRead() const {
+                return this->bytesCount;
+            }
+
+        private:
+            struct Entry {
+                LinuxSerialPort *port;
+                ByteRingBuffer *ring;
+                void *sensor;
+                size_t (*poll)(void *sensor, size_t maxBytes);
+            };
+
+            template <typename Sensor>
+            static size_t pollThunk(void *sensor, size_t maxBytes) {
+                return static_cast<Sensor *>(sensor)->poll(maxBytes);
+            }
+
+            /**
+             * @brief Reads a ready port until it has nothing left, parsing whenever the ring fills.
+             *
+             * @return `false` if a read failed.
+             */
+            bool serve(Entry &entry) {
+                bool alive = true;
+                while (true) {
+                    size_t room;
+                    uint8_t *dst = entry.ring->writable(room);
+                    if (room == 0) {
+                        entry.poll(entry.sensor, (size_t)-1);
+                        dst = entry.ring->writable(room);
+                        if (room == 0) {
+                            break;
+                        }
+                    }
+                    ssize_t received = ::read(entry.port->handle(), dst, room);
+                    if (received > 0) {
+                        entry.ring->commit((size_t)received);
+                        this->bytesCount += (size_t)received;
+                        if ((size_t)received < room) {
+                            break;
+                        }
+                        continue;
+                    }
+                    if (received < 0 && errno == EINTR) {
+                        continue;
+                    }
+                    alive = received == 0 || errno == EAGAIN || errno == EWOULDBLOCK;
+                    break;
+                }
+                entry.poll(entry.sensor, (size_t)-1);
+                return alive;
+            }
+
+            Entry ports[MAX_PORTS];
+            int epollFd;
+            uint8_t count;
+            uint64_t bytesCount;
+
+            LinuxSerialHub(const LinuxSerialHub &) = delete;
+            LinuxSerialHub &operator=(const LinuxSerialHub &) = delete;
+    };
+
+}
+
+#endif
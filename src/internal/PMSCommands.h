@@ -0,0 +1,40 @@
+#ifndef AIR_QUALITY_SENSOR_PMS_COMMANDS_H
+#define AIR_QUALITY_SENSOR_PMS_COMMANDS_H
+#include "Arduino.h"
+
+namespace debuguear {
+
+    /**
+     * @brief Host to sensor commands of the PMS protocol.
+     *
+     * Commands are sent as `0x42 0x4D cmd dataH dataL chkH chkL`, the checksum being the sum
+     * of the five previous bytes. Mode and sleep changes are acknowledged with the 8-byte frame
+     * `0x42 0x4D 0x00 0x04 cmd dataL chkH chkL`; a passive read is answered with a data frame.
+     */
+    enum PmsCommand : uint8_t {
+        PMS_CMD_READ = 0xE2,          // passive mode: send one data frame
+        PMS_CMD_CHANGE_MODE = 0xE1,   // data 0 = passive, 1 = active
+        PMS_CMD_SLEEP = 0xE4          // data 0 = sleep, 1 = wake up
+    };
+
+    static constexpr uint8_t PMS_COMMAND_FRAME_LENGTH = 7;
+    static constexpr uint8_t PMS_ACK_FRAME_LENGTH = 8;
+    static constexpr uint16_t PMS_ACK_DATA_LENGTH = 4;
+
+    /**
+     * @brief Builds a command frame into `out`, which holds `PMS_COMMAND_FRAME_LENGTH` bytes.
+     */
+    inline void buildCommandFrame(uint8_t command, uint16_t data, uint8_t *out) {
+        out[0] = 0x42;
+        out[1] = 0x4D;
+        out[2] = command;
+        out[3] = (uint8_t)(data >> 8);
+        out[4] = (uint8_t)(data & 0xFF);
+        uint16_t checksum = (uint16_t)(out[0] + out[1] + out[2] + out[3] + out[4]);
+        out[5] = (uint8_t)(checksum >> 8);
+        out[6] = (uint8_t)(checksum & 0xFF);
+    }
+
+}
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef AIR_QUALITY_SENSOR_PMS_FRAME_LAYOUTS_H
+#define AIR_QUALITY_SENSOR_PMS_FRAME_LAYOUTS_H
+#include "FrameLayout.h"
+#include "AirQualityModel_PMS5003.h"
+#include "AirQualityModel_PMS5003T.h"
+#include "AirQualityModel_PMS5003ST.h"
+
+namespace debuguear {
+
+    // PMS5003T: 13 data words, 32-byte frame.
+    typedef FrameLayout<AirQualityModel_PMS5003T, 13, FrameFieldList<AirQualityModel_PMS5003T,
+        PMS_FRAME_FIELD(AirQualityModel_PMS5003T, pm10_standard, 0),
+        PMS_FRAME_FIELD(AirQualityModel_PMS5003T, pm25_standard, 1),
+        PMS_FRAME_FIELD(AirQualityModel_PMS5003T, pm100_standard, 2),
+        PMS_FRAME_FIELD(AirQualityModel_PMS5003T, pm10_env, 3),
+        PMS_FRAME_FIELD(AirQualityModel_PMS5003T, pm25_env, 4),
+        PMS_FRAME_FIELD(AirQualityModel_PMS5003T, pm100_env, 5),
+        PMS_FRAME_FIELD(AirQualityModel_PMS5003T, particles_03um, 6),
+        PMS_FRAME_FIELD(AirQualityModel_PMS5003T, particles_05um, 7),
+        PMS_FRAME_FIELD(AirQualityModel_PMS5003T, particles_10um, 8),
+        PMS_FRAME_FIELD(AirQualityModel_PMS5003T, particles_25um, 9),
+        PMS_FRAME_FIELD(AirQualityModel_PMS5003T, temperature, 10),
+        PMS_FRAME_FIELD(AirQualityModel_PMS5003T, humedity, 11),
+        PMS_FRAME_FIELD(AirQualityModel_PMS5003T, reserved, 12)
+    > > LayoutPMS5003T;
+
+    // PMS5003: 13 data words, 32-byte frame.
+    typedef FrameLayout<AirQualityModel_PMS5003, 13, FrameFieldList<AirQualityModel_PMS5003,
+        PMS_FRAME_FIELD(AirQualityModel_PMS5003, pm10_standard, 0),
+        PMS_FRAME_FIELD(AirQualityModel_PMS5003, pm25_standard, 1),
+        PMS_FRAME_FIELD(AirQualityModel_PMS5003, pm100_standard, 2),
+        PMS_FRAME_FIELD(AirQualityModel_PMS5003, pm10_env, 3),
+        PMS_FRAME_FIELD(AirQualityModel_PMS5003, pm25_env, 4),
+        PMS_FRAME_FIELD(AirQualityModel_PMS5003, pm100_env, 5),
+        PMS_FRAME_FIELD(AirQualityModel_PMS5003, particles_03um, 6),
+        PMS_FRAME_FIELD(AirQualityModel_PMS5003, particles_05um, 7),
+        PMS_FRAME_FIELD(AirQualityModel_PMS5003, particles_10um, 8),
+        PMS_FRAME_FIELD(AirQualityModel_PMS5003, particles_25um, 9),
+        PMS_FRAME_FIELD(AirQualityModel_PMS5003, particles_50um, 10),
+        PMS_FRAME_FIELD(AirQualityModel_PMS5003, particles_100um, 11),
+        PMS_FRAME_FIELD(AirQualityModel_PMS5003, reserved, 12)
+    > > LayoutPMS5003;
+
+    // PMS7003 and PMSA003 send the same frame as the PMS5003.
+    typedef LayoutPMS5003 LayoutPMS7003;
+    typedef LayoutPMS5003 LayoutPMSA003;
+
+    // PMS5003ST: 17 data words, 40-byte frame.
+    typedef FrameLayout<AirQualityModel_PMS5003ST, 17, FrameFieldList<AirQualityModel_PMS5003ST,
+        PMS_FRAME_FIELD(AirQualityModel_PMS5003ST, pm10_standard, 0),
+        PMS_FRAME_FIELD(AirQualityModel_PMS5003ST, pm25_standard, 1),
+        PMS_FRAME_FIELD(AirQualityModel_PMS5003ST, pm100_standard, 2),
+        PMS_FRAME_FIELD(AirQualityModel_PMS5003ST, pm10_env, 3),
+        PMS_FRAME_FIELD(AirQualityModel_PMS5003ST, pm25_env, 4),
+        PMS_FRAME_FIELD(AirQualityModel_PMS5003ST, pm100_env, 5),
+        PMS_FRAME_FIELD(AirQualityModel_PMS5003ST, particles_03um, 6),
+        PMS_FRAME_FIELD(AirQualityModel_PMS5003ST, particles_05um, 7),
+        PMS_FRAME_FIELD(AirQualityModel_PMS5003ST, particles_10um, 8),
+        PMS_FRAME_FIELD(AirQualityModel_PMS5003ST, particles_25um, 9),
+        PMS_FRAME_FIELD(AirQualityModel_PMS5003ST, particles_50um, 10),
+        PMS_FRAME_FIELD(AirQualityModel_PMS5003ST, particles_100um, 11),
+        PMS_FRAME_FIELD(AirQualityModel_PMS5003ST, formaldehyde, 12),
+        PMS_FRAME_FIELD(AirQualityModel_PMS5003ST, temperature, 13),
+        PMS_FRAME_FIELD(AirQualityModel_PMS5003ST, humedity, 14),
+        PMS_FRAME_FIELD(AirQualityModel_PMS5003ST, reserved, 15),
+        PMS_FRAME_FIELD(AirQualityModel_PMS5003ST, version_error, 16)
+    > > LayoutPMS5003ST;
+
+}
+
+#endif
@@ -0,0 +1,412 @@
+#ifndef AIR_QUALITY_SENSOR_READING_FORMAT_H
+#define AIR_QUALITY_SENSOR_READING_FORMAT_H
+#include "Arduino.h"
+
+namespace debuguear {
+
+    namespace format {
+        static constexpr uint8_t MAX_NAME_CHARS = 15;   // longest field name, "particles_100um"
+        static constexpr uint8_t MAX_VALUE_CHARS = 7;   // "65535", "-3276.8", "65.535"
+        static constexpr uint8_t MAX_TIMESTAMP_CHARS = 20;
+
+        /**
+         * @brief Writes the decimal digits of `value` to `out` without a terminator.
+         * @return The number of digits written.
+         */
+        inline uint8_t formatUnsigned(uint32_t value, char *out) {
+            char digits[10];
+            uint8_t n = 0;
+            do {
+                digits[n++] = (char)('0' + (uint8_t)(value % 10));
+                value /= 10;
+            } while (value != 0);
+            for (uint8_t i = 0; i < n; ++i) {
+                out[i] = digits[n - 1 - i];
+            }
+            return n;
+        }
+
+        /**
+         * @brief 64-bit variant for timestamps. Only the digits above 32 bits use 64-bit
+         *        division, which is expensive on 8-bit targets.
+         */
+        inline uint8_t formatUnsigned64(uint64_t value, char *out) {
+            if (value <= 0xFFFFFFFFULL) {
+                return formatUnsigned((uint32_t)value, out);
+            }
+            char digits[MAX_TIMESTAMP_CHARS];
+            uint8_t n = 0;
+            while (value > 0xFFFFFFFFULL) {
+                digits[n++] = (char)('0' + (uint8_t)(value % 10));
+                value /= 10;
+            }
+            uint8_t high = formatUnsigned((uint32_t)value, out);
+            for (uint8_t i = 0; i < n; ++i) {
+                out[high + i] = digits[n - 1 - i];
+            }
+            return (uint8_t)(high + n);
+        }
+
+        /**
+         * @brief Writes `value / 10^decimals` with exactly `decimals` fractional digits.
+         * @return The number of characters written.
+         */
+        inline uint8_t formatFixed(int32_t value, uint8_t decimals, char *out) {
+            uint8_t n = 0;
+            uint32_t magnitude = value < 0 ? (uint32_t)(-(value + 1)) + 1 : (uint32_t)value;
+            if (value < 0) {
+                out[n++] = '-';
+            }
+            uint32_t scale = 1;
+            for (uint8_t i = 0; i < decimals; ++i) {
+                scale *= 10;
+            }
+            n += formatUnsigned(magnitude / scale, &out[n]);
+            if (decimals != 0) {
+                out[n++] = '.';
+                uint32_t fraction = magnitude % scale;
+                for (uint8_t i = decimals; i > 0; --i) {
+                    out[n + i - 1] = (char)('0' + fraction % 10);
+                    fraction /= 10;
+                }
+                n += decimals;
+            }
+            return n;
+        }
+
+        /**
+         * @brief Output into a caller supplied buffer. Overflow is sticky: `finish` then
+         *        empties the buffer and reports 0.
+         */
+        class BufferSink {
+            public:
+                BufferSink(char *buf, size_t size) : buf(buf), size(size), length(0), overflow(size == 0) {}
+
+                void put(char c) {
+                    if (length + 1 >= size) {
+                        overflow = true;
+                        return;
+                    }
+                    buf[length++] = c;
+                }
+
+                void put(const char *text, size_t count) {
+                    if (length + count >= size) {
+                        overflow = true;
+                        return;
+                    }
+                    memcpy(&buf[length], text, count);
+                    length += count;
+                }
+
+                size_t finish() {
+                    if (size == 0) {
+                        return 0;
+                    }
+                    if (overflow) {
+                        buf[0] = '\0';
+                        return 0;
+                    }
+                    buf[length] = '\0';
+                    return length;
+                }
+
+            private:
+                char *buf;
+                size_t size;
+                size_t length;
+                bool overflow;
+        };
+
+        /**
+         * @brief Output to a `Print`, batched through a small stack buffer so the sink sees a
+         *        few `write` calls per reading instead of one per character.
+         */
+        class PrintSink {
+            public:
+                explicit PrintSink(Print &target) : out(&target), used(0), written(0) {}
+
+                void put(char c) {
+                    if (used == sizeof(chunk)) {
+                        this->drain();
+                    }
+                    chunk[used++] = c;
+                }
+
+                void put(const char *text, size_t count) {
+                    while (count--) {
+                        this->put(*text++);
+                    }
+                }
+
+                size_t finish() {
+                    this->drain();
+                    return written;
+                }
+
+            private:
+                Print *out;
+                char chunk[32];
+                uint8_t used;
+                size_t written;
+
+                void drain() {
+                    if (used != 0) {
+                        written += out->write((const uint8_t *)chunk, used);
+                        used = 0;
+                    }
+                }
+        };
+
+        template <typename Sink>
+        inline void putText(Sink &sink, const char *text) {
+            sink.put(text, strlen(text));
+        }
+
+        template <typename Sink>
+        struct CsvVisitor {
+            Sink &sink;
+            bool first;
+
+            void separator() {
+                if (!first) {
+                    sink.put(',');
+                }
+                first = false;
+            }
+
+            void value(const char *, uint16_t v) {
+                char digits[MAX_VALUE_CHARS];
+                this->separator();
+                sink.put(digits, formatUnsigned(v, digits));
+            }
+
+            void fixed(const char *, int32_t v, uint8_t decimals) {
+                char digits[MAX_VALUE_CHARS + 4];
+                this->separator();
+                sink.put(digits, formatFixed(v, decimals, digits));
+            }
+        };
+
+        template <typename Sink>
+        struct CsvHeaderVisitor {
+            Sink &sink;
+            bool first;
+
+            void value(const char *name, uint16_t) {
+                if (!first) {
+                    sink.put(',');
+                }
+                first = false;
+                putText(sink, name);
+            }
+
+            void fixed(const char *name, int32_t, uint8_t) {
+                this->value(name, 0);
+            }
+        };
+
+        template <typename Sink>
+        struct JsonVisitor {
+            Sink &sink;
+            bool first;
+
+            void key(const char *name) {
+                sink.put(first ? '{' : ',');
+                first = false;
+                sink.put('"');
+                putText(sink, name);
+                sink.put("\":", 2);
+            }
+
+            void value(const char *name, uint16_t v) {
+                char digits[MAX_VALUE_CHARS];
+                this->key(name);
+                sink.put(digits, formatUnsigned(v, digits));
+            }
+
+            void fixed(const char *name, int32_t v, uint8_t decimals) {
+                char digits[MAX_VALUE_CHARS + 4];
+                this->key(name);
+                sink.put(digits, formatFixed(v, decimals, digits));
+            }
+        };
+
+        /**
+         * @brief InfluxDB line protocol field set: integers carry the `i` suffix, fixed-point
+         *        values are written as floats.
+         */
+        template <typename Sink>
+        struct LineProtocolVisitor {
+            Sink &sink;
+            bool first;
+
+            void key(const char *name) {
+                sink.put(first ? ' ' : ',');
+                first = false;
+                putText(sink, name);
+                sink.put('=');
+            }
+
+            void value(const char *name, uint16_t v) {
+                char digits[MAX_VALUE_CHARS];
+                this->key(name);
+                sink.put(digits, formatUnsigned(v, digits));
+                sink.put('i');
+            }
+
+            void fixed(const char *name, int32_t v, uint8_t decimals) {
+                char digits[MAX_VALUE_CHARS + 4];
+                this->key(name);
+                sink.put(digits, formatFixed(v, decimals, digits));
+            }
+        };
+
+        template <typename Model, typename Sink>
+        inline size_t writeCsv(const Model &data, Sink &sink) {
+            CsvVisitor<Sink> visitor = {sink, true};
+            data.visit(visitor);
+            sink.put('\n');
+            return sink.finish();
+        }
+
+        template <typename Model, typename Sink>
+        inline size_t writeCsvHeader(Sink &sink) {
+            CsvHeaderVisitor<Sink> visitor = {sink, true};
+            Model data;
+            data.clean();
+            data.visit(visitor);
+            sink.put('\n');
+            return sink.finish();
+        }
+
+        template <typename Model, typename Sink>
+        inline size_t writeJson(const Model &data, Sink &sink) {
+            JsonVisitor<Sink> visitor = {sink, true};
+            data.visit(visitor);
+            sink.put('}');
+            return sink.finish();
+        }
+
+        template <typename Model, typename Sink>
+        inline size_t writeLineProtocol(const Model &data, const char *measurement, uint64_t timestamp, Sink &sink) {
+            LineProtocolVisitor<Sink> visitor = {sink, true};
+            putText(sink, measurement);
+            data.visit(visitor);
+            if (timestamp != 0) {
+                char digits[MAX_TIMESTAMP_CHARS];
+                sink.put(' ');
+                sink.put(digits, formatUnsigned64(timestamp, digits));
+            }
+            sink.put('\n');
+            return sink.finish();
+        }
+    }
+
+    /**
+     * @brief Buffer sizes, terminator included, that always fit the formatted `Model`.
+     */
+    template <typename Model>
+    struct FormatBounds {
+        static constexpr size_t CSV = Model::FORMAT_FIELDS * (format::MAX_VALUE_CHARS + 1) + 1;
+        static constexpr size_t CSV_HEADER = Model::FORMAT_FIELDS * (format::MAX_NAME_CHARS + 1) + 1;
+        static constexpr size_t JSON = Model::FORMAT_FIELDS * (format::MAX_NAME_CHARS + format::MAX_VALUE_CHARS + 4) + 2;
+
+        /**
+         * @param measurementLength Length of the measurement name and its tags (`"pms,room=lab"`).
+         */
+        static constexpr size_t lineProtocol(size_t measurementLength) {
+            return measurementLength + Model::FORMAT_FIELDS * (format::MAX_NAME_CHARS + format::MAX_VALUE_CHARS + 3)
+                + 1 + format::MAX_TIMESTAMP_CHARS + 2;
+        }
+    };
+
+    /**
+     * @brief Writes `data` as one CSV line (`visit` order, `\n` terminated) into `buf`.
+     *
+     * Numbers are formatted with integer arithmetic only and nothing is allocated.
+     * Temperature and humidity are written in units, with one decimal (`23.1`).
+     *
+     * @param buf Destination, `FormatBounds<Model>::CSV` bytes always suffice.
+     * @param size Size of `buf`.
+     *
+     * @return The length written, excluding the terminator, or 0 if `buf` is too small
+     *         (`buf` then holds an empty string).
+     */
+    template <typename Model>
+    size_t formatCsv(const Model &data, char *buf, size_t size) {
+        format::BufferSink sink(buf, size);
+        return format::writeCsv(data, sink);
+    }
+
+    /**
+     * @brief Same as `formatCsv(data, buf, size)`, written to `out`.
+     * @return The number of bytes accepted by `out`.
+     */
+    template <typename Model>
+    size_t formatCsv(const Model &data, Print &out) {
+        format::PrintSink sink(out);
+        return format::writeCsv(data, sink);
+    }
+
+    /**
+     * @brief Writes the CSV header line (field names) of `Model` into `buf`.
+     */
+    template <typename Model>
+    size_t formatCsvHeader(char *buf, size_t size) {
+        format::BufferSink sink(buf, size);
+        return format::writeCsvHeader<Model>(sink);
+    }
+
+    template <typename Model>
+    size_t formatCsvHeader(Print &out) {
+        format::PrintSink sink(out);
+        return format::writeCsvHeader<Model>(sink);
+    }
+
+    /**
+     * @brief Writes `data` as a compact JSON object (`{"pm10_standard":8,...}`) into `buf`.
+     *
+     * @param size Size of `buf`, `FormatBounds<Model>::JSON` bytes always suffice.
+     *
+     * @return The length written, excluding the terminator, or 0 if `buf` is too small.
+     */
+    template <typename Model>
+    size_t formatJson(const Model &data, char *buf, size_t size) {
+        format::BufferSink sink(buf, size);
+        return format::writeJson(data, sink);
+    }
+
+    template <typename Model>
+    size_t formatJson(const Model &data, Print &out) {
+        format::PrintSink sink(out);
+        return format::writeJson(data, sink);
+    }
+
+    /**
+     * @brief Writes `data` as one InfluxDB line protocol line into `buf`.
+     *
+     * @param measurement Measurement name, optionally followed by tags (`"pms,room=lab"`),
+     *                    already escaped.
+     * @param timestamp Timestamp in the precision configured on the server, 0 to let the
+     *                  server stamp the point.
+     * @param size Size of `buf`, `FormatBounds<Model>::lineProtocol(strlen(measurement))`
+     *             bytes always suffice.
+     *
+     * @return The length written, excluding the terminator, or 0 if `buf` is too small.
+     */
+    template <typename Model>
+    size_t formatLineProtocol(const Model &data, const char *measurement, char *buf, size_t size, uint64_t timestamp = 0) {
+        format::BufferSink sink(buf, size);
+        return format::writeLineProtocol(data, measurement, timestamp, sink);
+    }
+
+    template <typename Model>
+    size_t formatLineProtocol(const Model &data, const char *measurement, Print &out, uint64_t timestamp = 0) {
+        format::PrintSink sink(out);
+        return format::writeLineProtocol(data, measurement, timestamp, sink);
+    }
+
+}
+
+#endif
@@ -0,0 +1,162 @@
+#ifndef AIR_QUALITY_SENSOR_READING_LATCH_H
+#define AIR_QUALITY_SENSOR_READING_LATCH_H
+#include "Arduino.h"
+#include "Atomics.h"
+
+namespace debuguear {
+
+    /**
+     * @brief A reading together with when it was published.
+     */
+    template <typename Model>
+    struct ReadingSnapshot {
+        Model data;
+        uint32_t sequence;          // 1 for the first reading published, then one more for each
+        unsigned long timestampMs;  // `millis()` when the frame was parsed
+    };
+
+#if AIR_QUALITY_HAS_STD_ATOMIC
+    /**
+     * @brief One copy of a snapshot held in relaxed atomic words.
+     *
+     * A reader copying it while another core writes it gets a mix of old and new words, which
+     * the latch counter then rejects, instead of the undefined behaviour of a racing struct copy.
+     * `T` must be trivially copyable.
+     */
+    template <typename T>
+    class LatchSlot {
+        public:
+            void store(const T &value) {
+                uint32_t buffer[WORDS] = {};
+                memcpy(buffer, &value, sizeof(T));
+                for (size_t idx = 0; idx < WORDS; ++idx) {
+                    this->words[idx].store(buffer[idx], std::memory_order_relaxed);
+                }
+            }
+
+            void load(T &value) const {
+                uint32_t buffer[WORDS];
+                for (size_t idx = 0; idx < WORDS; ++idx) {
+                    buffer[idx] = this->words[idx].load(std::memory_order_relaxed);
+                }
+                memcpy(&value, buffer, sizeof(T));
+            }
+
+        private:
+            static constexpr size_t WORDS = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+            std::atomic<uint32_t> words[WORDS];
+    };
+#else
+    /**
+     * @brief One copy of a snapshot. AVR is single core: a write racing the copy can only come
+     *        from an interrupt, and the latch counter then discards the copy.
+     */
+    template <typename T>
+    class LatchSlot {
+        public:
+            void store(const T &value) { this->value = value; }
+            void load(T &value) const { value = this->value; }
+
+        private:
+            T value;
+    };
+#endif
+
+    /**
+     * @brief The latest reading of a sensor, published by the parser and readable from any task
+     *        or ISR without locks, allocation or blocking the parser.
+     *
+     * Two copies of the reading are kept, and a counter tells the readers which one is not being
+     * written (a "latch" sequence lock): `publish()` moves the readers to the second copy, writes
+     * the first, moves them back and writes the second. A read copies one snapshot and checks
+     * that the counter did not move meanwhile.
+     *
+     * An ISR interrupting the parser, or any reader on the same core, always succeeds on its
+     * first attempt. A reader on another core is only retried when a whole `publish()` ran
+     * during its copy of a few dozen bytes, which at one reading every 200 ms or more never
+     * happens twice in a row.
+     *
+     * @note There must be a single writer. On AVR the counter is one byte, which is enough since
+     *       readers cannot be preempted by more than one `publish()` there.
+     */
+    template <typename Model>
+    class ReadingLatch {
+        public:
+            ReadingLatch() : published(0) {
+                ReadingSnapshot<Model> empty;
+                empty.data.clean();
+                empty.sequence = 0;
+                empty.timestampMs = 0;
+                this->slots[0].store(empty);
+                this->slots[1].store(empty);
+            }
+
+            /**
+             * @brief Makes `data` the latest reading. Only one task may publish.
+             */
+            void publish(const Model &data, unsigned long timestampMs) {
+                this->published++;
+                Counter count = this->counter.loadRelaxed();
+                this->counter.store(count + 1);
+                releaseFence();
+                this->write(this->slots[0], data, timestampMs);
+                this->counter.store(count + 2);
+                releaseFence();
+                this->write(this->slots[1], data, timestampMs);
+            }
+
+            /**
+             * @brief A single, constant time attempt at copying the latest reading.
+             *
+             * @return `false` if nothing was published yet, or if a `publish()` from another
+             *         core overtook the copy; `snapshot` is then unspecified.
+             */
+            bool tryRead(ReadingSnapshot<Model> &snapshot) const {
+                Counter count = this->counter.load();
+                this->slots[count & 1].load(snapshot);
+                acquireFence();
+                return this->counter.loadRelaxed() == count && snapshot.sequence != 0;
+            }
+
+            /**
+             * @brief Copies the latest reading, retrying while publishes overtake the copy.
+             *
+             * @return `false` if nothing was published yet.
+             */
+            bool read(ReadingSnapshot<Model> &snapshot) const {
+                while (true) {
+                    Counter count = this->counter.load();
+                    this->slots[count & 1].load(snapshot);
+                    acquireFence();
+                    if (this->counter.loadRelaxed() == count) {
+                        return snapshot.sequence != 0;
+                    }
+                }
+            }
+
+        private:
+#if AIR_QUALITY_HAS_STD_ATOMIC
+            typedef uint32_t Counter;
+#else
+            typedef uint8_t Counter;
+#endif
+
+            void write(LatchSlot<ReadingSnapshot<Model> > &slot, const Model &data, unsigned long timestampMs) {
+                ReadingSnapshot<Model> snapshot;
+                snapshot.data = data;
+                snapshot.sequence = this->published;
+                snapshot.timestampMs = timestampMs;
+                slot.store(snapshot);
+            }
+
+            AtomicCell<Counter> counter;
+            uint32_t published;
+            LatchSlot<ReadingSnapshot<Model> > slots[2];
+
+            ReadingLatch(const ReadingLatch &) = delete;
+            ReadingLatch &operator=(const ReadingLatch &) = delete;
+    };
+
+}
+
+#endif
@@ -0,0 +1,196 @@
+#ifndef AIR_QUALITY_SENSOR_READING_QUEUE_H
+#define AIR_QUALITY_SENSOR_READING_QUEUE_H
+#include "Arduino.h"
+#include "Atomics.h"
+#include "Threading.h"
+
+namespace debuguear {
+
+    /**
+     * @brief Bounded lock-free multi-producer/multi-consumer queue of decoded readings.
+     *
+     * Every slot carries a sequence number telling producers and consumers whose turn it is
+     * (Vyukov's bounded queue), so `push` and `tryReceive` only spin on a compare-and-swap
+     * of the shared position, never on a lock. When the queue is full the oldest reading is
+     * dropped to make room: consumers that fall behind see the most recent readings.
+     * `receive()` blocks on a semaphore, and counts itself as parked beforehand: a push only
+     * gives the semaphore, which takes a mutex or a critical section, while a consumer is
+     * parked. With consumers keeping up, or polling `tryReceive`, producers never block.
+     *
+     * The storage is provided by `BoundedReadingQueue<Model, SIZE>`; this base class lets
+     * readers and consumers work with any queue size.
+     */
+    template <typename Model>
+    class ReadingQueue {
+        public:
+
+            /**
+             * @brief Appends a reading, dropping the oldest one when the queue is full.
+             *        Safe from any number of threads.
+             */
+            void push(const Model &reading) {
+                while (!this->tryPush(reading)) {
+                    Model oldest;
+                    if (this->tryReceive(oldest)) {
+                        this->droppedCount.fetchAdd(1);
+                    }
+                }
+                this->pushedCount.fetchAdd(1);
+                // Pairs with the fence in `receive`: either the consumer sees the reading, or
+                // the push sees the consumer parked.
+                fullFence();
+                if (this->parked.loadRelaxed() != 0) {
+                    this->ready.give();
+                }
+            }
+
+            /**
+             * @brief Takes the oldest reading without waiting.
+             *
+             * @return `false` if the queue was empty.
+             */
+            bool tryReceive(Model &out) {
+                size_t position = this->dequeuePos.loadRelaxed();
+                while (true) {
+                    Slot &slot = this->slots[position & this->mask];
+                    intptr_t diff = (intptr_t)slot.sequence.load() - (intptr_t)(position + 1);
+                    if (diff == 0) {
+                        if (this->dequeuePos.compareExchange(position, position + 1)) {
+                            out = slot.reading;
+                            slot.sequence.store(position + this->mask + 1);
+                            return true;
+                        }
+                    } else if (diff < 0) {
+                        return false;
+                    } else {
+                        position = this->dequeuePos.loadRelaxed();
+                    }
+                }
+            }
+
+            /**
+             * @brief Takes the oldest reading, waiting up to `timeoutMs` for one to be pushed.
+             *
+             * @param timeoutMs Maximum wait, `threading::WAIT_FOREVER` to wait indefinitely.
+             *
+             * @return `false` if no reading arrived in time.
+             */
+            bool receive(Model &out, uint32_t timeoutMs = threading::WAIT_FOREVER) {
+                unsigned long start = millis();
+                while (!this->tryReceive(out)) {
+                    uint32_t remaining = timeoutMs;
+                    if (timeoutMs != threading::WAIT_FOREVER) {
+                        unsigned long elapsed = (unsigned long)(millis() - start);
+                        if (elapsed >= timeoutMs) {
+                            return false;
+                        }
+                        remaining = timeoutMs - (uint32_t)elapsed;
+                    }
+                    this->parked.fetchAdd(1);
+                    fullFence();
+                    if (this->tryReceive(out)) {
+                        this->parked.fetchAdd((uint32_t)-1);
+                        return true;
+                    }
+                    // A token may outlive its reading (taken by another consumer or dropped),
+                    // hence the retry loop.
+                    bool woken = this->ready.take(remaining);
+                    this->parked.fetchAdd((uint32_t)-1);
+                    if (!woken) {
+                        return this->tryReceive(out);
+                    }
+                }
+                return true;
+            }
+
+            /**
+             * @brief Readings pushed since construction, including the dropped ones.
+             */
+            uint32_t pushed() const {
+                return this->pushedCount.loadRelaxed();
+            }
+
+            /**
+             * @brief Readings discarded to make room for newer ones since construction.
+             */
+            uint32_t dropped() const {
+                return this->droppedCount.loadRelaxed();
+            }
+
+            size_t size() const {
+                return this->mask + 1;
+            }
+
+        protected:
+            struct Slot {
+                AtomicCell<size_t> sequence;
+                Model reading;
+            };
+
+            ReadingQueue(Slot *slots, size_t capacity)
+                : slots(slots), mask(capacity - 1), enqueuePos(0), dequeuePos(0), pushedCount(0), droppedCount(0),
+                  parked(0), ready((uint32_t)capacity) {}
+
+            /**
+             * @brief Numbers the slots. Called by the derived class once its storage is constructed.
+             */
+            void initializeSlots() {
+                for (size_t i = 0; i <= this->mask; ++i) {
+                    this->slots[i].sequence.storeRelaxed(i);
+                }
+            }
+
+        private:
+            Slot *slots;
+            const size_t mask;
+            AtomicCell<size_t> enqueuePos;
+            AtomicCell<size_t> dequeuePos;
+            AtomicCell<uint32_t> pushedCount;
+            AtomicCell<uint32_t> droppedCount;
+            AtomicCell<uint32_t> parked;    // consumers about to wait, or waiting, on `ready`
+            threading::Semaphore ready;
+
+            bool tryPush(const Model &reading) {
+                size_t position = this->enqueuePos.loadRelaxed();
+                while (true) {
+                    Slot &slot = this->slots[position & this->mask];
+                    intptr_t diff = (intptr_t)slot.sequence.load() - (intptr_t)position;
+                    if (diff == 0) {
+                        if (this->enqueuePos.compareExchange(position, position + 1)) {
+                            slot.reading = reading;
+                            slot.sequence.store(position + 1);
+                            return true;
+                        }
+                    } else if (diff < 0) {
+                        return false;
+                    } else {
+                        position = this->enqueuePos.loadRelaxed();
+                    }
+                }
+            }
+
+            ReadingQueue(const ReadingQueue &) = delete;
+            ReadingQueue &operator=(const ReadingQueue &) = delete;
+    };
+
+    /**
+     * @brief `ReadingQueue` with inline storage.
+     *
+     * @tparam SIZE Capacity in readings, a power of two.
+     */
+    template <typename Model, size_t SIZE>
+    class BoundedReadingQueue : public ReadingQueue<Model> {
+        static_assert(SIZE >= 2 && (SIZE & (SIZE - 1)) == 0, "BoundedReadingQueue size must be a power of two");
+
+        public:
+            BoundedReadingQueue() : ReadingQueue<Model>(storage, SIZE) {
+                this->initializeSlots();
+            }
+
+        private:
+            typename ReadingQueue<Model>::Slot storage[SIZE];
+    };
+
+}
+
+#endif
@@ -0,0 +1,198 @@
+#ifndef AIR_QUALITY_SENSOR_REQUEST_SCHEDULER_H
+#define AIR_QUALITY_SENSOR_REQUEST_SCHEDULER_H
+#include "Arduino.h"
+#include "AirQualityPMSProcessor.h"
+
+namespace debuguear {
+
+    /**
+     * @brief Reads several passive-mode sensors at a fixed interval, with requests in flight
+     *        to all of them at once.
+     *
+     * Each `tick()` polls every sensor, then sends a read request to each sensor whose interval
+     * elapsed and that has no request outstanding, without waiting for the other sensors to
+     * answer. A request is matched when the sensor's `framesReceived()` counter moves; one that
+     * gets no frame within `timeoutMs` is counted as timed out and sent again.
+     * Readings still reach the processors' observers as usual.
+     *
+     * Sensors must be in passive mode (see `begin()`), otherwise their periodic frames would be
+     * taken as answers.
+     *
+     * @tparam MAX_SENSORS Maximum number of processors that can be registered.
+     *
+     * @example
+     * ```cpp
+     * debuguear::PMS5003T_FULL_PROCESSOR_T indoor(&Serial1, 1);
+     * debuguear::PMS5003_FULL_PROCESSOR_T outdoor(&Serial2, 1);
+     * debuguear::RequestScheduler<2> scheduler(60000, 1500);
+     *
+     * void setup() {
+     *     scheduler.add(indoor);
+     *     scheduler.add(outdoor);
+     *     scheduler.begin();
+     * }
+     *
+     * void loop() {
+     *     scheduler.tick();
+     * }
+     * ```
+     */
+    template <uint8_t MAX_SENSORS>
+    class RequestScheduler {
+        public:
+
+            /**
+             * @brief Request state of one sensor.
+             */
+            struct Status {
+                bool inFlight;
+                uint32_t completed;
+                uint32_t timeouts;
+                unsigned long lastLatencyMs;   // request to frame, of the last completed request
+            };
+
+            /**
+             * @param intervalMs Time between two requests to the same sensor.
+             * @param timeoutMs Time after which an unanswered request is given up.
+             * @param bytesPerSensor Byte budget of each sensor per tick, as in `SensorPoller`.
+             */
+            RequestScheduler(unsigned long intervalMs, unsigned long timeoutMs, size_t bytesPerSensor = 64)
+                : intervalMs(intervalMs), timeoutMs(timeoutMs), bytesPerSensor(bytesPerSensor), count(0) {}
+
+            /**
+             * @brief Registers a processor. It must outlive the scheduler.
+             *
+             * @return `false` if `MAX_SENSORS` processors are already registered.
+             */
+            template <typename Layout, uint8_t MAX_OBSERVERS, uint8_t FEATURES>
+            bool add(AirQualitySensor<Layout, MAX_OBSERVERS, FEATURES> &sensor) {
+                typedef AirQualitySensor<Layout, MAX_OBSERVERS, FEATURES> Sensor;
+                if (count >= MAX_SENSORS) {
+                    return false;
+                }
+                Entry &entry = sensors[count++];
+                entry.sensor = &sensor;
+                entry.poll = &RequestScheduler::pollThunk<Sensor>;
+                entry.command = &RequestScheduler::commandThunk<Sensor>;
+                entry.frames = &RequestScheduler::framesThunk<Sensor>;
+                entry.framesAtRequest = 0;
+                entry.sentAt = 0;
+                entry.due = true;
+                entry.status.inFlight = false;
+                entry.status.completed = 0;
+                entry.status.timeouts = 0;
+                entry.status.lastLatencyMs = 0;
+                return true;
+            }
+
+            /**
+             * @brief Switches every registered sensor to passive mode.
+             *
+             * @return The number of sensors the command was sent to.
+             */
+            uint8_t begin() {
+                uint8_t sent = 0;
+                for (uint8_t i = 0; i < count; ++i) {
+                    if (sensors[i].command(sensors[i].sensor, PMS_CMD_CHANGE_MODE, 0)) {
+                        sent++;
+                    }
+                }
+                return sent;
+            }
+
+            /**
+             * @brief Collects answers, expires overdue requests and sends the due ones.
+             *
+             * @return The number of requests sent in this tick.
+             */
+            uint8_t tick() {
+                unsigned long now = millis();
+                uint8_t sent = 0;
+                for (uint8_t i = 0; i < count; ++i) {
+                    Entry &entry = sensors[i];
+                    entry.poll(entry.sensor, bytesPerSensor);
+
+                    if (entry.status.inFlight) {
+                        if (entry.frames(entry.sensor) != entry.framesAtRequest) {
+                            entry.status.inFlight = false;
+                            entry.status.completed++;
+                            entry.status.lastLatencyMs = (unsigned long)(now - entry.sentAt);
+                        } else if ((unsigned long)(now - entry.sentAt) >= timeoutMs) {
+                            entry.status.inFlight = false;
+                            entry.status.timeouts++;
+                            entry.due = true;
+                        } else {
+                            continue;
+                        }
+                    }
+
+                    if (!entry.due && (unsigned long)(now - entry.sentAt) < intervalMs) {
+                        continue;
+                    }
+                    entry.framesAtRequest = entry.frames(entry.sensor);
+                    if (entry.command(entry.sensor, PMS_CMD_READ, 0)) {
+                        entry.sentAt = now;
+                        entry.due = false;
+                        entry.status.inFlight = true;
+                        sent++;
+                    }
+                }
+                return sent;
+            }
+
+            /**
+             * @brief Number of requests currently waiting for an answer.
+             */
+            uint8_t inFlight() const {
+                uint8_t pending = 0;
+                for (uint8_t i = 0; i < count; ++i) {
+                    pending += sensors[i].status.inFlight ? 1 : 0;
+                }
+                return pending;
+            }
+
+            const Status &status(uint8_t index) const {
+                return sensors[index].status;
+            }
+
+            uint8_t size() const {
+                return count;
+            }
+
+        private:
+            struct Entry {
+                void *sensor;
+                size_t (*poll)(void *sensor, size_t maxBytes);
+                bool (*command)(void *sensor, uint8_t command, uint16_t data);
+                uint32_t (*frames)(void *sensor);
+                uint32_t framesAtRequest;
+                unsigned long sentAt;
+                bool due;
+                Status status;
+            };
+
+            template <typename Sensor>
+            static size_t pollThunk(void *sensor, size_t maxBytes) {
+                return static_cast<Sensor *>(sensor)->poll(maxBytes);
+            }
+
+            template <typename Sensor>
+            static bool commandThunk(void *sensor, uint8_t command, uint16_t data) {
+                return static_cast<Sensor *>(sensor)->sendCommand(command, data);
+            }
+
+            template <typename Sensor>
+            static uint32_t framesThunk(void *sensor) {
+                return static_cast<Sensor *>(sensor)->framesReceived();
+            }
+
+            Entry sensors[MAX_SENSORS];
+            unsigned long intervalMs;
+            unsigned long timeoutMs;
+            size_t bytesPerSensor;
+            uint8_t count;
+    };
+
+}
+
+#endif
@@ -0,0 +1,493 @@
+#ifndef AIR_QUALITY_SENSOR_ROLLING_STATISTICS_H
+#define AIR_QUALITY_SENSOR_ROLLING_STATISTICS_H
+#include "Arduino.h"
+
+namespace debuguear {
+
+    /**
+     * @brief Windows tracked by `FieldStatistics`.
+     */
+    enum StatWindow : uint8_t {
+        WINDOW_1_MIN,
+        WINDOW_15_MIN,
+        WINDOW_24_H,
+        WINDOW_COUNT
+    };
+
+    /**
+     * @brief Mean, extremes and exponential moving average of one field over one window.
+     *
+     * `valid` is `false` while the window holds no reading; the other members are then zero.
+     */
+    struct WindowSummary {
+        float mean;
+        float ema;
+        uint16_t min;
+        uint16_t max;
+        bool valid;
+    };
+
+    /**
+     * @brief Mean, min and max of the readings that fell into one time bucket.
+     *
+     * `mean == EMPTY` marks a bucket without readings.
+     */
+    struct StatBucket {
+        static constexpr uint16_t EMPTY = 0xFFFF;
+
+        uint16_t mean, min, max;
+    };
+
+    /**
+     * @brief Accumulates readings (or the buckets of a finer level) into the bucket being filled.
+     */
+    struct StatAccumulator {
+        uint32_t sum;
+        uint16_t count, min, max;
+
+        void reset() {
+            sum = 0;
+            count = 0;
+            min = StatBucket::EMPTY;
+            max = 0;
+        }
+
+        void add(uint16_t value) {
+            sum += value;
+            count++;
+            if (value < min) {
+                min = value;
+            }
+            if (value > max) {
+                max = value;
+            }
+        }
+
+        /**
+         * @brief Folds a closed bucket of a finer level in. Every bucket weighs the same,
+         *        so the result is a time-weighted mean rather than a per-reading one.
+         */
+        void fold(const StatBucket &bucket) {
+            if (bucket.mean == StatBucket::EMPTY) {
+                return;
+            }
+            sum += bucket.mean;
+            count++;
+            if (bucket.min < min) {
+                min = bucket.min;
+            }
+            if (bucket.max > max) {
+                max = bucket.max;
+            }
+        }
+
+        StatBucket toBucket() const {
+            StatBucket bucket;
+            if (count == 0) {
+                bucket.mean = StatBucket::EMPTY;
+                bucket.min = StatBucket::EMPTY;
+                bucket.max = 0;
+            } else {
+                bucket.mean = (uint16_t)((sum + count / 2) / count);
+                bucket.min = min;
+                bucket.max = max;
+            }
+            return bucket;
+        }
+    };
+
+    /**
+     * @brief Fixed ring of closed buckets with a running sum and cached extremes.
+     *
+     * Pushing a bucket is O(1); the extremes are only rescanned when the evicted bucket held
+     * one of them, which happens at most once per bucket period.
+     *
+     * @tparam BUCKETS Number of buckets kept, i.e. the window length in bucket periods.
+     */
+    template <uint8_t BUCKETS>
+    class StatBucketRing {
+        public:
+            StatBucketRing() {
+                this->clear();
+            }
+
+            void clear() {
+                for (uint8_t i = 0; i < BUCKETS; ++i) {
+                    buckets[i].mean = StatBucket::EMPTY;
+                    buckets[i].min = StatBucket::EMPTY;
+                    buckets[i].max = 0;
+                }
+                total = 0;
+                valid = 0;
+                head = 0;
+                lowest = StatBucket::EMPTY;
+                highest = 0;
+            }
+
+            void push(const StatBucket &bucket) {
+                StatBucket &slot = buckets[head];
+                bool rescan = false;
+                if (slot.mean != StatBucket::EMPTY) {
+                    total -= slot.mean;
+                    valid--;
+                    rescan = slot.min == lowest || slot.max == highest;
+                }
+                slot = bucket;
+                head = (uint8_t)((head + 1) % BUCKETS);
+                if (bucket.mean != StatBucket::EMPTY) {
+                    total += bucket.mean;
+                    valid++;
+                }
+                if (rescan) {
+                    this->rescanExtremes();
+                } else if (bucket.mean != StatBucket::EMPTY) {
+                    if (bucket.min < lowest) {
+                        lowest = bucket.min;
+                    }
+                    if (bucket.max > highest) {
+                        highest = bucket.max;
+                    }
+                }
+            }
+
+            /**
+             * @brief The `age`-th most recent bucket, 0 being the last one pushed.
+             */
+            const StatBucket &recent(uint8_t age) const {
+                return buckets[(head + BUCKETS - 1 - age) % BUCKETS];
+            }
+
+            uint32_t sum() const { return total; }
+            uint8_t validCount() const { return valid; }
+            uint16_t minValue() const { return lowest; }
+            uint16_t maxValue() const { return highest; }
+
+        private:
+            StatBucket buckets[BUCKETS];
+            uint32_t total;
+            uint8_t valid;
+            uint8_t head;
+            uint16_t lowest, highest;
+
+            void rescanExtremes() {
+                lowest = StatBucket::EMPTY;
+                highest = 0;
+                for (uint8_t i = 0; i < BUCKETS; ++i) {
+                    if (buckets[i].mean == StatBucket::EMPTY) {
+                        continue;
+                    }
+                    if (buckets[i].min < lowest) {
+                        lowest = buckets[i].min;
+                    }
+                    if (buckets[i].max > highest) {
+                        highest = buckets[i].max;
+                    }
+                }
+            }
+    };
+
+    /**
+     * @brief One window: the ring of closed buckets, the bucket being filled and an EMA.
+     */
+    template <uint8_t BUCKETS>
+    struct StatLevel {
+        StatBucketRing<BUCKETS> ring;
+        StatAccumulator current;
+        float ema;
+
+        void clear() {
+            ring.clear();
+            current.reset();
+            ema = 0;
+        }
+
+        /**
+         * @brief Closes the bucket being filled and hands it to the next coarser level.
+         */
+        void close(StatAccumulator *parent) {
+            StatBucket bucket = current.toBucket();
+            ring.push(bucket);
+            if (parent != nullptr) {
+                parent->fold(bucket);
+            }
+            current.reset();
+        }
+
+        /**
+         * @brief `current` with the partially filled bucket of the finer level folded in.
+         */
+        StatAccumulator open(const StatAccumulator &finer) const {
+            StatAccumulator result = current;
+            result.fold(finer.toBucket());
+            return result;
+        }
+
+        /**
+         * @param open The bucket being filled, as returned by `open()` for the coarser levels.
+         */
+        WindowSummary summary(const StatAccumulator &open) const {
+            WindowSummary result = {0, 0, 0, 0, false};
+            uint8_t buckets = ring.validCount();
+            float sum = (float)ring.sum();
+            uint16_t minValue = ring.minValue();
+            uint16_t maxValue = ring.maxValue();
+            if (open.count != 0) {
+                // The partially filled bucket counts as one more bucket.
+                sum += (float)open.sum / open.count;
+                buckets++;
+                if (open.min < minValue) {
+                    minValue = open.min;
+                }
+                if (open.max > maxValue) {
+                    maxValue = open.max;
+                }
+            }
+            if (buckets == 0) {
+                return result;
+            }
+            result.mean = sum / buckets;
+            result.ema = ema;
+            result.min = minValue;
+            result.max = maxValue;
+            result.valid = true;
+            return result;
+        }
+    };
+
+    /**
+     * @brief Sliding-window statistics of one 16-bit field over 1 minute, 15 minutes and 24 hours.
+     *
+     * Readings land in 5 s buckets. The 1 min window is a ring of 12 of them; every closed
+     * 5 s bucket is folded into a 1 min bucket (15 kept for the 15 min window), and every closed
+     * 1 min bucket into a 1 h bucket (24 kept for the 24 h window). Adding a reading and querying
+     * a window are O(1) and the whole object takes 424 bytes on a 64-bit host, of which the
+     * 24 h window is under 200. The buckets still being filled count in every window.
+     *
+     * On every closed hour the EPA NowCast of the field is refreshed from the 12 most recent
+     * hourly means, so reading it is O(1) as well.
+     *
+     * @note Bucket means are rounded to integers, like the sensor readings themselves.
+     * @note `0xFFFF` is reserved to mark empty buckets and must not be fed as a reading.
+     */
+    class FieldStatistics {
+        public:
+            static constexpr unsigned long BUCKET_MS = 5000;
+            static constexpr uint8_t MINUTE_BUCKETS = 12;   // 5 s buckets per minute
+            static constexpr uint8_t WINDOW_MINUTES = 15;
+            static constexpr uint8_t HOUR_MINUTES = 60;
+            static constexpr uint8_t DAY_HOURS = 24;
+            static constexpr unsigned long DAY_BUCKETS = (unsigned long)MINUTE_BUCKETS * HOUR_MINUTES * DAY_HOURS;
+
+            FieldStatistics() {
+                this->clear();
+            }
+
+            void clear() {
+                secondLevel.clear();
+                minuteLevel.clear();
+                hourLevel.clear();
+                secondsClosed = 0;
+                minutesClosed = 0;
+                started = false;
+                bucketStart = 0;
+                lastSampleAt = 0;
+                nowcastValue = -1;
+            }
+
+            /**
+             * @brief Adds a reading taken at `nowMs` (a `millis()` timestamp).
+             */
+            void add(uint16_t value, unsigned long nowMs) {
+                if (!started) {
+                    started = true;
+                    bucketStart = nowMs;
+                    lastSampleAt = nowMs;
+                    secondLevel.ema = value;
+                    minuteLevel.ema = value;
+                    hourLevel.ema = value;
+                } else {
+                    this->advance(nowMs);
+                    unsigned long dt = nowMs - lastSampleAt;
+                    lastSampleAt = nowMs;
+                    updateEma(secondLevel.ema, value, dt, 60000UL);
+                    updateEma(minuteLevel.ema, value, dt, 900000UL);
+                    updateEma(hourLevel.ema, value, dt, 86400000UL);
+                }
+                secondLevel.current.add(value);
+            }
+
+            /**
+             * @brief Closes the buckets that ended before `nowMs`, so windows age without readings.
+             *
+             * Constant time whatever the gap: past the bucket being filled every bucket is
+             * empty, and a level is simply cleared once the gap covers its whole window.
+             */
+            void advance(unsigned long nowMs) {
+                if (!started) {
+                    return;
+                }
+                unsigned long steps = (unsigned long)(nowMs - bucketStart) / BUCKET_MS;
+                if (steps == 0) {
+                    return;
+                }
+                if (steps > DAY_BUCKETS) {
+                    // Everything expired; keep the EMAs, they weigh the gap themselves.
+                    float emas[WINDOW_COUNT] = {secondLevel.ema, minuteLevel.ema, hourLevel.ema};
+                    unsigned long last = lastSampleAt;
+                    this->clear();
+                    started = true;
+                    secondLevel.ema = emas[WINDOW_1_MIN];
+                    minuteLevel.ema = emas[WINDOW_15_MIN];
+                    hourLevel.ema = emas[WINDOW_24_H];
+                    lastSampleAt = last;
+                    bucketStart = nowMs;
+                    return;
+                }
+                bucketStart += steps * BUCKET_MS;
+                this->closeBucket();
+                this->skipEmptyBuckets(steps - 1);
+            }
+
+            /**
+             * @brief Summary of a window, the readings of the buckets not closed yet included.
+             */
+            WindowSummary summary(StatWindow window) const {
+                if (window == WINDOW_1_MIN) {
+                    return secondLevel.summary(secondLevel.current);
+                }
+                StatAccumulator minute = minuteLevel.open(secondLevel.current);
+                if (window == WINDOW_15_MIN) {
+                    return minuteLevel.summary(minute);
+                }
+                return hourLevel.summary(hourLevel.open(minute));
+            }
+
+            /**
+             * @brief EPA NowCast over the last 12 complete hours, or a negative value when
+             *        fewer than two of the three most recent hours have readings.
+             */
+            float nowcast() const {
+                return nowcastValue;
+            }
+
+        private:
+            StatLevel<MINUTE_BUCKETS> secondLevel;
+            StatLevel<WINDOW_MINUTES> minuteLevel;
+            StatLevel<DAY_HOURS> hourLevel;
+            uint8_t secondsClosed;
+            uint8_t minutesClosed;
+            bool started;
+            unsigned long bucketStart;
+            unsigned long lastSampleAt;
+            float nowcastValue;
+
+            static void updateEma(float &ema, uint16_t value, unsigned long dt, unsigned long tau) {
+                // First-order approximation of 1 - exp(-dt / tau), exact enough for dt << tau.
+                float alpha = (float)dt / (float)(tau + dt);
+                ema += alpha * ((float)value - ema);
+            }
+
+            void closeBucket() {
+                secondLevel.close(&minuteLevel.current);
+                if (++secondsClosed < MINUTE_BUCKETS) {
+                    return;
+                }
+                secondsClosed = 0;
+                this->closeMinute();
+            }
+
+            void closeMinute() {
+                minuteLevel.close(&hourLevel.current);
+                if (++minutesClosed < HOUR_MINUTES) {
+                    return;
+                }
+                minutesClosed = 0;
+                hourLevel.close(nullptr);
+                this->updateNowCast();
+            }
+
+            /**
+             * @brief Closes `count` empty 5 s buckets with at most 12 + 60 + 24 + 60 + 12 closes.
+             */
+            void skipEmptyBuckets(unsigned long count) {
+                while (count > 0 && secondsClosed != 0) {
+                    this->closeBucket();
+                    count--;
+                }
+                unsigned long minutes = count / MINUTE_BUCKETS;
+                if (minutes > 0) {
+                    // A whole empty minute expires every 5 s bucket.
+                    secondLevel.ring.clear();
+                    this->skipEmptyMinutes(minutes);
+                }
+                for (count %= MINUTE_BUCKETS; count > 0; --count) {
+                    this->closeBucket();
+                }
+            }
+
+            void skipEmptyMinutes(unsigned long count) {
+                while (count > 0 && minutesClosed != 0) {
+                    this->closeMinute();
+                    count--;
+                }
+                unsigned long hours = count / HOUR_MINUTES;
+                if (hours > 0) {
+                    // A whole empty hour expires every minute bucket; `advance()` never skips a day.
+                    minuteLevel.ring.clear();
+                    for (unsigned long idx = 0; idx < hours; ++idx) {
+                        hourLevel.close(nullptr);
+                    }
+                    this->updateNowCast();
+                }
+                for (count %= HOUR_MINUTES; count > 0; --count) {
+                    this->closeMinute();
+                }
+            }
+
+            void updateNowCast() {
+                const StatBucketRing<DAY_HOURS> &hours = hourLevel.ring;
+                uint8_t recentValid = 0;
+                uint16_t minValue = StatBucket::EMPTY;
+                uint16_t maxValue = 0;
+                for (uint8_t age = 0; age < 12; ++age) {
+                    const StatBucket &hour = hours.recent(age);
+                    if (hour.mean == StatBucket::EMPTY) {
+                        continue;
+                    }
+                    if (age < 3) {
+                        recentValid++;
+                    }
+                    if (hour.mean < minValue) {
+                        minValue = hour.mean;
+                    }
+                    if (hour.mean > maxValue) {
+                        maxValue = hour.mean;
+                    }
+                }
+                if (recentValid < 2) {
+                    nowcastValue = -1;
+                    return;
+                }
+
+                float factor = maxValue == 0 ? 1.0f : (float)minValue / maxValue;
+                if (factor < 0.5f) {
+                    factor = 0.5f;
+                }
+                float weight = 1.0f;
+                float weighted = 0;
+                float weights = 0;
+                for (uint8_t age = 0; age < 12; ++age) {
+                    const StatBucket &hour = hours.recent(age);
+                    if (hour.mean != StatBucket::EMPTY) {
+                        weighted += weight * hour.mean;
+                        weights += weight;
+                    }
+                    weight *= factor;
+                }
+                nowcastValue = weighted / weights;
+            }
+    };
+
+}
+
+#endif
@@ -0,0 +1,482 @@
+#ifndef AIR_QUALITY_SENSOR_FEATURES_H
+#define AIR_QUALITY_SENSOR_FEATURES_H
+#include "Arduino.h"
+#include "ByteRingBuffer.h"
+#include "DeadbandFilter.h"
+#include "FrameCadence.h"
+#include "ReadingLatch.h"
+
+namespace debuguear {
+
+    /**
+     * @brief Optional parts of `AirQualitySensor`, combined into its `FEATURES` template argument.
+     *
+     * A feature left out costs neither RAM nor flash; its methods fail to compile.
+     */
+    enum SensorFeature : uint8_t {
+        SENSOR_FEATURE_STATS = 0x01,        // `stats()`: parser counters and notify latency
+        SENSOR_FEATURE_BACKLOG = 0x02,      // `setBacklogPolicy()`
+        SENSOR_FEATURE_DISPATCH = 0x04,     // `DISPATCH_EVERY_NTH`, `DISPATCH_DEFERRED` and `dispatch()`
+        SENSOR_FEATURE_COMMANDS = 0x08,     // `sendCommand()` and friends, acknowledgement tracking
+        SENSOR_FEATURE_DEADBAND = 0x10,     // `setDeadband()`
+        SENSOR_FEATURE_CADENCE = 0x20,      // `nextExpectedFrameAt()`, `sleepUntilNextFrame()`
+        SENSOR_FEATURE_SNAPSHOT = 0x40,     // `latestReading()`, readable from other tasks and ISRs
+        SENSOR_FEATURES_NONE = 0x00,
+        SENSOR_FEATURES_DEFAULT = SENSOR_FEATURE_DISPATCH,
+        SENSOR_FEATURES_ALL = 0x7F
+    };
+
+    static constexpr uint8_t DEFAULT_MAX_OBSERVERS = 4;    // of the `*_PROCESSOR_T` types
+    static constexpr uint8_t FULL_MAX_OBSERVERS = 10;      // of the `*_FULL_PROCESSOR_T` types
+
+    /**
+     * @brief When an observer is called, relative to the frame that produced the reading.
+     */
+    enum DispatchPolicy : uint8_t {
+        DISPATCH_IMMEDIATE,     // for every frame, from inside `loop()`/`poll()`
+        DISPATCH_EVERY_NTH,     // for one frame out of every `n`, from inside `loop()`/`poll()`
+        DISPATCH_DEFERRED       // from `dispatch()`, with the latest reading
+    };
+
+    /**
+     * @brief Which of the frames queued up during a stall are notified, see `setBacklogPolicy()`.
+     */
+    enum BacklogPolicy : uint8_t {
+        BACKLOG_ALL_FRAMES,     // every frame, in order
+        BACKLOG_LATEST_WINS     // only the newest frame found by each `loop()`/`poll()` call
+    };
+
+    /**
+     * @brief Parser health counters of a processor, see `AirQualitySensor::stats()`.
+     */
+    struct ProcessorStats {
+        uint32_t framesOk;          // valid data frames, deadband-suppressed ones included
+        uint32_t framesSuperseded;  // valid frames replaced by a newer one under `BACKLOG_LATEST_WINS`
+        uint32_t headerErrors;      // 0x42 not followed by 0x4D
+        uint32_t lengthErrors;      // header followed by an unexpected length
+        uint32_t checksumErrors;
+        uint32_t bytesDiscarded;    // bytes that were not part of a valid frame or acknowledgement
+        uint32_t overruns;          // bytes lost before reaching the parser, see `stats()`
+        uint32_t latencySamples;
+        uint32_t latencyMinUs;      // first frame byte parsed to observers notified
+        uint32_t latencyAvgUs;
+        uint32_t latencyMaxUs;
+    };
+
+    /**
+     * The building blocks of `AirQualitySensor`, one per `SensorFeature`.
+     *
+     * The processor inherits from each of them. A disabled part is an empty class with inline
+     * no-op hooks, so the empty base optimization removes its storage and the compiler its calls.
+     */
+    namespace features {
+
+        template <bool ENABLED>
+        class ParserStats {
+            protected:
+                ParserStats() : frameStartUs(0), frameSeen(false) {
+                    this->resetCounters(0);
+                }
+
+                void resetCounters(ring_index_t ringOverruns) {
+                    memset(&this->counters, 0, sizeof(this->counters));
+                    this->latencySumUs = 0;
+                    this->overrunBase = ringOverruns;
+                }
+
+                ProcessorStats snapshot(const ByteRingBuffer *ring) const {
+                    ProcessorStats result = this->counters;
+                    if (ring != nullptr) {
+                        result.overruns = (uint32_t)(ring_index_t)(ring->overrunCount() - this->overrunBase);
+                    }
+                    result.latencyAvgUs = result.latencySamples != 0 ? (uint32_t)(this->latencySumUs / result.latencySamples) : 0;
+                    return result;
+                }
+
+                void countDiscarded(size_t bytes) { this->counters.bytesDiscarded += bytes; }
+                void countHeaderError() { this->counters.headerErrors++; }
+                void countLengthError() { this->counters.lengthErrors++; }
+                void countChecksumError() { this->counters.checksumErrors++; }
+                void countFrameOk() { this->counters.framesOk++; }
+                void countSuperseded() { this->counters.framesSuperseded++; }
+                void countOverrun() { this->counters.overruns++; }
+                void markFrameStart() { this->frameStartUs = micros(); }
+                unsigned long frameStart() const { return this->frameStartUs; }
+
+                /**
+                 * @brief Ring path: stamps the candidate at the head of the ring the first time a
+                 *        poll sees its header, until `forgetFrameSeen()`.
+                 */
+                void markFrameSeen() {
+                    if (!this->frameSeen) {
+                        this->frameStartUs = micros();
+                        this->frameSeen = true;
+                    }
+                }
+
+                void forgetFrameSeen() { this->frameSeen = false; }
+
+                void recordLatency(unsigned long startUs) {
+                    uint32_t latency = (uint32_t)(micros() - startUs);
+                    if (this->counters.latencySamples == 0 || latency < this->counters.latencyMinUs) {
+                        this->counters.latencyMinUs = latency;
+                    }
+                    if (latency > this->counters.latencyMaxUs) {
+                        this->counters.latencyMaxUs = latency;
+                    }
+                    this->counters.latencySamples++;
+                    this->latencySumUs += latency;
+                }
+
+            private:
+                ProcessorStats counters;
+                uint64_t latencySumUs;
+                ring_index_t overrunBase;
+                unsigned long frameStartUs;
+                bool frameSeen;
+        };
+
+        template <>
+        class ParserStats<false> {
+            protected:
+                void resetCounters(ring_index_t) {}
+
+                ProcessorStats snapshot(const ByteRingBuffer *) const {
+                    ProcessorStats result;
+                    memset(&result, 0, sizeof(result));
+                    return result;
+                }
+
+                void countDiscarded(size_t) {}
+                void countHeaderError() {}
+                void countLengthError() {}
+                void countChecksumError() {}
+                void countFrameOk() {}
+                void countSuperseded() {}
+                void countOverrun() {}
+                void markFrameStart() {}
+                unsigned long frameStart() const { return 0; }
+                void markFrameSeen() {}
+                void forgetFrameSeen() {}
+                void recordLatency(unsigned long) {}
+        };
+
+        template <bool ENABLED, uint8_t FRAME_LENGTH>
+        class LatestFrame {
+            protected:
+                LatestFrame() : backlogPolicy(BACKLOG_ALL_FRAMES), hasLatest(false), latestStartUs(0) {}
+
+                void setPolicy(BacklogPolicy policy) {
+                    this->backlogPolicy = policy;
+                }
+
+                bool keepsLatestOnly() const {
+                    return this->backlogPolicy == BACKLOG_LATEST_WINS;
+                }
+
+                /**
+                 * @return `true` if a frame kept earlier was replaced.
+                 */
+                bool keepLatest(const uint8_t *frame, unsigned long startUs) {
+                    bool replaced = this->hasLatest;
+                    memcpy(this->latestFrame, frame, FRAME_LENGTH);
+                    this->latestStartUs = startUs;
+                    this->hasLatest = true;
+                    return replaced;
+                }
+
+                /**
+                 * @return The kept frame, or `nullptr` if there is none.
+                 */
+                const uint8_t *takeLatest(unsigned long *startUs) {
+                    if (!this->hasLatest) {
+                        return nullptr;
+                    }
+                    this->hasLatest = false;
+                    *startUs = this->latestStartUs;
+                    return this->latestFrame;
+                }
+
+            private:
+                BacklogPolicy backlogPolicy;
+                bool hasLatest;
+                unsigned long latestStartUs;
+                uint8_t latestFrame[FRAME_LENGTH];
+        };
+
+        template <uint8_t FRAME_LENGTH>
+        class LatestFrame<false, FRAME_LENGTH> {
+            protected:
+                void setPolicy(BacklogPolicy) {}
+                bool keepsLatestOnly() const { return false; }
+                bool keepLatest(const uint8_t *, unsigned long) { return false; }
+                const uint8_t *takeLatest(unsigned long *) { return nullptr; }
+        };
+
+        /**
+         * @brief Observer table. With dispatch policies, deferred observers read a copy of the
+         *        reading taken when it is notified, which immediate observers cannot modify.
+         */
+        template <typename Layout, uint8_t MAX_OBSERVERS, bool DISPATCH>
+        class Observers {
+            public:
+                typedef typename Layout::Model Model;
+                typedef void (*ObserverFn)(Model *data);
+                typedef void (*ContextObserverFn)(void *context, const Model *data);
+
+            protected:
+                Observers() : maxHandlers(0), observersCount(0) {
+                    this->deferredData.clean();
+                }
+
+                bool insert(ObserverFn plain, ContextObserverFn withContext, void *context, DispatchPolicy policy, uint8_t every) {
+                    if (this->observersCount >= this->maxHandlers) {
+                        return false;
+                    }
+                    Observer &observer = this->observers[this->observersCount++];
+                    observer.plain = plain;
+                    observer.withContext = withContext;
+                    observer.context = context;
+                    observer.policy = policy;
+                    observer.every = every;
+                    observer.countdown = every;
+                    observer.pending = false;
+                    return true;
+                }
+
+                /**
+                 * @brief Calls the deferred observers flagged since the last call.
+                 */
+                size_t dispatchPending() {
+                    size_t called = 0;
+                    for (uint8_t idx = 0; idx < this->observersCount; ++idx) {
+                        Observer &observer = this->observers[idx];
+                        if (observer.pending) {
+                            observer.pending = false;
+                            observer.withContext(observer.context, &this->deferredData);
+                            called++;
+                        }
+                    }
+                    return called;
+                }
+
+                /**
+                 * @brief Notifies the observers of `data`, according to their policy.
+                 *
+                 * Immediate and every-n-th observers are called right away. Deferred observers are
+                 * only flagged, and a copy of the reading is kept for the next `dispatch()`: it is
+                 * taken before any observer runs, since plain observers get a mutable pointer.
+                 *
+                 * @note Observers must not add or remove observers while being notified.
+                 */
+                void notifyObservers(Model *data) {
+                    for (uint8_t idx = 0; idx < this->observersCount; ++idx) {
+                        if (this->observers[idx].policy == DISPATCH_DEFERRED) {
+                            this->deferredData = *data;
+                            break;
+                        }
+                    }
+                    for (uint8_t idx = 0; idx < this->observersCount; ++idx) {
+                        Observer &observer = this->observers[idx];
+                        switch (observer.policy) {
+                            case DISPATCH_DEFERRED:
+                                observer.pending = true;
+                                continue;
+                            case DISPATCH_EVERY_NTH:
+                                if (--observer.countdown != 0) {
+                                    continue;
+                                }
+                                observer.countdown = observer.every;
+                                break;
+                            default:
+                                break;
+                        }
+                        if (observer.plain != nullptr) {
+                            observer.plain(data);
+                        } else {
+                            observer.withContext(observer.context, data);
+                        }
+                    }
+                }
+
+                struct Observer {
+                    ObserverFn plain;
+                    ContextObserverFn withContext;
+                    void *context;
+                    DispatchPolicy policy;
+                    uint8_t every;
+                    uint8_t countdown;
+                    bool pending;
+                };
+
+                Observer observers[MAX_OBSERVERS];
+                uint8_t maxHandlers;
+                uint8_t observersCount;
+
+            private:
+                Model deferredData;
+        };
+
+        template <typename Layout, uint8_t MAX_OBSERVERS>
+        class Observers<Layout, MAX_OBSERVERS, false> {
+            public:
+                typedef typename Layout::Model Model;
+                typedef void (*ObserverFn)(Model *data);
+                typedef void (*ContextObserverFn)(void *context, const Model *data);
+
+            protected:
+                Observers() : maxHandlers(0), observersCount(0) {}
+
+                bool insert(ObserverFn plain, ContextObserverFn withContext, void *context, DispatchPolicy policy, uint8_t) {
+                    if (policy != DISPATCH_IMMEDIATE || this->observersCount >= this->maxHandlers) {
+                        return false;
+                    }
+                    Observer &observer = this->observers[this->observersCount++];
+                    observer.plain = plain;
+                    observer.withContext = withContext;
+                    observer.context = context;
+                    return true;
+                }
+
+                size_t dispatchPending() {
+                    return 0;
+                }
+
+                void notifyObservers(Model *data) {
+                    for (uint8_t idx = 0; idx < this->observersCount; ++idx) {
+                        Observer &observer = this->observers[idx];
+                        if (observer.plain != nullptr) {
+                            observer.plain(data);
+                        } else {
+                            observer.withContext(observer.context, data);
+                        }
+                    }
+                }
+
+                struct Observer {
+                    ObserverFn plain;
+                    ContextObserverFn withContext;
+                    void *context;
+                };
+
+                Observer observers[MAX_OBSERVERS];
+                uint8_t maxHandlers;
+                uint8_t observersCount;
+        };
+
+        template <bool ENABLED>
+        class CommandLink {
+            protected:
+                CommandLink() : commandSink(nullptr), acksCount(0), lastAckCommand(0), lastAckData(0) {}
+
+                void setCommandSink(Print *sink) {
+                    this->commandSink = sink;
+                }
+
+                void recordAck(const uint8_t *ack) {
+                    this->acksCount++;
+                    this->lastAckCommand = ack[4];
+                    this->lastAckData = ack[5];
+                }
+
+                Print *commandSink;
+                uint32_t acksCount;
+                uint8_t lastAckCommand;
+                uint8_t lastAckData;
+        };
+
+        template <>
+        class CommandLink<false> {
+            protected:
+                void setCommandSink(Print *) {}
+                void recordAck(const uint8_t *) {}
+        };
+
+        template <bool ENABLED, typename Layout>
+        class DeadbandHook {
+            protected:
+                DeadbandHook() : deadband(nullptr) {}
+
+                void setFilter(DeadbandFilter<Layout> *filter) {
+                    this->deadband = filter;
+                    if (filter != nullptr) {
+                        filter->reset();
+                    }
+                }
+
+                bool passesDeadband(const uint8_t *frame, unsigned long now) {
+                    return this->deadband == nullptr || this->deadband->accept(frame, now);
+                }
+
+            private:
+                DeadbandFilter<Layout> *deadband;
+        };
+
+        template <typename Layout>
+        class DeadbandHook<false, Layout> {
+            protected:
+                void setFilter(DeadbandFilter<Layout> *) {}
+                bool passesDeadband(const uint8_t *, unsigned long) { return true; }
+        };
+
+        template <bool ENABLED>
+        class CadenceTracker {
+            protected:
+                CadenceTracker() : lastPollMs(0) {}
+
+                /**
+                 * @brief Called at the end of every poll, `now` being its `millis()` time.
+                 */
+                void trackPoll(unsigned long now, bool frameFound) {
+                    if (frameFound) {
+                        this->cadence.recordArrival(now, now - this->lastPollMs);
+                    }
+                    this->lastPollMs = now;
+                }
+
+                /**
+                 * @brief Called by the polls that return early, finding no byte at all.
+                 */
+                void trackIdlePoll() {
+                    this->lastPollMs = millis();
+                }
+
+                FrameCadence cadence;
+
+            private:
+                unsigned long lastPollMs;
+        };
+
+        template <>
+        class CadenceTracker<false> {
+            protected:
+                void trackPoll(unsigned long, bool) {}
+                void trackIdlePoll() {}
+        };
+
+        template <bool ENABLED, typename Layout>
+        class LatestReading {
+            protected:
+                /**
+                 * @brief Called for every valid data frame notified, deadband-suppressed ones included.
+                 */
+                void publishReading(const uint8_t *frame, unsigned long now) {
+                    typename Layout::Model data;
+                    Layout::decode(frame, &data);
+                    this->latest.publish(data, now);
+                }
+
+                ReadingLatch<typename Layout::Model> latest;
+        };
+
+        template <typename Layout>
+        class LatestReading<false, Layout> {
+            protected:
+                void publishReading(const uint8_t *, unsigned long) {}
+        };
+
+    }
+
+}
+
+#endif
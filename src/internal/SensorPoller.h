@@ -0,0 +1,110 @@
+#ifndef AIR_QUALITY_SENSOR_POLLER_H
+#define AIR_QUALITY_SENSOR_POLLER_H
+#include "Arduino.h"
+#include "AirQualityPMSProcessor.h"
+
+namespace debuguear {
+
+    /**
+     * @brief Services several PMS processors from a single main loop.
+     *
+     * Each `tick()` visits the registered processors round-robin and lets every one of them
+     * consume at most `bytesPerSensor` bytes. An optional time budget ends the tick early; the
+     * next tick then resumes with the first sensor that was not serviced, so every sensor is
+     * visited within a bounded number of ticks whatever the others are doing. A chatty or
+     * desynchronized sensor therefore cannot starve the rest.
+     *
+     * Processors of different sensor types can be mixed; they are stored as a pointer plus a
+     * small function pointer thunk, without virtual calls.
+     *
+     * @tparam MAX_SENSORS Maximum number of processors that can be registered.
+     *
+     * @example
+     * ```cpp
+     * debuguear::PMS5003T_PROCESSOR_T indoor(&Serial1, 1);
+     * debuguear::PMS5003_PROCESSOR_T outdoor(&Serial2, 1);
+     * debuguear::SensorPoller<4> poller(64, 2000);
+     *
+     * void setup() {
+     *     poller.add(indoor);
+     *     poller.add(outdoor);
+     * }
+     *
+     * void loop() {
+     *     poller.tick();
+     * }
+     * ```
+     */
+    template <uint8_t MAX_SENSORS>
+    class SensorPoller {
+        public:
+
+            /**
+             * @param bytesPerSensor Maximum number of bytes each sensor may consume per tick.
+             *                       At least one frame length keeps latency to one tick.
+             * @param timeBudgetMicros Maximum duration of a tick in microseconds, 0 for no limit.
+             */
+            SensorPoller(size_t bytesPerSensor, unsigned long timeBudgetMicros = 0)
+                : bytesPerSensor(bytesPerSensor), timeBudgetMicros(timeBudgetMicros), count(0), next(0) {}
+
+            /**
+             * @brief Registers a processor. It must outlive the poller.
+             *
+             * @return `false` if `MAX_SENSORS` processors are already registered.
+             */
+            template <typename Layout, uint8_t MAX_OBSERVERS, uint8_t FEATURES>
+            bool add(AirQualitySensor<Layout, MAX_OBSERVERS, FEATURES> &sensor) {
+                typedef AirQualitySensor<Layout, MAX_OBSERVERS, FEATURES> Sensor;
+                if (count >= MAX_SENSORS) {
+                    return false;
+                }
+                sensors[count].sensor = &sensor;
+                sensors[count].poll = &SensorPoller::pollThunk<Sensor>;
+                count++;
+                return true;
+            }
+
+            /**
+             * @brief Services the registered sensors once, within the byte and time budgets.
+             *
+             * @return The total number of bytes consumed.
+             */
+            size_t tick() {
+                size_t consumed = 0;
+                unsigned long start = micros();
+                for (uint8_t visited = 0; visited < count; ++visited) {
+                    Entry &entry = sensors[next];
+                    next = (uint8_t)((next + 1) % count);
+                    consumed += entry.poll(entry.sensor, bytesPerSensor);
+                    if (timeBudgetMicros != 0 && (unsigned long)(micros() - start) >= timeBudgetMicros) {
+                        break;
+                    }
+                }
+                return consumed;
+            }
+
+            uint8_t size() const {
+                return count;
+            }
+
+        private:
+            struct Entry {
+                void *sensor;
+                size_t (*poll)(void *sensor, size_t maxBytes);
+            };
+
+            template <typename Sensor>
+            static size_t pollThunk(void *sensor, size_t maxBytes) {
+                return static_cast<Sensor *>(sensor)->poll(maxBytes);
+            }
+
+            Entry sensors[MAX_SENSORS];
+            size_t bytesPerSensor;
+            unsigned long timeBudgetMicros;
+            uint8_t count;
+            uint8_t next;
+    };
+
+}
+
+#endif
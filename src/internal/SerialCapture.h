@@ -0,0 +1,349 @@
+#ifndef AIR_QUALITY_SENSOR_SERIAL_CAPTURE_H
+#define AIR_QUALITY_SENSOR_SERIAL_CAPTURE_H
+#include "Arduino.h"
+#include "BinaryLog.h"
+
+namespace debuguear {
+
+    /**
+     * Capture format
+     * --------------
+     *
+     *     'P' 'M' 'S' 'C'  version  record*
+     *
+     * Each record is one burst of raw sensor bytes: a varint with the microseconds elapsed since
+     * the previous record (since the start of the capture for the first one), a varint length,
+     * then the bytes. A record truncated by a power loss is replayed up to the end of the file.
+     *
+     * Timestamps come from `micros()`, so a silence longer than 71 minutes is recorded modulo
+     * 2^32 µs. The bytes and their order are always exact.
+     */
+    namespace capture {
+        static constexpr uint8_t MAGIC[4] = {'P', 'M', 'S', 'C'};
+        static constexpr uint8_t VERSION = 1;
+        static constexpr uint8_t HEADER_LENGTH = 5;
+    }
+
+    /**
+     * @brief Encoder of raw serial captures (see above) to any `Print`.
+     *
+     * The header is written with the first record, so the sink (an SD card file, a TCP client,
+     * ...) can be opened after the writer is constructed.
+     */
+    class CaptureWriter {
+        public:
+            explicit CaptureWriter(Print &sink) : out(&sink), started(false), lastMicros(0), bytesCount(0) {}
+
+            /**
+             * @brief Appends a burst of bytes received at `timestampUs` (`micros()`).
+             *
+             * @return The number of bytes handed to the sink.
+             */
+            size_t record(const uint8_t *data, size_t length, uint32_t timestampUs) {
+                if (length == 0) {
+                    return 0;
+                }
+                size_t written = 0;
+                if (!this->started) {
+                    written += this->out->write(capture::MAGIC, sizeof(capture::MAGIC));
+                    written += this->out->write(capture::VERSION);
+                    this->lastMicros = timestampUs;
+                    this->started = true;
+                }
+                uint8_t header[10];
+                uint8_t headerLength = binarylog::putVarint(header, timestampUs - this->lastMicros);
+                headerLength += binarylog::putVarint(&header[headerLength], (uint32_t)length);
+                this->lastMicros = timestampUs;
+                written += this->out->write(header, headerLength);
+                written += this->out->write(data, length);
+                this->bytesCount += length;
+                return written;
+            }
+
+            /**
+             * @brief Sensor bytes recorded since construction, framing excluded.
+             */
+            uint32_t bytesRecorded() const {
+                return this->bytesCount;
+            }
+
+        private:
+            Print *out;
+            bool started;
+            uint32_t lastMicros;
+            uint32_t bytesCount;
+    };
+
+    /**
+     * @brief `Stream` passing a sensor stream through to the processor while recording every
+     *        byte it consumes, with the `micros()` time it was read.
+     *
+     * Bytes read one at a time (the `readBytes` of AVR cores does that) are grouped into one
+     * record until the source runs dry or `PENDING_LENGTH` bytes are pending. The timestamps
+     * are those of the reads, i.e. they include the loop latency. Writes (PMS commands) go to
+     * the sensor and are not recorded.
+     *
+     * @example
+     * ```cpp
+     * File captureFile = SD.open("pms.cap", FILE_WRITE);
+     * debuguear::CaptureWriter captureWriter(captureFile);
+     * debuguear::CaptureStream pmsCapture(Serial1, captureWriter);
+     * debuguear::PMS5003T_PROCESSOR_T processor(&pmsCapture, 1);
+     * ```
+     */
+    class CaptureStream : public Stream {
+        public:
+            static constexpr uint8_t PENDING_LENGTH = 32;
+
+            CaptureStream(Stream &source, CaptureWriter &writer)
+                : source(&source), writer(&writer), pendingLength(0), pendingMicros(0) {}
+
+            int available() override {
+                return this->source->available();
+            }
+
+            int read() override {
+                int c = this->source->read();
+                if (c < 0) {
+                    this->flushCapture();
+                    return c;
+                }
+                if (this->pendingLength == 0) {
+                    this->pendingMicros = micros();
+                }
+                this->pending[this->pendingLength++] = (uint8_t)c;
+                if (this->pendingLength == PENDING_LENGTH || this->source->available() <= 0) {
+                    this->flushCapture();
+                }
+                return c;
+            }
+
+            int peek() override {
+                return this->source->peek();
+            }
+
+            size_t readBytes(uint8_t *buffer, size_t length) {
+                this->flushCapture();
+                size_t received = this->source->readBytes(buffer, length);
+                this->writer->record(buffer, received, micros());
+                return received;
+            }
+
+            size_t readBytes(char *buffer, size_t length) {
+                return this->readBytes((uint8_t *)buffer, length);
+            }
+
+            size_t write(uint8_t c) override {
+                return this->source->write(c);
+            }
+
+            size_t write(const uint8_t *buffer, size_t size) override {
+                return this->source->write(buffer, size);
+            }
+
+            using Print::write;
+
+            /**
+             * @brief Records the bytes still grouped by `read()`.
+             */
+            void flushCapture() {
+                if (this->pendingLength != 0) {
+                    this->writer->record(this->pending, this->pendingLength, this->pendingMicros);
+                    this->pendingLength = 0;
+                }
+            }
+
+        private:
+            Stream *source;
+            CaptureWriter *writer;
+            uint8_t pending[PENDING_LENGTH];
+            uint8_t pendingLength;
+            uint32_t pendingMicros;
+    };
+
+    enum ReplaySpeed : uint16_t {
+        REPLAY_AS_FAST_AS_POSSIBLE = 0,
+        REPLAY_REAL_TIME = 1
+    };
+
+    /**
+     * @brief `Stream` feeding a capture back to a processor, meant for host regression and
+     *        performance runs.
+     *
+     * With `REPLAY_AS_FAST_AS_POSSIBLE` every byte is available at once; otherwise a burst
+     * becomes available once `micros()` since the first `available()` call, multiplied by
+     * `speed`, reaches its recorded time. Replay pacing follows the native shim's virtual clock
+     * when it is enabled.
+     *
+     * @example
+     * ```cpp
+     * std::vector<uint8_t> bytes = readFile("field.cap");
+     * debuguear::ReplayStream replay(bytes.data(), bytes.size());
+     * debuguear::PMS5003T_PROCESSOR_T processor(&replay, 1);
+     * while (!replay.finished()) {
+     *     processor.loop();
+     * }
+     * ```
+     */
+    class ReplayStream : public Stream {
+        public:
+            /**
+             * @param bytes Capture bytes, header included. They must outlive the stream.
+             * @param speed `REPLAY_AS_FAST_AS_POSSIBLE`, `REPLAY_REAL_TIME` or a factor N for N× speed.
+             */
+            ReplayStream(const uint8_t *bytes, size_t length, uint16_t speed = REPLAY_AS_FAST_AS_POSSIBLE)
+                : data(bytes), size(length), speed(speed), readPos(0), readRemaining(0), releasePos(0),
+                  released(0), releaseTimeUs(0), clockStarted(false), lastMicros(0), elapsedUs(0) {
+                bool headerOk = length >= capture::HEADER_LENGTH && bytes[4] == capture::VERSION &&
+                                memcmp(bytes, capture::MAGIC, sizeof(capture::MAGIC)) == 0;
+                this->valid = headerOk;
+                this->readPos = this->releasePos = headerOk ? capture::HEADER_LENGTH : length;
+            }
+
+            /**
+             * @return `false` if the data does not start with a capture header; the stream is then empty.
+             */
+            bool isValid() const {
+                return this->valid;
+            }
+
+            /**
+             * @return `true` once every recorded byte was read.
+             */
+            bool finished() const {
+                return this->releasePos >= this->size && this->released == 0;
+            }
+
+            /**
+             * @brief Recorded time of the last burst made available, in µs since the first one.
+             */
+            uint64_t replayedMicros() const {
+                return this->releaseTimeUs;
+            }
+
+            int available() override {
+                this->release();
+                return this->released > 0x7FFF ? 0x7FFF : (int)this->released;
+            }
+
+            int read() override {
+                uint8_t c;
+                return this->readBytes(&c, 1) == 1 ? c : -1;
+            }
+
+            int peek() override {
+                this->release();
+                if (this->released == 0) {
+                    return -1;
+                }
+                this->enterRecord();
+                return this->data[this->readPos];
+            }
+
+            size_t readBytes(uint8_t *buffer, size_t length) {
+                this->release();
+                size_t count = 0;
+                while (count < length && this->released != 0) {
+                    this->enterRecord();
+                    size_t chunk = this->readRemaining < length - count ? this->readRemaining : length - count;
+                    memcpy(buffer + count, this->data + this->readPos, chunk);
+                    count += chunk;
+                    this->readPos += chunk;
+                    this->readRemaining -= chunk;
+                    this->released -= chunk;
+                }
+                return count;
+            }
+
+            size_t readBytes(char *buffer, size_t length) {
+                return this->readBytes((uint8_t *)buffer, length);
+            }
+
+            size_t write(uint8_t) override {
+                // A replay has no sensor to command.
+                return 1;
+            }
+
+            using Print::write;
+
+        private:
+            const uint8_t *data;
+            size_t size;
+            uint16_t speed;
+            bool valid;
+            size_t readPos;         // next byte to read
+            size_t readRemaining;   // bytes left in the record at readPos
+            size_t releasePos;      // header of the next record not yet available
+            size_t released;        // available bytes not read yet
+            uint64_t releaseTimeUs;
+            bool clockStarted;
+            uint32_t lastMicros;
+            uint64_t elapsedUs;
+
+            /**
+             * @brief Parses a record header at `pos`.
+             *
+             * @return The offset of its first byte, or 0 if the header is damaged or truncated.
+             */
+            size_t parseHeader(size_t pos, uint32_t *delta, uint32_t *length) const {
+                *length = 0;
+                const uint8_t *end = this->data + this->size;
+                int n = binarylog::getVarint(this->data + pos, end, delta);
+                if (n <= 0) {
+                    return 0;
+                }
+                int m = binarylog::getVarint(this->data + pos + n, end, length);
+                if (m <= 0) {
+                    return 0;
+                }
+                size_t first = pos + n + m;
+                if (*length > this->size - first) {
+                    *length = (uint32_t)(this->size - first);
+                }
+                return first;
+            }
+
+            void release() {
+                if (this->speed != REPLAY_AS_FAST_AS_POSSIBLE) {
+                    uint32_t now = micros();
+                    if (!this->clockStarted) {
+                        this->clockStarted = true;
+                        this->lastMicros = now;
+                    }
+                    this->elapsedUs += (uint32_t)(now - this->lastMicros);
+                    this->lastMicros = now;
+                }
+                while (this->releasePos < this->size) {
+                    uint32_t delta;
+                    uint32_t length;
+                    size_t first = this->parseHeader(this->releasePos, &delta, &length);
+                    if (first == 0) {
+                        this->releasePos = this->size;
+                        return;
+                    }
+                    uint64_t at = this->releaseTimeUs + delta;
+                    if (this->speed != REPLAY_AS_FAST_AS_POSSIBLE && at > this->elapsedUs * this->speed) {
+                        return;
+                    }
+                    this->releaseTimeUs = at;
+                    this->released += length;
+                    this->releasePos = first + length;
+                }
+            }
+
+            /**
+             * @brief Moves the read position past record headers. Only called with `released != 0`.
+             */
+            void enterRecord() {
+                while (this->readRemaining == 0) {
+                    uint32_t delta;
+                    uint32_t length;
+                    this->readPos = this->parseHeader(this->readPos, &delta, &length);
+                    this->readRemaining = length;
+                }
+            }
+    };
+
+}
+
+#endif
@@ -0,0 +1,136 @@
+#ifndef AIR_QUALITY_SENSOR_THREADED_READER_H
+#define AIR_QUALITY_SENSOR_THREADED_READER_H
+#include "Arduino.h"
+#include "Atomics.h"
+#include "Threading.h"
+#include "ReadingQueue.h"
+#include "AirQualityPMSProcessor.h"
+
+namespace debuguear {
+
+    /**
+     * @brief Runs a processor on its own FreeRTOS task (ESP32) or pthread, and publishes
+     *        every reading to a `ReadingQueue`.
+     *
+     * Parsing no longer shares a task with networking, so a Wi-Fi or TLS stall on the consumer
+     * side cannot make the sensor stream overflow: readings pile up in the queue, which drops
+     * the oldest ones when full. Several readers can publish into the same queue, and any number
+     * of consumer threads can take readings from it.
+     *
+     * Once started, the reader owns the processor: do not call its methods (commands, `loop()`,
+     * observers registration) from other threads until `stop()` returns. Observers registered
+     * before `start()` run on the reader thread.
+     *
+     * @example
+     * ```cpp
+     * debuguear::PMS5003T_PROCESSOR_T processor(&Serial1, 1);
+     * debuguear::BoundedReadingQueue<debuguear::AirQualityModel_PMS5003T, 16> readings;
+     * debuguear::ThreadedReader<debuguear::LayoutPMS5003T> reader(processor, readings);
+     *
+     * void setup() {
+     *     reader.start();
+     * }
+     *
+     * void loop() {
+     *     debuguear::AirQualityModel_PMS5003T data;
+     *     if (readings.receive(data, 5000)) {
+     *         publish(data);    // may block on the network without losing frames
+     *     }
+     * }
+     * ```
+     */
+    template <typename Layout, uint8_t MAX_OBSERVERS = DEFAULT_MAX_OBSERVERS, uint8_t FEATURES = SENSOR_FEATURES_DEFAULT>
+    class ThreadedReader {
+        public:
+            typedef AirQualitySensor<Layout, MAX_OBSERVERS, FEATURES> Sensor;
+            typedef typename Sensor::AdapteeType Model;
+
+            /**
+             * @param sensor Processor to run. Must outlive the reader.
+             * @param queue Queue receiving the readings. Must outlive the reader.
+             * @param bytesPerPoll Bytes parsed before checking for `stop()`, as in `poll()`.
+             * @param idleMs Sleep when the stream has nothing buffered. 10 ms is a third of a
+             *               frame at 9600 baud, well within a 64-byte RX buffer.
+             */
+            ThreadedReader(Sensor &sensor, ReadingQueue<Model> &queue, size_t bytesPerPoll = 64,
+                           uint32_t idleMs = 10)
+                : sensor(sensor), queue(queue), bytesPerPoll(bytesPerPoll), idleMs(idleMs), running(false),
+                  registered(false) {}
+
+            ~ThreadedReader() {
+                this->stop();
+            }
+
+            /**
+             * @brief Starts the reader thread.
+             *
+             * @return `false` if it is already running, the processor has no free observer slot,
+             *         or the thread could not be created.
+             */
+            bool start(const threading::ThreadOptions &options = defaultOptions()) {
+                if (this->thread.isStarted()) {
+                    return false;
+                }
+                if (!this->registered) {
+                    if (!this->sensor.addObserver(&ThreadedReader::publish, &this->queue)) {
+                        return false;
+                    }
+                    this->registered = true;
+                }
+                this->running.store(true);
+                if (!this->thread.start(&ThreadedReader::run, this, options)) {
+                    this->running.store(false);
+                    return false;
+                }
+                return true;
+            }
+
+            /**
+             * @brief Asks the reader thread to finish and waits for it.
+             */
+            void stop() {
+                this->running.store(false);
+                this->thread.join();
+            }
+
+            bool isRunning() const {
+                return this->thread.isStarted();
+            }
+
+            /**
+             * @brief 4 KiB of stack, priority 5 and no core affinity, named "pms-reader".
+             */
+            static threading::ThreadOptions defaultOptions() {
+                threading::ThreadOptions options = {"pms-reader", 4096, 5, -1};
+                return options;
+            }
+
+        private:
+            Sensor &sensor;
+            ReadingQueue<Model> &queue;
+            size_t bytesPerPoll;
+            uint32_t idleMs;
+            AtomicCell<bool> running;
+            bool registered;
+            threading::Thread thread;
+
+            static void publish(void *queue, const Model *data) {
+                static_cast<ReadingQueue<Model> *>(queue)->push(*data);
+            }
+
+            static void run(void *self) {
+                ThreadedReader *reader = static_cast<ThreadedReader *>(self);
+                while (reader->running.load()) {
+                    if (reader->sensor.poll(reader->bytesPerPoll) == 0) {
+                        threading::sleepMs(reader->idleMs);
+                    }
+                }
+            }
+
+            ThreadedReader(const ThreadedReader &) = delete;
+            ThreadedReader &operator=(const ThreadedReader &) = delete;
+    };
+
+}
+
+#endif
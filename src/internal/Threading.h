@@ -0,0 +1,222 @@
+#ifndef AIR_QUALITY_SENSOR_THREADING_H
+#define AIR_QUALITY_SENSOR_THREADING_H
+#include "Arduino.h"
+
+#if defined(ESP_PLATFORM) || defined(ARDUINO_ARCH_ESP32)
+    #include <freertos/FreeRTOS.h>
+    #include <freertos/task.h>
+    #include <freertos/semphr.h>
+    #define AIR_QUALITY_THREADS_FREERTOS 1
+#elif defined(__unix__) || defined(__APPLE__)
+    #include <pthread.h>
+    #include <errno.h>
+    #include <limits.h>
+    #include <time.h>
+    #define AIR_QUALITY_THREADS_PTHREADS 1
+    #if defined(__APPLE__)
+        // No pthread_condattr_setclock: timed waits can only follow the wall clock.
+        #define AIR_QUALITY_THREADS_WAIT_CLOCK CLOCK_REALTIME
+    #else
+        #define AIR_QUALITY_THREADS_WAIT_CLOCK CLOCK_MONOTONIC
+    #endif
+#else
+    #error "Threaded readers need FreeRTOS (ESP32) or pthreads"
+#endif
+
+namespace debuguear {
+
+    namespace threading {
+
+        static constexpr uint32_t WAIT_FOREVER = 0xFFFFFFFFUL;
+
+        /**
+         * @brief Options of a reader thread. `priority` and `core` only apply to FreeRTOS;
+         *        `core` -1 lets the scheduler pick one.
+         */
+        struct ThreadOptions {
+            const char *name;
+            uint32_t stackBytes;
+            uint8_t priority;
+            int8_t core;
+        };
+
+        inline void sleepMs(uint32_t ms) {
+#if defined(AIR_QUALITY_THREADS_FREERTOS)
+            TickType_t ticks = pdMS_TO_TICKS(ms);
+            vTaskDelay(ticks == 0 ? 1 : ticks);
+#else
+            struct timespec ts = {(time_t)(ms / 1000), (long)(ms % 1000) * 1000000L};
+            nanosleep(&ts, nullptr);
+#endif
+        }
+
+        /**
+         * @brief Counting semaphore saturating at `maxCount`.
+         */
+        class Semaphore {
+            public:
+                explicit Semaphore(uint32_t maxCount) {
+#if defined(AIR_QUALITY_THREADS_FREERTOS)
+                    this->handle = xSemaphoreCreateCounting(maxCount, 0);
+#else
+                    this->count = 0;
+                    this->maxCount = maxCount;
+                    pthread_mutex_init(&this->mutex, nullptr);
+                    // Timed waits must not stretch or end early when the wall clock is set.
+                    pthread_condattr_t attributes;
+                    pthread_condattr_init(&attributes);
+#if !defined(__APPLE__)
+                    pthread_condattr_setclock(&attributes, AIR_QUALITY_THREADS_WAIT_CLOCK);
+#endif
+                    pthread_cond_init(&this->cond, &attributes);
+                    pthread_condattr_destroy(&attributes);
+#endif
+                }
+
+                ~Semaphore() {
+#if defined(AIR_QUALITY_THREADS_FREERTOS)
+                    vSemaphoreDelete(this->handle);
+#else
+                    pthread_cond_destroy(&this->cond);
+                    pthread_mutex_destroy(&this->mutex);
+#endif
+                }
+
+                void give() {
+#if defined(AIR_QUALITY_THREADS_FREERTOS)
+                    xSemaphoreGive(this->handle);
+#else
+                    pthread_mutex_lock(&this->mutex);
+                    if (this->count < this->maxCount) {
+                        this->count++;
+                    }
+                    pthread_mutex_unlock(&this->mutex);
+                    pthread_cond_signal(&this->cond);
+#endif
+                }
+
+                /**
+                 * @return `false` if the semaphore was not given within `timeoutMs`.
+                 */
+                bool take(uint32_t timeoutMs) {
+#if defined(AIR_QUALITY_THREADS_FREERTOS)
+                    TickType_t ticks = timeoutMs == WAIT_FOREVER ? portMAX_DELAY : pdMS_TO_TICKS(timeoutMs);
+                    return xSemaphoreTake(this->handle, ticks) == pdTRUE;
+#else
+                    struct timespec deadline;
+                    clock_gettime(AIR_QUALITY_THREADS_WAIT_CLOCK, &deadline);
+                    deadline.tv_sec += timeoutMs / 1000;
+                    deadline.tv_nsec += (long)(timeoutMs % 1000) * 1000000L;
+                    if (deadline.tv_nsec >= 1000000000L) {
+                        deadline.tv_sec++;
+                        deadline.tv_nsec -= 1000000000L;
+                    }
+                    pthread_mutex_lock(&this->mutex);
+                    int result = 0;
+                    while (this->count == 0 && result != ETIMEDOUT) {
+                        result = timeoutMs == WAIT_FOREVER ? pthread_cond_wait(&this->cond, &this->mutex)
+                                                           : pthread_cond_timedwait(&this->cond, &this->mutex, &deadline);
+                    }
+                    bool taken = this->count != 0;
+                    if (taken) {
+                        this->count--;
+                    }
+                    pthread_mutex_unlock(&this->mutex);
+                    return taken;
+#endif
+                }
+
+            private:
+#if defined(AIR_QUALITY_THREADS_FREERTOS)
+                SemaphoreHandle_t handle;
+#else
+                uint32_t count;
+                uint32_t maxCount;
+                pthread_mutex_t mutex;
+                pthread_cond_t cond;
+#endif
+                Semaphore(const Semaphore &) = delete;
+                Semaphore &operator=(const Semaphore &) = delete;
+        };
+
+        /**
+         * @brief A FreeRTOS task or a pthread running `fn(context)` once.
+         */
+        class Thread {
+            public:
+                Thread() : fn(nullptr), context(nullptr), started(false), finished(1) {}
+
+                /**
+                 * @return `false` if the thread could not be created or is already running.
+                 */
+                bool start(void (*fn)(void *), void *context, const ThreadOptions &options) {
+                    if (this->started) {
+                        return false;
+                    }
+                    this->fn = fn;
+                    this->context = context;
+#if defined(AIR_QUALITY_THREADS_FREERTOS)
+                    BaseType_t core = options.core < 0 ? tskNO_AFFINITY : options.core;
+                    this->started = xTaskCreatePinnedToCore(&Thread::entry, options.name, options.stackBytes, this,
+                                                            options.priority, nullptr, core) == pdPASS;
+#else
+                    pthread_attr_t attributes;
+                    pthread_attr_init(&attributes);
+                    if (options.stackBytes >= PTHREAD_STACK_MIN) {
+                        pthread_attr_setstacksize(&attributes, options.stackBytes);
+                    }
+                    this->started = pthread_create(&this->handle, &attributes, &Thread::entry, this) == 0;
+                    pthread_attr_destroy(&attributes);
+#endif
+                    return this->started;
+                }
+
+                /**
+                 * @brief Waits for `fn` to return. Does nothing if the thread was never started.
+                 */
+                void join() {
+                    if (!this->started) {
+                        return;
+                    }
+#if defined(AIR_QUALITY_THREADS_FREERTOS)
+                    this->finished.take(WAIT_FOREVER);
+#else
+                    pthread_join(this->handle, nullptr);
+#endif
+                    this->started = false;
+                }
+
+                bool isStarted() const {
+                    return this->started;
+                }
+
+            private:
+                void (*fn)(void *);
+                void *context;
+                bool started;
+                Semaphore finished;
+#if defined(AIR_QUALITY_THREADS_FREERTOS)
+                static void entry(void *self) {
+                    Thread *thread = static_cast<Thread *>(self);
+                    thread->fn(thread->context);
+                    thread->finished.give();
+                    vTaskDelete(nullptr);
+                }
+#else
+                pthread_t handle;
+
+                static void *entry(void *self) {
+                    Thread *thread = static_cast<Thread *>(self);
+                    thread->fn(thread->context);
+                    return nullptr;
+                }
+#endif
+                Thread(const Thread &) = delete;
+                Thread &operator=(const Thread &) = delete;
+        };
+
+    }
+
+}
+
+#endif
@@ -0,0 +1,236 @@
+#ifndef AIRQUALITY_NATIVE_ARDUINO_SHIM_H
+#define AIRQUALITY_NATIVE_ARDUINO_SHIM_H
+
+// Minimal Arduino core stand-in used by the `native` PlatformIO environment.
+// It implements just enough of `Print`, `Stream`, `String` and the timing
+// functions for the library headers and the host test/benchmark suites.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <thread>
+
+#define DEC 10
+#define HEX 16
+#define PROGMEM
+#define F(str) (str)
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+namespace arduino_shim {
+
+    /**
+     * @brief Time source behind `millis()`/`micros()`.
+     *
+     * Runs on the host steady clock by default. Tests switch it to a virtual
+     * clock and advance it by hand, so timing-dependent code can be driven
+     * deterministically and faster than real time.
+     */
+    struct Clock {
+        bool isVirtual;
+        uint64_t virtualMicros;
+        std::chrono::steady_clock::time_point origin;
+
+        static Clock& instance() {
+            static Clock clock = {false, 0, std::chrono::steady_clock::now()};
+            return clock;
+        }
+
+        uint64_t nowMicros() const {
+            if (isVirtual) {
+                return virtualMicros;
+            }
+            return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - origin).count();
+        }
+    };
+
+    inline void useVirtualClock(uint64_t startMicros = 0) {
+        Clock::instance().isVirtual = true;
+        Clock::instance().virtualMicros = startMicros;
+    }
+
+    inline void useRealClock() {
+        Clock::instance().isVirtual = false;
+    }
+
+    inline void advanceMicros(uint64_t us) {
+        Clock::instance().virtualMicros += us;
+    }
+
+    inline uint64_t nowMicros() {
+        return Clock::instance().nowMicros();
+    }
+}
+
+inline unsigned long millis() {
+    return (unsigned long)(uint32_t)(arduino_shim::nowMicros() / 1000);
+}
+
+inline unsigned long micros() {
+    return (unsigned long)(uint32_t)arduino_shim::nowMicros();
+}
+
+inline void delayMicroseconds(unsigned int us) {
+    if (arduino_shim::Clock::instance().isVirtual) {
+        arduino_shim::advanceMicros(us);
+    } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(us));
+    }
+}
+
+inline void delay(unsigned long ms) {
+    if (arduino_shim::Clock::instance().isVirtual) {
+        arduino_shim::advanceMicros((uint64_t)ms * 1000);
+    } else {
+        std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    }
+}
+
+inline void yield() {}
+inline void interrupts() {}
+inline void noInterrupts() {}
+
+class String {
+    public:
+        String() {}
+        String(const char *str) : value(str ? str : "") {}
+        String(const std::string &str) : value(str) {}
+        String(char c) : value(1, c) {}
+        String(int v, unsigned char base = DEC) : value(format((long long)v, base)) {}
+        String(unsigned int v, unsigned char base = DEC) : value(format((unsigned long long)v, base)) {}
+        String(long v, unsigned char base = DEC) : value(format((long long)v, base)) {}
+        String(unsigned long v, unsigned char base = DEC) : value(format((unsigned long long)v, base)) {}
+        String(double v, unsigned char decimals = 2) {
+            char buf[48];
+            snprintf(buf, sizeof(buf), "%.*f", decimals, v);
+            value = buf;
+        }
+
+        const char *c_str() const { return value.c_str(); }
+        unsigned int length() const { return (unsigned int)value.size(); }
+        bool operator==(const String &other) const { return value == other.value; }
+        bool operator==(const char *other) const { return value == other; }
+        bool operator!=(const String &other) const { return value != other.value; }
+        String &operator+=(const String &other) { value += other.value; return *this; }
+        String &operator+=(const char *other) { value += other; return *this; }
+        String &operator+=(char c) { value += c; return *this; }
+
+        friend String operator+(const String &a, const String &b) { return String(a.value + b.value); }
+        friend String operator+(const char *a, const String &b) { return String(std::string(a) + b.value); }
+        friend String operator+(const String &a, const char *b) { return String(a.value + b); }
+
+    private:
+        std::string value;
+
+        static std::string format(unsigned long long v, unsigned char base) {
+            char buf[72];
+            if (base == HEX) {
+                snprintf(buf, sizeof(buf), "%llX", v);
+            } else {
+                snprintf(buf, sizeof(buf), "%llu", v);
+            }
+            return buf;
+        }
+
+        static std::string format(long long v, unsigned char base) {
+            if (v < 0 && base == DEC) {
+                return "-" + format((unsigned long long)(-v), base);
+            }
+            return format((unsigned long long)v, base);
+        }
+};
+
+class Print {
+    public:
+        virtual ~Print() {}
+        virtual size_t write(uint8_t) = 0;
+
+        virtual size_t write(const uint8_t *buffer, size_t size) {
+            size_t n = 0;
+            while (size--) {
+                if (write(*buffer++) == 0) {
+                    break;
+                }
+                n++;
+            }
+            return n;
+        }
+
+        size_t write(const char *str) {
+            return str == nullptr ? 0 : write((const uint8_t *)str, strlen(str));
+        }
+
+        size_t write(const char *buffer, size_t size) {
+            return write((const uint8_t *)buffer, size);
+        }
+
+        size_t print(const char *str) { return write(str); }
+        size_t print(const String &str) { return write(str.c_str()); }
+        size_t print(char c) { return write((uint8_t)c); }
+        size_t print(int v, int base = DEC) { return print(String(v, (unsigned char)base)); }
+        size_t print(unsigned int v, int base = DEC) { return print(String(v, (unsigned char)base)); }
+        size_t print(long v, int base = DEC) { return print(String(v, (unsigned char)base)); }
+        size_t print(unsigned long v, int base = DEC) { return print(String(v, (unsigned char)base)); }
+        size_t print(unsigned char v, int base = DEC) { return print((unsigned int)v, base); }
+        size_t print(double v, int decimals = 2) { return print(String(v, (unsigned char)decimals)); }
+
+        size_t println() { return write("\n"); }
+        template <typename V>
+        size_t println(const V &v) { size_t n = print(v); return n + println(); }
+        template <typename V>
+        size_t println(const V &v, int format) { size_t n = print(v, format); return n + println(); }
+};
+
+class Stream : public Print {
+    public:
+        virtual int available() = 0;
+        virtual int read() = 0;
+        virtual int peek() = 0;
+        virtual void flush() {}
+
+        void setTimeout(unsigned long timeout) { timeoutMs = timeout; }
+
+        // Not virtual, as in the AVR core: through a `Stream *` the processor always reads byte
+        // by byte, whatever bulk read the concrete stream has.
+        size_t readBytes(uint8_t *buffer, size_t length) {
+            size_t count = 0;
+            while (count < length) {
+                int c = read();
+                if (c < 0) {
+                    break;
+                }
+                buffer[count++] = (uint8_t)c;
+            }
+            return count;
+        }
+
+        size_t readBytes(char *buffer, size_t length) {
+            return readBytes((uint8_t *)buffer, length);
+        }
+
+    protected:
+        unsigned long timeoutMs = 1000;
+};
+
+/**
+ * @brief Host console. Writes go to stdout, nothing is ever received.
+ */
+class HostSerial : public Stream {
+    public:
+        void begin(unsigned long) {}
+        int available() override { return 0; }
+        int read() override { return -1; }
+        int peek() override { return -1; }
+        size_t write(uint8_t c) override { return fputc(c, stdout) == EOF ? 0 : 1; }
+        using Print::write;
+        operator bool() const { return true; }
+};
+
+static HostSerial Serial;
+
+#endif
@@ -2,30 +2,103 @@
 #define AIRQUALITY_TEST_FAKE_STREAM
 
 #include <Arduino.h>
+#include "FrameBuilder.h"
 
+/**
+ * @brief Stream replaying canned sensor bytes, and answering PMS commands like the sensor.
+ *
+ * - In active mode (the default) every byte is available right away.
+ * - After a passive mode command, one `frameLength` chunk is released per read command.
+ * - Mode and sleep commands are acknowledged; a sleeping sensor sends nothing.
+ * - `ignoreReads(n)` drops the next `n` read commands, to simulate lost requests.
+ */
 class FakeStream : public Stream {
 private:
     const uint8_t* data;
     size_t size;
     size_t position;
+    size_t released;
+    size_t frameLength;
+    bool passive;
+    bool asleep;
+    int dropReads;
+    uint8_t command[7];
+    uint8_t commandPos;
+    uint8_t ack[8];
+    uint8_t ackLength;
+    uint8_t ackPos;
+
+    size_t visible() const {
+        size_t limit = passive ? released : size;
+        return limit < size ? limit : size;
+    }
+
+    void handleCommand() {
+        commands++;
+        lastCommand = command[2];
+        uint8_t value = command[4];
+        bool acknowledge = false;
+        switch (command[2]) {
+            case 0xE1:
+                passive = value == 0;
+                released = position;
+                acknowledge = true;
+                break;
+            case 0xE2:
+                if (dropReads > 0) {
+                    dropReads--;
+                } else if (passive && !asleep) {
+                    released = (released < position ? position : released) + frameLength;
+                }
+                break;
+            case 0xE4:
+                asleep = value == 0;
+                acknowledge = asleep;
+                break;
+        }
+        if (acknowledge) {
+            beginPmsFrame(ack, sizeof(ack));
+            ack[4] = command[2];
+            ack[5] = value;
+            sealPmsFrame(ack, sizeof(ack));
+            ackLength = 8;
+            ackPos = 0;
+        }
+    }
 
 public:
-    FakeStream(const uint8_t* frame, size_t length) : data(frame), size(length), position(0) {}
+    int commands = 0;
+    uint8_t lastCommand = 0;
 
-    int available() override {
-        return (size - position);
+    FakeStream(const uint8_t* frame, size_t length, size_t frameLength = 32)
+        : data(frame), size(length), position(0), released(0), frameLength(frameLength),
+          passive(false), asleep(false), dropReads(0), commandPos(0), ackLength(0), ackPos(0) {}
+
+    void ignoreReads(int count) {
+        dropReads = count;
     }
 
-    size_t readBytes(uint8_t* buffer, size_t length) {
-        size_t bytesRead = 0;
-        while (bytesRead < length && available()) {
-            buffer[bytesRead++] = read();
+    bool isPassive() const {
+        return passive;
+    }
+
+    bool isAsleep() const {
+        return asleep;
+    }
+
+    int available() override {
+        int pendingAck = ackLength - ackPos;
+        if (asleep) {
+            return pendingAck;
         }
-        return bytesRead; // Ensure return value
+        return pendingAck + (int)(visible() - position);
     }
 
     int read() override {
-        if (position <= size) {
+        if (ackPos < ackLength) {
+            return ack[ackPos++];
+        }
+        if (!asleep && position < visible()) {
             return data[position++];
         } else {
             return -1; // No more data
@@ -33,7 +106,10 @@ public:
     }
 
     int peek() override {
-        if (position < size) {
+        if (ackPos < ackLength) {
+            return ack[ackPos];
+        }
+        if (!asleep && position < visible()) {
             return data[position];
         } else {
             return -1;
@@ -44,10 +120,24 @@ public:
         // No-op for FakeStream
     }
 
-     size_t write(uint8_t) override {
-        return 1; // Simulamos que siempre se escribe 1 byte correctamente
+    size_t write(uint8_t c) override {
+        // Collects `0x42 0x4D cmd dataH dataL chkH chkL` command frames.
+        if ((commandPos == 0 && c != 0x42) || (commandPos == 1 && c != 0x4D)) {
+            commandPos = 0;
+            return 1;
+        }
+        command[commandPos++] = c;
+        if (commandPos == sizeof(command)) {
+            commandPos = 0;
+            uint16_t checksum = command[0] + command[1] + command[2] + command[3] + command[4];
+            if (checksum == ((command[5] << 8) | command[6])) {
+                handleCommand();
+            }
+        }
+        return 1;
     }
 
+    using Print::write;
 };
 
-#endif
\ No newline at end of file
+#endif
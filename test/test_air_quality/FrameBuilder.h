@@ -0,0 +1,47 @@
+#ifndef AIRQUALITY_TEST_FRAME_BUILDER
+#define AIRQUALITY_TEST_FRAME_BUILDER
+
+#include <Arduino.h>
+
+/**
+ * @brief Builds PMS frames for the tests: `42 4D`, the big-endian length of the rest of the
+ *        frame, big-endian data words and the big-endian sum of every preceding byte.
+ *
+ * `length` is the whole frame: 32 bytes for a PMS5003T, 40 for a PMS5003ST, 8 for a command
+ * acknowledgement. Fill the frame with `beginPmsFrame` and `setPmsFrameWord` (or write its
+ * payload bytes directly), then close it with `sealPmsFrame`.
+ */
+static const size_t PMS5003T_FRAME_LENGTH = 32;
+
+/**
+ * @brief Writes the header of a `length` byte frame and clears its payload.
+ */
+inline void beginPmsFrame(uint8_t *frame, size_t length = PMS5003T_FRAME_LENGTH) {
+    memset(frame, 0, length);
+    frame[0] = 0x42;
+    frame[1] = 0x4D;
+    frame[2] = (uint8_t)((length - 4) >> 8);
+    frame[3] = (uint8_t)(length - 4);
+}
+
+/**
+ * @brief Stores `value` in data word `word`, the first one being right after the length.
+ */
+inline void setPmsFrameWord(uint8_t *frame, size_t word, uint16_t value) {
+    frame[4 + word * 2] = (uint8_t)(value >> 8);
+    frame[5 + word * 2] = (uint8_t)value;
+}
+
+/**
+ * @brief Writes the checksum of a `length` byte frame whose other bytes are in place.
+ */
+inline void sealPmsFrame(uint8_t *frame, size_t length = PMS5003T_FRAME_LENGTH) {
+    uint16_t checksum = 0;
+    for (size_t i = 0; i < length - 2; ++i) {
+        checksum += frame[i];
+    }
+    frame[length - 2] = (uint8_t)(checksum >> 8);
+    frame[length - 1] = (uint8_t)checksum;
+}
+
+#endif
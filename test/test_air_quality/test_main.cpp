@@ -1,8 +1,11 @@
 #define DEBUG
 #include "FakeStream.h"
+#include "FrameBuilder.h"
 #include <Arduino.h>
 #include <unity.h>
 #include "../src/PMS5003T.h"
+#include "../src/PMS5003ST.h"
+#include "../src/DeadbandFilter.h"
 
 uint8_t validFrame[32] = {
         0x42, 0x4D,  // Header (Frame Start)
@@ -29,25 +32,63 @@ debuguear::AirQualityModel_PMS5003T *PMS5003TDataPtr = &PMS5003TData;
 
 
 bool observerWasCalled = false;
+int observerCalls = 0;
 
 
-void observerFunction(debuguear::AirQualityModel_PMS5003T* data) {
+void observerFunction(debuguear::AirQualityModel_PMS5003T*) {
     observerWasCalled = true;
+    observerCalls++;
     Serial.println("Observer called!");
 }
 
 void test_pms5003t_processor_loop() {
     FakeStream fakeSerial(validFrame, sizeof(validFrame));
-    debuguear::PMS5003T_PROCESSOR_T processor = debuguear::pms5003TProcessor(&fakeSerial, (size_t)1);
+    debuguear::PMS5003T_PROCESSOR_T processor(&fakeSerial, 1);
     processor.addObserver(observerFunction);
     processor.loop();
     TEST_ASSERT_TRUE(observerWasCalled);
 }
 
 
+// The 0.0.x entry points must keep working until they are removed.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+void test_pms5003t_deprecated_entry_points() {
+    int callsBefore = observerCalls;
+    FakeStream fakeSerial(validFrame, sizeof(validFrame));
+    debuguear::PMS5003T_PROCESSOR_T &processor = debuguear::pms5003TProcessor(&fakeSerial, 1);
+    TEST_ASSERT_TRUE(&processor == &debuguear::pms5003TProcessor(&fakeSerial));
+    processor.addObserver(observerFunction);
+    processor.loop();
+    TEST_ASSERT_EQUAL(callsBefore + 1, observerCalls);
+
+    FakeStream otherSerial(validFrame, sizeof(validFrame));
+    debuguear::PMS5003T_PROCESSOR_T legacy(&otherSerial, debuguear::adapterPMS5003T, 1);
+    legacy.addObserver(observerFunction);
+    legacy.loop();
+    TEST_ASSERT_EQUAL(callsBefore + 2, observerCalls);
+}
+#pragma GCC diagnostic pop
+
+void test_pms5003t_processor_loop_resynchronizes() {
+    uint8_t stream[3 + 32 + 32 + 32];
+    stream[0] = 0x4D; // junk before the first header
+    stream[1] = 0x42;
+    stream[2] = 0x00;
+    memcpy(&stream[3], validFrame, 32);
+    memcpy(&stream[35], validFrame, 32);
+    stream[35 + 10] ^= 0xFF; // corrupt the second frame payload
+    memcpy(&stream[67], validFrame, 32);
+
+    FakeStream fakeSerial(stream, sizeof(stream));
+    debuguear::PMS5003T_FULL_PROCESSOR_T processor(&fakeSerial, 1);
+    processor.addObserver(observerFunction);
+    processor.loop();
+    TEST_ASSERT_EQUAL(2, observerCalls);
+}
 
 void test_pms5003t_processor_read_frame() {
-    debuguear::PMS5003T_PROCESSOR_T processor = debuguear::pms5003TProcessor(&Serial, 0);
+    debuguear::PMS5003T_PROCESSOR_T processor(&Serial, 0);
     
     bool result = processor.processFrame(validFrame, &PMS5003TData);
     TEST_ASSERT_TRUE(result);
@@ -57,24 +98,410 @@ void test_pms5003t_processor_read_frame() {
 }
 
 
+void test_pms5003t_decode_frames() {
+    uint8_t capture[2 + 32 + 32 + 32 + 10];
+    capture[0] = 0x42; // stray header byte
+    capture[1] = 0x00;
+    memcpy(&capture[2], validFrame, 32);
+    memcpy(&capture[34], validFrame, 32);
+    capture[34 + 31] ^= 0x01; // bad checksum
+    memcpy(&capture[66], validFrame, 32);
+    memcpy(&capture[98], validFrame, 10); // trailing partial frame
+
+    debuguear::AirQualityModel_PMS5003T readings[4];
+    size_t resume = 0;
+    size_t count = debuguear::PMS5003T_FULL_PROCESSOR_T::decodeFrames(capture, sizeof(capture), readings, 4, &resume);
+    TEST_ASSERT_EQUAL(2, count);
+    TEST_ASSERT_EQUAL(98, resume);
+    TEST_ASSERT_EQUAL_UINT16(100, readings[1].pm25_env);
+
+    count = debuguear::PMS5003T_FULL_PROCESSOR_T::decodeFrames(capture, sizeof(capture), readings, 1, &resume);
+    TEST_ASSERT_EQUAL(1, count);
+    TEST_ASSERT_EQUAL(34, resume);
+}
+
+void test_pms5003st_processor_read_frame() {
+    uint8_t frame[40];
+    beginPmsFrame(frame, sizeof(frame));
+    for (uint8_t word = 0; word < 17; ++word) {
+        setPmsFrameWord(frame, word, word + 1);
+    }
+    sealPmsFrame(frame, sizeof(frame));
+
+    debuguear::PMS5003ST_FULL_PROCESSOR_T processor(&Serial, 0);
+    debuguear::AirQualityModel_PMS5003ST data;
+    TEST_ASSERT_TRUE(processor.processFrame(frame, &data));
+    TEST_ASSERT_EQUAL_UINT16(12, data.particles_100um);
+    TEST_ASSERT_EQUAL_UINT16(13, data.formaldehyde);
+    TEST_ASSERT_EQUAL_INT16(14, data.temperature);
+    TEST_ASSERT_EQUAL_UINT16(15, data.humedity);
+
+    debuguear::PMS5003T_FULL_PROCESSOR_T pms5003t(&Serial, 0);
+    debuguear::AirQualityModel_PMS5003T other;
+    TEST_ASSERT_FALSE(pms5003t.processFrame(frame, &other));
+}
+
+struct ObserverCounter {
+    int calls;
+    uint16_t lastPm25;
+};
+
+void countingObserver(void *context, const debuguear::AirQualityModel_PMS5003T *data) {
+    ObserverCounter *counter = static_cast<ObserverCounter *>(context);
+    counter->calls++;
+    counter->lastPm25 = data->pm25_env;
+}
+
+void test_pms5003t_observer_policies() {
+    uint8_t stream[32 * 6];
+    for (int i = 0; i < 6; ++i) {
+        memcpy(&stream[i * 32], validFrame, 32);
+    }
+    FakeStream fakeSerial(stream, sizeof(stream));
+    debuguear::PMS5003T_FULL_PROCESSOR_T processor(&fakeSerial, 4);
+    ObserverCounter immediate = {0, 0}, everyThird = {0, 0}, deferred = {0, 0};
+    TEST_ASSERT_TRUE(processor.addObserver(countingObserver, &immediate));
+    TEST_ASSERT_TRUE(processor.addObserver(countingObserver, &everyThird, debuguear::DISPATCH_EVERY_NTH, 3));
+    TEST_ASSERT_TRUE(processor.addObserver(countingObserver, &deferred, debuguear::DISPATCH_DEFERRED));
+    processor.loop();
+
+    TEST_ASSERT_EQUAL(6, immediate.calls);
+    TEST_ASSERT_EQUAL(2, everyThird.calls);
+    TEST_ASSERT_EQUAL(0, deferred.calls);
+    TEST_ASSERT_EQUAL(1, processor.dispatch());
+    TEST_ASSERT_EQUAL(1, deferred.calls);
+    TEST_ASSERT_EQUAL_UINT16(100, deferred.lastPm25);
+    TEST_ASSERT_EQUAL(0, processor.dispatch());
+}
+
+void scribblingObserver(debuguear::AirQualityModel_PMS5003T* data) {
+    data->pm25_env = 0;
+}
+
+void test_pms5003t_deferred_observers_see_the_reading_as_parsed() {
+    FakeStream fakeSerial(validFrame, sizeof(validFrame));
+    debuguear::PMS5003T_FULL_PROCESSOR_T processor(&fakeSerial, 2);
+    ObserverCounter deferred = {0, 0};
+    TEST_ASSERT_TRUE(processor.addObserver(scribblingObserver));
+    TEST_ASSERT_TRUE(processor.addObserver(countingObserver, &deferred, debuguear::DISPATCH_DEFERRED));
+    processor.loop();
+    TEST_ASSERT_EQUAL(1, processor.dispatch());
+    TEST_ASSERT_EQUAL_UINT16(100, deferred.lastPm25);
+}
+
+void test_pms5003t_observer_capacity_and_removal() {
+    FakeStream fakeSerial(validFrame, sizeof(validFrame));
+    debuguear::PMS5003T_FULL_PROCESSOR_T processor(&fakeSerial, 2);
+    ObserverCounter first = {0, 0}, second = {0, 0};
+    TEST_ASSERT_TRUE(processor.addObserver(countingObserver, &first));
+    TEST_ASSERT_TRUE(processor.addObserver(observerFunction));
+    TEST_ASSERT_FALSE(processor.addObserver(countingObserver, &second));
+
+    TEST_ASSERT_TRUE(processor.removeObserver(countingObserver, &first));
+    TEST_ASSERT_FALSE(processor.removeObserver(countingObserver, &first));
+    TEST_ASSERT_TRUE(processor.addObserver(countingObserver, &second));
+    processor.loop();
+    TEST_ASSERT_EQUAL(0, first.calls);
+    TEST_ASSERT_EQUAL(1, second.calls);
+    TEST_ASSERT_EQUAL(1, observerCalls);
+
+    TEST_ASSERT_TRUE(processor.removeObserver(observerFunction));
+    TEST_ASSERT_EQUAL(1, processor.observerCount());
+}
+
+/**
+ * @brief Copies `validFrame` with data word `word` set to `value`, fixing the checksum.
+ */
+static void frameWithWord(uint8_t *dst, uint8_t word, uint16_t value) {
+    memcpy(dst, validFrame, PMS5003T_FRAME_LENGTH);
+    setPmsFrameWord(dst, word, value);
+    sealPmsFrame(dst);
+}
+
+void test_pms5003t_deadband_suppresses_small_changes() {
+    // pm25_env (word 4): 100, 100, 103, 111, 112; particles_03um (word 6) changes on the last frame.
+    uint16_t pm25[5] = {100, 100, 103, 111, 112};
+    uint8_t stream[32 * 6];
+    for (int i = 0; i < 5; ++i) {
+        frameWithWord(&stream[i * 32], 4, pm25[i]);
+    }
+    memcpy(&stream[32 * 5], &stream[32 * 4], 32);
+    stream[32 * 5 + 4 + 6 * 2 + 1] += 1;
+    stream[32 * 5 + 31] += 1;
+
+    debuguear::DeadbandFilter<debuguear::LayoutPMS5003T> deadband;
+    deadband.setAll(0, 0);
+    TEST_ASSERT_TRUE(deadband.set(&debuguear::AirQualityModel_PMS5003T::pm25_env, 2, 5));
+    TEST_ASSERT_TRUE(deadband.ignore(&debuguear::AirQualityModel_PMS5003T::particles_03um));
+
+    FakeStream fakeSerial(stream, sizeof(stream));
+    debuguear::PMS5003T_FULL_PROCESSOR_T processor(&fakeSerial, 1);
+    ObserverCounter counter = {0, 0};
+    processor.addObserver(countingObserver, &counter);
+    processor.setDeadband(&deadband);
+    processor.loop();
+
+    // 100 passes (first), 100 is a repeat, 103 is within 5 %, 111 passes, 112 is within ±2,
+    // and the particles_03um change is ignored.
+    TEST_ASSERT_EQUAL(2, counter.calls);
+    TEST_ASSERT_EQUAL_UINT16(111, counter.lastPm25);
+    TEST_ASSERT_EQUAL_UINT32(4, deadband.suppressed());
+}
+
+void test_pms5003t_deadband_heartbeat() {
+    debuguear::DeadbandFilter<debuguear::LayoutPMS5003T> deadband(5000);
+    TEST_ASSERT_TRUE(deadband.accept(validFrame, 1000));
+    TEST_ASSERT_FALSE(deadband.accept(validFrame, 2000));
+    TEST_ASSERT_FALSE(deadband.accept(validFrame, 5999));
+    TEST_ASSERT_TRUE(deadband.accept(validFrame, 6000));
+    TEST_ASSERT_FALSE(deadband.accept(validFrame, 7000));
+
+    uint8_t changed[32];
+    frameWithWord(changed, 4, 101);
+    TEST_ASSERT_TRUE(deadband.accept(changed, 7200));
+    deadband.reset();
+    TEST_ASSERT_TRUE(deadband.accept(changed, 7400));
+}
+
+void test_pms5003t_deadband_compares_temperature_as_signed() {
+    debuguear::DeadbandFilter<debuguear::LayoutPMS5003T> deadband;
+    deadband.setAll(2, 10);
+    // temperature is data word 10, in 0.1 °C.
+    static const int16_t celsius10[] = {-50, -54, -200, -215, -225, -4, 5, -1};
+    static const bool passes[] = {true, false, true, false, true, true, true, true};
+    uint8_t frame[32];
+    for (size_t i = 0; i < sizeof(celsius10) / sizeof(celsius10[0]); ++i) {
+        frameWithWord(frame, 10, (uint16_t)celsius10[i]);
+        TEST_ASSERT_EQUAL(passes[i], deadband.accept(frame, 1000 * i));
+    }
+    TEST_ASSERT_EQUAL_UINT32(2, deadband.suppressed());
+}
+
+void test_pms5003t_passive_mode_and_sleep() {
+    uint8_t stream[32 * 3];
+    for (int i = 0; i < 3; ++i) {
+        memcpy(&stream[i * 32], validFrame, 32);
+    }
+    FakeStream fakeSerial(stream, sizeof(stream));
+    debuguear::PMS5003T_FULL_PROCESSOR_T processor(&fakeSerial, 1);
+    processor.addObserver(observerFunction);
+
+    TEST_ASSERT_TRUE(processor.setPassiveMode());
+    TEST_ASSERT_TRUE(fakeSerial.isPassive());
+    processor.loop();
+    TEST_ASSERT_EQUAL(0, observerCalls);
+    TEST_ASSERT_EQUAL(1, processor.acksReceived());
+    TEST_ASSERT_EQUAL_UINT8(debuguear::PMS_CMD_CHANGE_MODE, processor.lastAcknowledgedCommand());
+    TEST_ASSERT_EQUAL_UINT8(0, processor.lastAcknowledgedData());
+
+    TEST_ASSERT_TRUE(processor.requestReading());
+    TEST_ASSERT_EQUAL_UINT8(debuguear::PMS_CMD_READ, fakeSerial.lastCommand);
+    processor.loop();
+    processor.loop();
+    TEST_ASSERT_EQUAL(1, observerCalls);
+    TEST_ASSERT_EQUAL(1, processor.framesReceived());
+
+    TEST_ASSERT_TRUE(processor.sleep());
+    TEST_ASSERT_TRUE(fakeSerial.isAsleep());
+    processor.requestReading();
+    processor.loop();
+    TEST_ASSERT_EQUAL(1, observerCalls);
+    TEST_ASSERT_EQUAL(2, processor.acksReceived());
+    TEST_ASSERT_EQUAL_UINT8(debuguear::PMS_CMD_SLEEP, processor.lastAcknowledgedCommand());
+
+    TEST_ASSERT_TRUE(processor.wakeUp());
+    TEST_ASSERT_FALSE(fakeSerial.isAsleep());
+    processor.requestReading();
+    processor.loop();
+    TEST_ASSERT_EQUAL(2, observerCalls);
+    TEST_ASSERT_EQUAL(6, fakeSerial.commands);
+}
+
+void test_pms5003t_processor_stats() {
+    uint8_t stream[1 + 2 + 4 + 32 + 32];
+    stream[0] = 0x00;                                           // noise
+    stream[1] = 0x42; stream[2] = 0x00;                         // bad header
+    stream[3] = 0x42; stream[4] = 0x4D; stream[5] = 0x00; stream[6] = 0x10;  // bad length
+    memcpy(&stream[7], validFrame, 32);
+    stream[7 + 10] = 0x01;                                      // bad checksum
+    memcpy(&stream[39], validFrame, 32);
+
+    FakeStream fakeSerial(stream, sizeof(stream));
+    debuguear::PMS5003T_FULL_PROCESSOR_T processor(&fakeSerial, 1);
+    processor.addObserver(observerFunction);
+    processor.loop();
+
+    debuguear::ProcessorStats stats = processor.stats();
+    TEST_ASSERT_EQUAL(1, observerCalls);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.framesOk);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.headerErrors);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.lengthErrors);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.checksumErrors);
+    TEST_ASSERT_EQUAL_UINT32(1 + 2 + 4 + 32, stats.bytesDiscarded);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.overruns);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.latencySamples);
+    TEST_ASSERT_TRUE(stats.latencyMinUs <= stats.latencyAvgUs && stats.latencyAvgUs <= stats.latencyMaxUs);
+
+    processor.resetStats();
+    stats = processor.stats();
+    TEST_ASSERT_EQUAL_UINT32(0, stats.framesOk);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.bytesDiscarded);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.latencySamples);
+    TEST_ASSERT_EQUAL(1, processor.framesReceived());
+}
+
+void test_pms5003t_ring_latency_counts_from_the_header() {
+    debuguear::SpscRingBuffer<64> ring;
+    debuguear::PMS5003T_FULL_PROCESSOR_T processor(ring, 1);
+    ring.push(validFrame, 10);
+    processor.loop();
+    delay(30);
+    ring.push(validFrame + 10, 22);
+    processor.loop();
+
+    debuguear::ProcessorStats stats = processor.stats();
+    TEST_ASSERT_EQUAL_UINT32(1, stats.latencySamples);
+    TEST_ASSERT_TRUE(stats.latencyMinUs >= 30000);
+}
+
+void test_pms5003t_truncated_frame_does_not_hide_next_frame() {
+    // A frame cut short by lost bytes, immediately followed by a good one: the parser takes the
+    // start of the good frame as the end of the truncated one, then must find it again.
+    uint8_t stream[20 + 32 + 20];
+    memcpy(stream, validFrame, 20);
+    memcpy(&stream[20], validFrame, 32);
+    memcpy(&stream[52], validFrame, 20);
+    stream[52 + 4] = 0x42;  // a fake header inside a rejected candidate is skipped as well
+    stream[52 + 5] = 0x4D;
+
+    FakeStream fakeSerial(stream, sizeof(stream));
+    debuguear::PMS5003T_FULL_PROCESSOR_T processor(&fakeSerial, 1);
+    processor.addObserver(observerFunction);
+    processor.loop();
+    TEST_ASSERT_EQUAL(1, observerCalls);
+    TEST_ASSERT_EQUAL_UINT32(1, processor.stats().checksumErrors);
+    TEST_ASSERT_EQUAL_UINT32(20, processor.stats().bytesDiscarded);
+}
+
+void test_pms5003t_backlog_policies() {
+    // Five frames queued up while the loop was stalled.
+    uint8_t stream[32 * 5];
+    for (int i = 0; i < 5; ++i) {
+        frameWithWord(&stream[i * 32], 4, 100 + i);
+    }
+
+    FakeStream allSerial(stream, sizeof(stream));
+    debuguear::PMS5003T_FULL_PROCESSOR_T all(&allSerial, 1);
+    ObserverCounter allCounter = {0, 0};
+    all.addObserver(countingObserver, &allCounter);
+    all.loop();
+    TEST_ASSERT_EQUAL(5, allCounter.calls);
+    TEST_ASSERT_EQUAL_UINT16(104, allCounter.lastPm25);
+
+    FakeStream latestSerial(stream, sizeof(stream));
+    debuguear::PMS5003T_FULL_PROCESSOR_T latest(&latestSerial, 1);
+    ObserverCounter latestCounter = {0, 0};
+    latest.addObserver(countingObserver, &latestCounter);
+    latest.setBacklogPolicy(debuguear::BACKLOG_LATEST_WINS);
+    latest.loop();
+    TEST_ASSERT_EQUAL(1, latestCounter.calls);
+    TEST_ASSERT_EQUAL_UINT16(104, latestCounter.lastPm25);
+    TEST_ASSERT_EQUAL_UINT32(5, latest.stats().framesOk);
+    TEST_ASSERT_EQUAL_UINT32(4, latest.stats().framesSuperseded);
+    TEST_ASSERT_EQUAL_UINT32(1, latest.stats().latencySamples);
+}
+
+void test_pms5003t_minimal_feature_set() {
+    typedef debuguear::AirQualitySensor<debuguear::LayoutPMS5003T, 2, debuguear::SENSOR_FEATURES_NONE> MinimalProcessor;
+    // Observer slots shrink with the capacity, and the left out features take no room.
+    TEST_ASSERT_TRUE(sizeof(MinimalProcessor) < sizeof(debuguear::PMS5003T_FULL_PROCESSOR_T));
+    TEST_ASSERT_TRUE(sizeof(MinimalProcessor) <
+                     sizeof(debuguear::AirQualitySensor<debuguear::LayoutPMS5003T, 2, debuguear::SENSOR_FEATURE_STATS>));
+
+    uint8_t stream[3 + 32 + 32];
+    stream[0] = 0x4D;
+    stream[1] = 0x42;
+    stream[2] = 0x00;
+    memcpy(&stream[3], validFrame, 32);
+    memcpy(&stream[35], validFrame, 32);
+    FakeStream fakeSerial(stream, sizeof(stream));
+    MinimalProcessor processor(&fakeSerial, 5);
+    ObserverCounter counter = {0, 0};
+    TEST_ASSERT_FALSE(processor.addObserver(countingObserver, &counter, debuguear::DISPATCH_DEFERRED));
+    TEST_ASSERT_TRUE(processor.addObserver(countingObserver, &counter));
+    TEST_ASSERT_TRUE(processor.addObserver(observerFunction));
+    TEST_ASSERT_FALSE(processor.addObserver(countingObserver, &counter));
+    processor.loop();
+    TEST_ASSERT_EQUAL(2, counter.calls);
+    TEST_ASSERT_EQUAL_UINT16(100, counter.lastPm25);
+    TEST_ASSERT_EQUAL(2, observerCalls);
+    TEST_ASSERT_EQUAL_UINT32(2, processor.framesReceived());
+}
+
+void test_pms5003t_default_processor_is_lean() {
+    // Only the dispatch policies and a few observer slots; the rest is opt-in.
+    TEST_ASSERT_TRUE(sizeof(debuguear::PMS5003T_PROCESSOR_T) * 2 < sizeof(debuguear::PMS5003T_FULL_PROCESSOR_T));
+
+    FakeStream fakeSerial(validFrame, sizeof(validFrame));
+    debuguear::PMS5003T_PROCESSOR_T processor(&fakeSerial, 10);
+    ObserverCounter counter = {0, 0};
+    TEST_ASSERT_TRUE(processor.addObserver(countingObserver, &counter, debuguear::DISPATCH_DEFERRED));
+    for (uint8_t i = 1; i < debuguear::DEFAULT_MAX_OBSERVERS; ++i) {
+        TEST_ASSERT_TRUE(processor.addObserver(observerFunction));
+    }
+    TEST_ASSERT_FALSE(processor.addObserver(observerFunction));
+    processor.loop();
+    TEST_ASSERT_EQUAL(0, counter.calls);
+    TEST_ASSERT_EQUAL(1, processor.dispatch());
+    TEST_ASSERT_EQUAL(1, counter.calls);
+    TEST_ASSERT_EQUAL(debuguear::DEFAULT_MAX_OBSERVERS - 1, observerCalls);
+}
+
 void setUp(void){}
 
 void tearDown(void) {
     observerWasCalled = false;
+    observerCalls = 0;
 }
 
 
+int runUnityTests(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_pms5003t_processor_loop);
+    RUN_TEST(test_pms5003t_deprecated_entry_points);
+    RUN_TEST(test_pms5003t_processor_loop_resynchronizes);
+    RUN_TEST(test_pms5003t_processor_read_frame);
+    RUN_TEST(test_pms5003t_decode_frames);
+    RUN_TEST(test_pms5003st_processor_read_frame);
+    RUN_TEST(test_pms5003t_observer_policies);
+    RUN_TEST(test_pms5003t_deferred_observers_see_the_reading_as_parsed);
+    RUN_TEST(test_pms5003t_observer_capacity_and_removal);
+    RUN_TEST(test_pms5003t_deadband_suppresses_small_changes);
+    RUN_TEST(test_pms5003t_deadband_heartbeat);
+    RUN_TEST(test_pms5003t_deadband_compares_temperature_as_signed);
+    RUN_TEST(test_pms5003t_passive_mode_and_sleep);
+    RUN_TEST(test_pms5003t_processor_stats);
+    RUN_TEST(test_pms5003t_ring_latency_counts_from_the_header);
+    RUN_TEST(test_pms5003t_truncated_frame_does_not_hide_next_frame);
+    RUN_TEST(test_pms5003t_backlog_policies);
+    RUN_TEST(test_pms5003t_minimal_feature_set);
+    RUN_TEST(test_pms5003t_default_processor_is_lean);
+    return UNITY_END(); // stop unit testing
+}
+
+#ifdef ARDUINO
 void setup() {
     // NOTE!!! Wait for >2 secs
     // if board doesn't support software reset via Serial.DTR/RTS
     delay(2000);
     Serial.println("Starting test...");
-    UNITY_BEGIN();
+    runUnityTests();
 }
 
 void loop(){
-    RUN_TEST(test_pms5003t_processor_loop);
-    RUN_TEST(test_pms5003t_processor_read_frame);
-    UNITY_END(); // stop unit testing
 }
-
+#else
+int main(int, char **) {
+    return runUnityTests();
+}
+#endif
@@ -0,0 +1,178 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "../src/PMS5003T.h"
+#include "../src/BinaryLog.h"
+
+typedef debuguear::BinaryLogWriter<debuguear::LayoutPMS5003T> LogWriter;
+typedef debuguear::BinaryLogReader<debuguear::LayoutPMS5003T> LogReader;
+
+/**
+ * @brief `Print` sink collecting the log in a fixed buffer.
+ */
+class BufferPrint : public Print {
+    public:
+        uint8_t bytes[256];
+        size_t length = 0;
+
+        size_t write(uint8_t c) override {
+            if (length >= sizeof(bytes)) {
+                return 0;
+            }
+            bytes[length++] = c;
+            return 1;
+        }
+
+        using Print::write;
+};
+
+static debuguear::AirQualityModel_PMS5003T reading(uint16_t seed) {
+    debuguear::AirQualityModel_PMS5003T data;
+    data.clean();
+    data.pm10_standard = seed;
+    data.pm25_standard = seed + 1;
+    data.pm100_standard = seed + 2;
+    data.pm10_env = seed;
+    data.pm25_env = seed + 1;
+    data.pm100_env = seed + 2;
+    data.particles_03um = 600 + seed * 3;
+    data.particles_05um = 200 + seed;
+    data.particles_10um = 40;
+    data.particles_25um = 2;
+    data.temperature = -35 + (int16_t)seed;
+    data.humedity = 512;
+    return data;
+}
+
+static bool sameReading(const debuguear::AirQualityModel_PMS5003T &a, const debuguear::AirQualityModel_PMS5003T &b) {
+    return a.pm10_standard == b.pm10_standard && a.pm25_standard == b.pm25_standard &&
+           a.pm100_standard == b.pm100_standard && a.pm10_env == b.pm10_env &&
+           a.pm25_env == b.pm25_env && a.pm100_env == b.pm100_env &&
+           a.particles_03um == b.particles_03um && a.particles_05um == b.particles_05um &&
+           a.particles_10um == b.particles_10um && a.particles_25um == b.particles_25um &&
+           a.temperature == b.temperature && a.humedity == b.humedity && a.reserved == b.reserved;
+}
+
+void test_binary_log_round_trip() {
+    BufferPrint sink;
+    LogWriter writer(sink, 8);
+    uint16_t seeds[20] = {10, 10, 10, 11, 11, 9, 9, 9, 30, 30, 30, 30, 29, 10, 10, 10, 10, 10, 11, 11};
+    uint32_t times[20];
+    for (uint8_t i = 0; i < 20; ++i) {
+        times[i] = 4000000000UL + i * 1000UL + (i == 7 ? 13 : 0); // crosses the 32-bit wrap
+        writer.write(reading(seeds[i]), times[i]);
+    }
+    writer.flush();
+
+    LogReader reader;
+    LogReader::Record records[20];
+    size_t resume = 0;
+    size_t count = reader.decode(sink.bytes, sink.length, records, 20, &resume);
+    TEST_ASSERT_EQUAL(20, count);
+    TEST_ASSERT_EQUAL(sink.length, resume);
+    TEST_ASSERT_EQUAL(0, reader.corruptedBlocks());
+    for (uint8_t i = 0; i < 20; ++i) {
+        TEST_ASSERT_EQUAL_UINT32(times[i], records[i].timestamp);
+        TEST_ASSERT_TRUE(sameReading(reading(seeds[i]), records[i].data));
+    }
+}
+
+void test_binary_log_repeated_reading_is_one_byte() {
+    BufferPrint sink;
+    LogWriter writer(sink);
+    TEST_ASSERT_EQUAL(2 + 4 + 13 * 2, writer.write(reading(5), 0));
+    writer.write(reading(5), 1000);
+    TEST_ASSERT_EQUAL(1, writer.write(reading(5), 2000));
+    TEST_ASSERT_EQUAL(3, writer.flush());
+}
+
+void test_binary_log_skips_damaged_blocks() {
+    BufferPrint sink;
+    LogWriter writer(sink, 4);
+    for (uint8_t i = 0; i < 12; ++i) {
+        writer.write(reading(i), i * 1000UL);
+    }
+    size_t firstBlockEnd = 0;
+    LogReader probe;
+    LogReader::Record records[12];
+    probe.decode(sink.bytes, sink.length, records, 4, &firstBlockEnd);
+
+    sink.bytes[firstBlockEnd + 10] ^= 0x40; // damage the second block
+    LogReader reader;
+    size_t count = reader.decode(sink.bytes, sink.length, records, 12);
+    TEST_ASSERT_EQUAL(8, count);
+    TEST_ASSERT_GREATER_OR_EQUAL(1, reader.corruptedBlocks());
+    TEST_ASSERT_EQUAL_UINT32(8000, records[4].timestamp);
+    TEST_ASSERT_TRUE(sameReading(reading(8), records[4].data));
+}
+
+void test_binary_log_skips_block_with_damaged_end_marker() {
+    BufferPrint sink;
+    LogWriter writer(sink, 4);
+    for (uint8_t i = 0; i < 4; ++i) {
+        writer.write(reading(10), i * 1000UL);
+    }
+    // Keyframe and three one-byte records, then the end marker damaged into 300 more records.
+    const size_t recordsEnd = sink.length - 3;
+    uint8_t log[512];
+    memcpy(log, sink.bytes, recordsEnd);
+    memset(&log[recordsEnd], 0x01, 300);
+    memcpy(&log[recordsEnd + 300], sink.bytes, sink.length);
+    const size_t length = recordsEnd + 300 + sink.length;
+
+    // `out` only holds one block: the damaged one must still be told apart from one not fitting.
+    LogReader reader;
+    LogReader::Record records[4];
+    size_t resume = 0;
+    TEST_ASSERT_EQUAL(4, reader.decode(log, length, records, 4, &resume));
+    TEST_ASSERT_EQUAL(length, resume);
+    TEST_ASSERT_EQUAL(1, reader.corruptedBlocks());
+    TEST_ASSERT_EQUAL_UINT32(3000, records[3].timestamp);
+}
+
+void test_binary_log_partial_block_resumes() {
+    BufferPrint sink;
+    LogWriter writer(sink, 4);
+    for (uint8_t i = 0; i < 6; ++i) {
+        writer.write(reading(i), i * 1000UL);
+    }
+    // The second block is still open: only the first one is decoded.
+    LogReader reader;
+    LogReader::Record records[8];
+    size_t resume = 0;
+    TEST_ASSERT_EQUAL(4, reader.decode(sink.bytes, sink.length, records, 8, &resume));
+    size_t openBlock = resume;
+
+    writer.flush();
+    TEST_ASSERT_EQUAL(2, reader.decode(sink.bytes + openBlock, sink.length - openBlock, records, 8, &resume));
+    TEST_ASSERT_EQUAL(sink.length - openBlock, resume);
+    TEST_ASSERT_EQUAL_UINT32(5000, records[1].timestamp);
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+int runUnityTests(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_binary_log_round_trip);
+    RUN_TEST(test_binary_log_repeated_reading_is_one_byte);
+    RUN_TEST(test_binary_log_skips_damaged_blocks);
+    RUN_TEST(test_binary_log_skips_block_with_damaged_end_marker);
+    RUN_TEST(test_binary_log_partial_block_resumes);
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup() {
+    // NOTE!!! Wait for >2 secs
+    // if board doesn't support software reset via Serial.DTR/RTS
+    delay(2000);
+    runUnityTests();
+}
+
+void loop() {}
+#else
+int main(int, char **) {
+    return runUnityTests();
+}
+#endif
@@ -0,0 +1,112 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "../src/PMS5003T.h"
+#include "../src/Calibration.h"
+
+typedef debuguear::Calibrator<8> Calibrator;
+
+/**
+ * @brief Floating point reference of the US EPA correction.
+ */
+static float epaReference(float x, float rh) {
+    if (x > 1000) {
+        x = 1000;
+    }
+    float result;
+    if (x < 30) {
+        result = 0.524f * x - 0.0862f * rh + 5.75f;
+    } else if (x < 50) {
+        float w = x / 20 - 1.5f;
+        result = (0.786f * w + 0.524f * (1 - w)) * x - 0.0862f * rh + 5.75f;
+    } else if (x < 210) {
+        result = 0.786f * x - 0.0862f * rh + 5.75f;
+    } else if (x < 260) {
+        float w = x / 50 - 4.2f;
+        result = (0.69f * w + 0.786f * (1 - w)) * x - 0.0862f * rh * (1 - w) + 2.966f * w + 5.75f * (1 - w) +
+                 8.84e-4f * x * x * w;
+    } else {
+        result = 2.966f + 0.69f * x + 8.84e-4f * x * x;
+    }
+    return result < 0 ? 0 : result;
+}
+
+static float toFloat(int32_t value, uint8_t bits) {
+    return (float)value / (float)(1UL << bits);
+}
+
+void test_calibration_epa_matches_float_reference() {
+    Calibrator calibrator;
+    float worst = 0;
+    for (uint16_t x = 0; x <= 1000; x += 1) {
+        for (uint16_t rhTenths = 0; rhTenths <= 1000; rhTenths += 50) {
+            int32_t humidity = calibrator.humidity(rhTenths);
+            float fixed = toFloat(calibrator.pm25(x, humidity), Calibrator::FRACTION_BITS);
+            float error = fixed - epaReference(x, rhTenths / 10.0f);
+            error = error < 0 ? -error : error;
+            worst = error > worst ? error : worst;
+        }
+    }
+    // A tenth of the 0.1 µg/m³ resolution used for display.
+    TEST_ASSERT_TRUE(worst < 0.01f);
+}
+
+void test_calibration_temperature_and_humidity() {
+    Calibrator calibrator;
+    TEST_ASSERT_EQUAL_INT32(-55, Calibrator::toDecimal(calibrator.temperature(-55), 1));
+    TEST_ASSERT_EQUAL_INT32(231, Calibrator::toDecimal(calibrator.temperature(231), 1));
+    TEST_ASSERT_EQUAL_INT32(457, Calibrator::toDecimal(calibrator.humidity(457), 1));
+    TEST_ASSERT_EQUAL_INT32(46, Calibrator::toDecimal(calibrator.humidity(457), 0));
+
+    // Per-device corrections: +0.5 °C offset, humidity reads 4 % low.
+    Calibrator device(Calibrator::identity(), Calibrator::linear(1.0, 0.5), Calibrator::linear(1.04, 0.0));
+    TEST_ASSERT_EQUAL_INT32(236, Calibrator::toDecimal(device.temperature(231), 1));
+    TEST_ASSERT_EQUAL_INT32(0, Calibrator::toDecimal(device.temperature(-5), 1));
+    TEST_ASSERT_EQUAL_INT32(475, Calibrator::toDecimal(device.humidity(457), 1));
+}
+
+void test_calibration_reading() {
+    debuguear::AirQualityModel_PMS5003T data;
+    data.clean();
+    data.pm25_standard = 40;
+    data.temperature = 215;
+    data.humedity = 650;
+
+    debuguear::Calibrator<16> precise(debuguear::Calibrator<16>::linear(0.9, 1.0));
+    debuguear::CalibratedReading reading = precise.calibrate(data);
+    float expected = 0.9f * epaReference(40, 65.0f) + 1.0f;
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, expected, toFloat(reading.pm25, 16));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 21.5f, toFloat(reading.temperature, 16));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 65.0f, toFloat(reading.humidity, 16));
+
+    // Very humid clean air is clamped at zero before the device offset, and out-of-range readings are clamped.
+    TEST_ASSERT_EQUAL_INT32(debuguear::Calibrator<16>::linear(0.9, 1.0).offset, precise.pm25(0, precise.humidity(1000)));
+    debuguear::Calibrator<4> coarse;
+    TEST_ASSERT_EQUAL_INT32(coarse.pm25(1000, 0), coarse.pm25(60000, 0));
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+int runUnityTests(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_calibration_epa_matches_float_reference);
+    RUN_TEST(test_calibration_temperature_and_humidity);
+    RUN_TEST(test_calibration_reading);
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup() {
+    // NOTE!!! Wait for >2 secs
+    // if board doesn't support software reset via Serial.DTR/RTS
+    delay(2000);
+    runUnityTests();
+}
+
+void loop() {}
+#else
+int main(int, char **) {
+    return runUnityTests();
+}
+#endif
@@ -0,0 +1,107 @@
+#ifndef AIRQUALITY_TEST_FRAME_STREAM_GENERATOR
+#define AIRQUALITY_TEST_FRAME_STREAM_GENERATOR
+
+#include <Arduino.h>
+#include <vector>
+#include "../test_air_quality/FakeStream.h"
+
+/**
+ * @brief Builds synthetic PMS5003T serial captures for the benchmarks.
+ *
+ * Frames carry varying readings and correct checksums. The generator can
+ * prepend misaligned garbage, insert noise between frames and corrupt a given
+ * fraction of the frames, and keeps track of how many valid frames a perfect
+ * parser should recover. The result is consumed through a `FakeStream`.
+ */
+class FrameStreamGenerator {
+    public:
+        static const size_t FRAME_LENGTH = 32;
+
+        explicit FrameStreamGenerator(uint32_t seed = 0x5EED) : state(seed ? seed : 1) {}
+
+        /**
+         * @brief Appends `count` valid frames.
+         */
+        void addCleanFrames(size_t count) {
+            for (size_t i = 0; i < count; ++i) {
+                appendFrame(false);
+            }
+        }
+
+        /**
+         * @brief Appends `count` frames, each preceded by 1..`maxGap` random garbage bytes.
+         */
+        void addMisalignedFrames(size_t count, size_t maxGap) {
+            for (size_t i = 0; i < count; ++i) {
+                appendNoise(1 + next() % maxGap);
+                appendFrame(false);
+            }
+        }
+
+        /**
+         * @brief Appends `count` frames where roughly `corruptPercent`% have a flipped payload or
+         *        checksum byte, or are truncated.
+         */
+        void addCorruptedFrames(size_t count, unsigned corruptPercent) {
+            for (size_t i = 0; i < count; ++i) {
+                appendFrame((next() % 100) < corruptPercent);
+            }
+        }
+
+        const uint8_t *data() const { return bytes.data(); }
+        size_t size() const { return bytes.size(); }
+
+        /** Frames a correct parser is expected to deliver. */
+        size_t validFrames() const { return expectedFrames; }
+
+        /** Corrupted frames and noise bursts, i.e. the events forcing a resynchronization. */
+        size_t desyncEvents() const { return desyncs; }
+
+        FakeStream stream() const { return FakeStream(bytes.data(), bytes.size()); }
+
+    private:
+        std::vector<uint8_t> bytes;
+        uint32_t state;
+        size_t expectedFrames = 0;
+        size_t desyncs = 0;
+
+        uint32_t next() {
+            // xorshift32, deterministic across platforms.
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return state;
+        }
+
+        void appendNoise(size_t count) {
+            for (size_t i = 0; i < count; ++i) {
+                uint8_t b = (uint8_t)next();
+                bytes.push_back(b == 0x42 ? 0x00 : b);
+            }
+            desyncs++;
+        }
+
+        void appendFrame(bool corrupt) {
+            uint8_t frame[FRAME_LENGTH];
+            beginPmsFrame(frame, FRAME_LENGTH);
+            for (size_t word = 0; word < (FRAME_LENGTH - 6) / 2; ++word) {
+                setPmsFrameWord(frame, word, (uint16_t)(next() % 1000));
+            }
+            sealPmsFrame(frame, FRAME_LENGTH);
+
+            size_t length = FRAME_LENGTH;
+            if (corrupt) {
+                desyncs++;
+                switch (next() % 3) {
+                    case 0: frame[4 + next() % (FRAME_LENGTH - 4)] ^= (uint8_t)(1 + next() % 255); break;
+                    case 1: frame[FRAME_LENGTH - 1] ^= 0x01; break;
+                    default: length = 4 + next() % (FRAME_LENGTH - 4); break; // truncated frame
+                }
+            } else {
+                expectedFrames++;
+            }
+            bytes.insert(bytes.end(), frame, frame + length);
+        }
+};
+
+#endif
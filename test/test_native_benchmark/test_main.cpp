@@ -0,0 +1,425 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <chrono>
+#include "../src/PMS5003T.h"
+#include "../src/BinaryLog.h"
+#include "../src/ReadingFormat.h"
+#include "../src/Calibration.h"
+#include <new>
+#include <stdlib.h>
+#include "FrameStreamGenerator.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_CYCLES() __rdtsc()
+#else
+#define BENCH_CYCLES() 0ULL
+#endif
+
+// Host-only benchmarks for the frame processing hot path. Each case prints one
+// line with frames/sec, ns/frame and the bytes thrown away per resynchronization,
+// and asserts the minimum a correct parser must achieve so regressions fail the run.
+
+static const size_t BENCH_FRAMES = 20000;
+static const int BENCH_REPETITIONS = 5;
+
+size_t deliveredFrames = 0;
+
+void countingObserver(debuguear::AirQualityModel_PMS5003T *) {
+    deliveredFrames++;
+}
+
+// Counts heap allocations so the formatter benchmark can report them.
+static size_t heapAllocations = 0;
+
+void *operator new(size_t size) {
+    heapAllocations++;
+    void *p = malloc(size ? size : 1);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void *p) noexcept {
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+    free(p);
+}
+
+struct BenchResult {
+    double framesPerSecond;
+    double nsPerFrame;
+    double bytesDiscardedPerResync;
+    size_t delivered;
+};
+
+static double elapsedNs(std::chrono::steady_clock::time_point start) {
+    return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+static void report(const char *name, const BenchResult &r, size_t expected) {
+    printf("[BENCH] %-28s %12.0f frames/s %9.1f ns/frame %8.2f bytes/resync  %zu/%zu frames\n",
+           name, r.framesPerSecond, r.nsPerFrame, r.bytesDiscardedPerResync, r.delivered, expected);
+}
+
+static BenchResult runStreamBench(const FrameStreamGenerator &gen) {
+    double totalNs = 0;
+    size_t delivered = 0;
+    for (int rep = 0; rep < BENCH_REPETITIONS; ++rep) {
+        FakeStream stream = gen.stream();
+        debuguear::PMS5003T_PROCESSOR_T processor(&stream, 1);
+        processor.addObserver(countingObserver);
+        deliveredFrames = 0;
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        processor.loop();
+        totalNs += elapsedNs(start);
+        delivered = deliveredFrames;
+    }
+
+    BenchResult r;
+    r.delivered = delivered;
+    r.nsPerFrame = totalNs / BENCH_REPETITIONS / (delivered ? delivered : 1);
+    r.framesPerSecond = 1e9 / r.nsPerFrame;
+    size_t discarded = gen.size() - delivered * FrameStreamGenerator::FRAME_LENGTH;
+    r.bytesDiscardedPerResync = gen.desyncEvents() ? (double)discarded / gen.desyncEvents() : 0.0;
+    return r;
+}
+
+void test_bench_process_frame() {
+    FrameStreamGenerator gen;
+    gen.addCleanFrames(1);
+    debuguear::PMS5003T_PROCESSOR_T processor(&Serial, 0);
+    debuguear::AirQualityModel_PMS5003T data;
+    uint8_t frame[32];
+    memcpy(frame, gen.data(), sizeof(frame));
+
+    size_t ok = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < BENCH_FRAMES * BENCH_REPETITIONS; ++i) {
+        ok += processor.processFrame(frame, &data);
+    }
+    double ns = elapsedNs(start) / (BENCH_FRAMES * BENCH_REPETITIONS);
+
+    BenchResult r = {1e9 / ns, ns, 0.0, ok / BENCH_REPETITIONS};
+    report("processFrame", r, BENCH_FRAMES);
+    TEST_ASSERT_EQUAL(BENCH_FRAMES * BENCH_REPETITIONS, ok);
+}
+
+void test_bench_decode_frames() {
+    FrameStreamGenerator gen;
+    gen.addCorruptedFrames(BENCH_FRAMES, 5);
+    std::vector<debuguear::AirQualityModel_PMS5003T> readings(BENCH_FRAMES);
+
+    size_t count = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int rep = 0; rep < BENCH_REPETITIONS; ++rep) {
+        count = debuguear::PMS5003T_PROCESSOR_T::decodeFrames(gen.data(), gen.size(), readings.data(), readings.size());
+    }
+    double ns = elapsedNs(start) / BENCH_REPETITIONS;
+
+    BenchResult r;
+    r.delivered = count;
+    r.nsPerFrame = ns / (count ? count : 1);
+    r.framesPerSecond = 1e9 / r.nsPerFrame;
+    r.bytesDiscardedPerResync = (double)(gen.size() - count * FrameStreamGenerator::FRAME_LENGTH) / gen.desyncEvents();
+    report("decodeFrames 5% corrupted", r, gen.validFrames());
+    printf("[BENCH] %-28s %12.1f MB/s\n", "decodeFrames throughput", gen.size() / ns * 1e3);
+    TEST_ASSERT_EQUAL(gen.validFrames(), count);
+}
+
+void test_bench_clean_stream() {
+    FrameStreamGenerator gen;
+    gen.addCleanFrames(BENCH_FRAMES);
+    BenchResult r = runStreamBench(gen);
+    report("stream clean", r, gen.validFrames());
+    TEST_ASSERT_EQUAL(gen.validFrames(), r.delivered);
+}
+
+void test_bench_clean_ring() {
+    FrameStreamGenerator gen;
+    gen.addCleanFrames(BENCH_FRAMES);
+
+    double totalNs = 0;
+    for (int rep = 0; rep < BENCH_REPETITIONS; ++rep) {
+        debuguear::SpscRingBuffer<1024> ring;
+        debuguear::PMS5003T_PROCESSOR_T processor(ring, 1);
+        processor.addObserver(countingObserver);
+        deliveredFrames = 0;
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (size_t offset = 0; offset < gen.size(); offset += 512) {
+            size_t chunk = gen.size() - offset < 512 ? gen.size() - offset : 512;
+            ring.push(gen.data() + offset, chunk);
+            processor.loop();
+        }
+        totalNs += elapsedNs(start);
+    }
+
+    BenchResult r;
+    r.delivered = deliveredFrames;
+    r.nsPerFrame = totalNs / BENCH_REPETITIONS / (r.delivered ? r.delivered : 1);
+    r.framesPerSecond = 1e9 / r.nsPerFrame;
+    r.bytesDiscardedPerResync = 0.0;
+    report("ring clean", r, gen.validFrames());
+    TEST_ASSERT_EQUAL(gen.validFrames(), r.delivered);
+}
+
+void test_bench_misaligned_stream() {
+    FrameStreamGenerator gen;
+    gen.addMisalignedFrames(BENCH_FRAMES, 40);
+    BenchResult r = runStreamBench(gen);
+    report("stream misaligned", r, gen.validFrames());
+    TEST_ASSERT_EQUAL(gen.validFrames(), r.delivered);
+}
+
+void test_bench_corrupted_streams() {
+    static const unsigned rates[] = {0, 1, 5, 10, 25, 50};
+    for (size_t i = 0; i < sizeof(rates) / sizeof(rates[0]); ++i) {
+        FrameStreamGenerator gen(0xC0FFEE + rates[i]);
+        gen.addCorruptedFrames(BENCH_FRAMES, rates[i]);
+        BenchResult r = runStreamBench(gen);
+
+        char name[32];
+        snprintf(name, sizeof(name), "stream corrupted %u%%", rates[i]);
+        report(name, r, gen.validFrames());
+        // Rejected candidates are rescanned, so a corrupted frame never hides the next one.
+        TEST_ASSERT_EQUAL(gen.validFrames(), r.delivered);
+    }
+}
+
+/**
+ * @brief `Print` sink appending to a vector.
+ */
+class VectorPrint : public Print {
+    public:
+        std::vector<uint8_t> bytes;
+
+        size_t write(uint8_t c) override {
+            bytes.push_back(c);
+            return 1;
+        }
+
+        size_t write(const uint8_t *buffer, size_t size) override {
+            bytes.insert(bytes.end(), buffer, buffer + size);
+            return size;
+        }
+};
+
+/**
+ * @brief Realistic reading series: the sensor refreshes its values every 2-3 frames with a
+ *        small random walk, and frames arrive roughly once a second.
+ */
+static void generateReadings(std::vector<debuguear::AirQualityModel_PMS5003T> &readings, std::vector<uint32_t> &times) {
+    uint32_t state = 0xA11CE;
+    debuguear::AirQualityModel_PMS5003T data;
+    data.clean();
+    data.pm10_standard = data.pm10_env = 8;
+    data.pm25_standard = data.pm25_env = 12;
+    data.pm100_standard = data.pm100_env = 15;
+    data.particles_03um = 1800;
+    data.particles_05um = 520;
+    data.particles_10um = 90;
+    data.particles_25um = 6;
+    data.temperature = 231;
+    data.humedity = 455;
+    uint32_t t = 0;
+    for (size_t i = 0; i < readings.size(); ++i) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        if (state % 5 < 2) {
+            uint16_t *words[] = {&data.pm10_standard, &data.pm25_standard, &data.pm100_standard, &data.pm10_env,
+                                 &data.pm25_env, &data.pm100_env, &data.particles_25um};
+            for (size_t w = 0; w < sizeof(words) / sizeof(words[0]); ++w) {
+                int step = (int)((state >> (w * 2)) & 3) - 1;
+                if (*words[w] + step > 0) {
+                    *words[w] = (uint16_t)(*words[w] + step);
+                }
+            }
+            data.particles_03um = (uint16_t)(data.particles_03um + (int)(state >> 16) % 41 - 20);
+            data.particles_05um = (uint16_t)(data.particles_05um + (int)(state >> 8) % 13 - 6);
+            data.particles_10um = (uint16_t)(data.particles_10um + (int)(state >> 4) % 5 - 2);
+        }
+        if (state % 97 == 0) {
+            data.temperature += (state & 0x100) ? 1 : -1;
+            data.humedity += (state & 0x200) ? 1 : -1;
+        }
+        t += 1000 + ((state % 23 == 0) ? 1 : 0);
+        readings[i] = data;
+        times[i] = t;
+    }
+}
+
+void test_bench_binary_log() {
+    std::vector<debuguear::AirQualityModel_PMS5003T> readings(BENCH_FRAMES);
+    std::vector<uint32_t> times(BENCH_FRAMES);
+    generateReadings(readings, times);
+
+    double totalNs = 0;
+    VectorPrint sink;
+    for (int rep = 0; rep < BENCH_REPETITIONS; ++rep) {
+        sink.bytes.clear();
+        sink.bytes.reserve(BENCH_FRAMES * 8);
+        debuguear::BinaryLogWriter<debuguear::LayoutPMS5003T> writer(sink);
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < readings.size(); ++i) {
+            writer.write(readings[i], times[i]);
+        }
+        writer.flush();
+        totalNs += elapsedNs(start);
+    }
+    double nsPerReading = totalNs / BENCH_REPETITIONS / BENCH_FRAMES;
+    double bytesPerReading = (double)sink.bytes.size() / BENCH_FRAMES;
+
+    debuguear::BinaryLogReader<debuguear::LayoutPMS5003T> reader;
+    std::vector<debuguear::BinaryLogRecord<debuguear::AirQualityModel_PMS5003T> > decoded(BENCH_FRAMES);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    size_t count = reader.decode(sink.bytes.data(), sink.bytes.size(), decoded.data(), decoded.size());
+    double decodeNs = elapsedNs(start) / (count ? count : 1);
+
+    printf("[BENCH] %-28s %9.1f ns/reading %9.2f bytes/reading (toString: %u bytes)\n",
+           "binary log encode", nsPerReading, bytesPerReading, readings[0].toString().length());
+    printf("[BENCH] %-28s %9.1f ns/reading\n", "binary log decode", decodeNs);
+    TEST_ASSERT_EQUAL(BENCH_FRAMES, count);
+    TEST_ASSERT_EQUAL_UINT32(times.back(), decoded.back().timestamp);
+    TEST_ASSERT_EQUAL_UINT16(readings.back().particles_03um, decoded.back().data.particles_03um);
+    TEST_ASSERT_LESS_THAN(8.0, bytesPerReading);
+}
+
+template <typename Format>
+static void benchFormat(const char *name, const std::vector<debuguear::AirQualityModel_PMS5003T> &readings, Format format) {
+    size_t bytes = 0;
+    heapAllocations = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int rep = 0; rep < BENCH_REPETITIONS; ++rep) {
+        for (size_t i = 0; i < readings.size(); ++i) {
+            bytes += format(readings[i]);
+        }
+    }
+    double calls = (double)BENCH_REPETITIONS * readings.size();
+    printf("[BENCH] %-28s %9.1f ns/reading %7.1f bytes/reading %6.1f allocations/reading\n",
+           name, elapsedNs(start) / calls, bytes / calls, heapAllocations / calls);
+}
+
+void test_bench_formatters() {
+    std::vector<debuguear::AirQualityModel_PMS5003T> readings(BENCH_FRAMES);
+    std::vector<uint32_t> times(BENCH_FRAMES);
+    generateReadings(readings, times);
+    static char buf[debuguear::FormatBounds<debuguear::AirQualityModel_PMS5003T>::lineProtocol(3)];
+
+    benchFormat("toString", readings, [](const debuguear::AirQualityModel_PMS5003T &data) {
+        return (size_t)data.toString().length();
+    });
+    size_t allocationsBefore = heapAllocations;
+    benchFormat("formatCsv", readings, [](const debuguear::AirQualityModel_PMS5003T &data) {
+        return debuguear::formatCsv(data, buf, sizeof(buf));
+    });
+    benchFormat("formatJson", readings, [](const debuguear::AirQualityModel_PMS5003T &data) {
+        return debuguear::formatJson(data, buf, sizeof(buf));
+    });
+    benchFormat("formatLineProtocol", readings, [](const debuguear::AirQualityModel_PMS5003T &data) {
+        return debuguear::formatLineProtocol(data, "pms", buf, sizeof(buf), 1700000000000ULL);
+    });
+    TEST_ASSERT_TRUE(allocationsBefore > 0);
+    TEST_ASSERT_EQUAL(0, heapAllocations);
+}
+
+/**
+ * @brief The calibration as consumers used to write it, in `float`.
+ */
+static void calibrateFloat(const debuguear::AirQualityModel_PMS5003T &data, float *pm25, float *temperature, float *humidity) {
+    *temperature = data.temperature / 10.0f;
+    *humidity = data.humedity / 10.0f;
+    float x = data.pm25_standard > 1000 ? 1000.0f : data.pm25_standard;
+    float rh = *humidity;
+    float result;
+    if (x < 30) {
+        result = 0.524f * x - 0.0862f * rh + 5.75f;
+    } else if (x < 50) {
+        float w = x / 20 - 1.5f;
+        result = (0.786f * w + 0.524f * (1 - w)) * x - 0.0862f * rh + 5.75f;
+    } else if (x < 210) {
+        result = 0.786f * x - 0.0862f * rh + 5.75f;
+    } else if (x < 260) {
+        float w = x / 50 - 4.2f;
+        result = (0.69f * w + 0.786f * (1 - w)) * x - 0.0862f * rh * (1 - w) + 2.966f * w + 5.75f * (1 - w) +
+                 8.84e-4f * x * x * w;
+    } else {
+        result = 2.966f + 0.69f * x + 8.84e-4f * x * x;
+    }
+    *pm25 = result < 0 ? 0 : result;
+}
+
+void test_bench_calibration() {
+    std::vector<debuguear::AirQualityModel_PMS5003T> readings(BENCH_FRAMES);
+    std::vector<uint32_t> times(BENCH_FRAMES);
+    generateReadings(readings, times);
+    for (size_t i = 0; i < readings.size(); ++i) {
+        readings[i].pm25_standard = (uint16_t)((i * 7) % 1000); // every branch of the EPA fit
+    }
+    debuguear::Calibrator<8> calibrator;
+    double calls = (double)BENCH_REPETITIONS * readings.size();
+
+    volatile int32_t fixedSink = 0;
+    unsigned long long cycles = BENCH_CYCLES();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int rep = 0; rep < BENCH_REPETITIONS; ++rep) {
+        for (size_t i = 0; i < readings.size(); ++i) {
+            debuguear::CalibratedReading r = calibrator.calibrate(readings[i]);
+            fixedSink = fixedSink + r.pm25 + r.temperature + r.humidity;
+        }
+    }
+    double fixedNs = elapsedNs(start) / calls;
+    double fixedCycles = (BENCH_CYCLES() - cycles) / calls;
+
+    volatile float floatSink = 0;
+    cycles = BENCH_CYCLES();
+    start = std::chrono::steady_clock::now();
+    for (int rep = 0; rep < BENCH_REPETITIONS; ++rep) {
+        for (size_t i = 0; i < readings.size(); ++i) {
+            float pm25, temperature, humidity;
+            calibrateFloat(readings[i], &pm25, &temperature, &humidity);
+            floatSink = floatSink + pm25 + temperature + humidity;
+        }
+    }
+    double floatNs = elapsedNs(start) / calls;
+    double floatCycles = (BENCH_CYCLES() - cycles) / calls;
+
+    printf("[BENCH] %-28s %9.1f ns/reading %8.1f cycles/reading\n", "calibration fixed-point", fixedNs, fixedCycles);
+    printf("[BENCH] %-28s %9.1f ns/reading %8.1f cycles/reading\n", "calibration float", floatNs, floatCycles);
+
+    // Same results as the float version, to the display resolution.
+    float worst = 0;
+    for (size_t i = 0; i < readings.size(); ++i) {
+        float pm25, temperature, humidity;
+        calibrateFloat(readings[i], &pm25, &temperature, &humidity);
+        float error = calibrator.calibrate(readings[i]).pm25 / 256.0f - pm25;
+        error = error < 0 ? -error : error;
+        worst = error > worst ? error : worst;
+    }
+    TEST_ASSERT_TRUE(worst < 0.01f);
+}
+
+void setUp(void) {
+    deliveredFrames = 0;
+}
+
+void tearDown(void) {}
+
+int main(int, char **) {
+    UNITY_BEGIN();
+    RUN_TEST(test_bench_process_frame);
+    RUN_TEST(test_bench_decode_frames);
+    RUN_TEST(test_bench_clean_stream);
+    RUN_TEST(test_bench_clean_ring);
+    RUN_TEST(test_bench_misaligned_stream);
+    RUN_TEST(test_bench_corrupted_streams);
+    RUN_TEST(test_bench_binary_log);
+    RUN_TEST(test_bench_formatters);
+    RUN_TEST(test_bench_calibration);
+    return UNITY_END();
+}
@@ -0,0 +1,221 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "../src/PMS5003T.h"
+#include "../test_native_serial_line/SerialLineSimulator.h"
+
+/**
+ * @brief Time spent in the sleep function, on the virtual clock.
+ */
+struct SleepLog {
+    uint32_t naps;              // short `delay()` while a frame is due, not through the sleep function
+    uint32_t longSleeps;
+    uint64_t sleptMs;
+};
+
+static SleepLog sleepLog;
+static SerialLineSimulator *sleepingLine;
+
+static void recordingSleep(unsigned long ms) {
+    sleepLog.longSleeps++;
+    sleepLog.sleptMs += ms;
+    delay(ms);
+}
+
+/**
+ * @brief `cadence::lightSleep` on the simulated line: the UART is clock gated while asleep.
+ */
+static void simulatedLightSleep(unsigned long ms) {
+    sleepingLine->setReceiverStopped(true);
+    recordingSleep(ms);
+    sleepingLine->setReceiverStopped(false);
+}
+
+struct ArrivalProbe {
+    SerialLineSimulator *line;
+    uint32_t delivered;
+    uint64_t latencyMaxUs;
+
+    static void onReading(void *context, const debuguear::AirQualityModel_PMS5003T *data) {
+        ArrivalProbe *probe = static_cast<ArrivalProbe *>(context);
+        uint64_t latency = arduino_shim::nowMicros() - probe->line->arrivalMicros(data->pm10_standard);
+        probe->delivered++;
+        probe->latencyMaxUs = latency > probe->latencyMaxUs ? latency : probe->latencyMaxUs;
+    }
+};
+
+void test_cadence_learns_interval_and_skips_missed_frames() {
+    debuguear::FrameCadence cadence;
+    unsigned long t = 10000;
+    cadence.recordArrival(t, 1);
+    TEST_ASSERT_FALSE(cadence.isLocked());
+    TEST_ASSERT_EQUAL_UINT32(t + 500, cadence.nextExpectedAt(t + 500));
+
+    static const int jitter[] = {0, 12, -9, 4, -15, 7, 0, -3};
+    for (int i = 0; i < 8; ++i) {
+        cadence.recordArrival(t + 2300 * (i + 1) + jitter[i], 1);
+    }
+    t += 2300 * 8;
+    TEST_ASSERT_TRUE(cadence.isLocked());
+    TEST_ASSERT_UINT32_WITHIN(10, 2300, cadence.intervalMs());
+    TEST_ASSERT_TRUE(cadence.jitterMs() < 20);
+    TEST_ASSERT_UINT32_WITHIN(15, t + 2300, cadence.nextExpectedAt(t));
+    TEST_ASSERT_UINT32_WITHIN(15, 2000, cadence.msUntilNext(t + 300));
+
+    // A corrupted frame: the next one comes two intervals later, in the same cadence.
+    uint32_t interval = cadence.intervalMs();
+    t += 2 * 2300;
+    cadence.recordArrival(t, 1);
+    TEST_ASSERT_EQUAL_UINT32(1, cadence.missedFrames());
+    TEST_ASSERT_EQUAL_UINT32(interval, cadence.intervalMs());
+
+    // More than half an interval late: expect the one after.
+    TEST_ASSERT_UINT32_WITHIN(15, t + 2 * 2300, cadence.nextExpectedAt(t + 2300 + 1200));
+    TEST_ASSERT_EQUAL_UINT32(0, cadence.msUntilNext(t + 2300 + 100));
+
+    // Coarse arrivals keep the phase but teach nothing.
+    t += 2300;
+    cadence.recordArrival(t + 400, 500);
+    TEST_ASSERT_EQUAL_UINT32(interval, cadence.intervalMs());
+    t += 400;
+
+    // The readings start moving: the sensor switches to its fast pace and is relearned.
+    cadence.recordArrival(t + 800, 1);
+    cadence.recordArrival(t + 1600, 1);
+    TEST_ASSERT_FALSE(cadence.isLocked());
+    TEST_ASSERT_EQUAL_UINT32(t + 1600 + 100, cadence.nextExpectedAt(t + 1600 + 100));
+    cadence.recordArrival(t + 2400, 1);
+    TEST_ASSERT_TRUE(cadence.isLocked());
+    TEST_ASSERT_UINT32_WITHIN(5, 800, cadence.intervalMs());
+}
+
+/**
+ * @brief Runs a sensor-only loop, `loop()` then `sleepUntilNextFrame()`, for `hours` of
+ *        virtual time and prints how much of it was spent sleeping.
+ */
+static ArrivalProbe runSleepingLoop(SerialLineSimulator &line, uint64_t hours, const char *label,
+                                    debuguear::FrameSleepFn sleepFn = recordingSleep) {
+    debuguear::PMS5003T_FULL_PROCESSOR_T processor(&line, 1);
+    ArrivalProbe probe = {&line, 0, 0};
+    processor.addObserver(ArrivalProbe::onReading, &probe);
+    sleepLog = SleepLog();
+    sleepingLine = &line;
+    uint64_t start = arduino_shim::nowMicros();
+    uint64_t end = start + hours * 3600 * 1000000;
+    uint32_t wakeUps = 0;
+    while (arduino_shim::nowMicros() < end) {
+        processor.loop();
+        if (processor.sleepUntilNextFrame(sleepFn) <= debuguear::PMS5003T_FULL_PROCESSOR_T::FRAME_NAP_MS) {
+            sleepLog.naps++;
+        }
+        wakeUps++;
+    }
+
+    const SerialLineStats &stats = line.lineStats();
+    double asleep = 100.0 * sleepLog.sleptMs / ((end - start) / 1000.0);
+    printf("[SIM] %-32s %6u frames, %u delivered, %5.1f wake-ups/frame (vs %6.0f polling every 1 ms), "
+           "%5.2f%% of the time in long sleeps, latency max %5.1f ms, interval %u ms jitter %u ms\n",
+           label, (unsigned)stats.framesCompleted, (unsigned)probe.delivered, (double)wakeUps / stats.framesCompleted,
+           (end - start) / 1000.0 / stats.framesCompleted, asleep, probe.latencyMaxUs / 1000.0,
+           (unsigned)processor.frameCadence().intervalMs(), (unsigned)processor.frameCadence().jitterMs());
+    return probe;
+}
+
+void test_sleeping_loop_keeps_every_frame_in_stable_mode() {
+    SerialLineConfig config;
+    config.frameIntervalUs = 2300000;
+    config.jitterUs = 20000;
+    SerialLineSimulator line(config);
+    ArrivalProbe probe = runSleepingLoop(line, 4, "2.3 s +/- 20 ms");
+
+    TEST_ASSERT_EQUAL_UINT32(line.lineStats().framesCompleted, probe.delivered);
+    TEST_ASSERT_EQUAL_UINT32(0, line.lineStats().bytesOverflowed);
+    // Awake for the guard window around each frame only.
+    TEST_ASSERT_TRUE(sleepLog.longSleeps >= probe.delivered - 10);
+    TEST_ASSERT_TRUE(sleepLog.naps < 120 * probe.delivered);
+    TEST_ASSERT_TRUE(probe.latencyMaxUs < 40000);
+}
+
+void test_sleeping_loop_keeps_every_frame_in_fast_mode() {
+    SerialLineConfig config;
+    config.frameIntervalUs = 200000;
+    config.jitterUs = 5000;
+    SerialLineSimulator line(config, 0xFA57);
+    ArrivalProbe probe = runSleepingLoop(line, 1, "200 ms +/- 5 ms");
+
+    TEST_ASSERT_EQUAL_UINT32(line.lineStats().framesCompleted, probe.delivered);
+    TEST_ASSERT_EQUAL_UINT32(0, line.lineStats().bytesOverflowed);
+    TEST_ASSERT_TRUE(sleepLog.longSleeps >= probe.delivered - 10);
+}
+
+void test_light_sleep_wakes_before_the_frame_starts() {
+    SerialLineConfig config;
+    config.frameIntervalUs = 2300000;
+    config.jitterUs = 20000;
+    SerialLineSimulator line(config, 0x5133);
+    ArrivalProbe probe = runSleepingLoop(line, 4, "light sleep, 2.3 s +/- 20 ms", simulatedLightSleep);
+
+    // A 32-byte frame is 33 ms on the wire: waking 20 ms before it completes would cut its head.
+    TEST_ASSERT_EQUAL_UINT32(0, line.lineStats().bytesLostAsleep);
+    TEST_ASSERT_EQUAL_UINT32(line.lineStats().framesCompleted, probe.delivered);
+    TEST_ASSERT_TRUE(sleepLog.longSleeps >= probe.delivered - 10);
+}
+
+void test_light_sleep_in_fast_mode() {
+    SerialLineConfig config;
+    config.frameIntervalUs = 200000;
+    config.jitterUs = 5000;
+    SerialLineSimulator line(config, 0xFA57);
+    ArrivalProbe probe = runSleepingLoop(line, 1, "light sleep, 200 ms +/- 5 ms", simulatedLightSleep);
+
+    TEST_ASSERT_EQUAL_UINT32(0, line.lineStats().bytesLostAsleep);
+    TEST_ASSERT_EQUAL_UINT32(line.lineStats().framesCompleted, probe.delivered);
+}
+
+void test_sleeping_loop_on_a_noisy_line() {
+    SerialLineConfig config;
+    config.frameIntervalUs = 2300000;
+    config.jitterUs = 50000;
+    config.bitErrorPpm = 100;
+    config.dropPpm = 500;
+    SerialLineSimulator line(config, 0xBAD);
+    ArrivalProbe probe = runSleepingLoop(line, 4, "2.3 s +/- 50 ms, noisy line");
+
+    // Frames damaged on the line are lost whatever the loop does; sleeping loses none more.
+    TEST_ASSERT_TRUE(line.lineStats().framesIntact < line.lineStats().framesCompleted);
+    TEST_ASSERT_EQUAL_UINT32(line.lineStats().framesIntact, probe.delivered);
+    TEST_ASSERT_EQUAL_UINT32(0, line.lineStats().bytesOverflowed);
+}
+
+void setUp(void) {
+    arduino_shim::useVirtualClock(1000000);
+}
+
+void tearDown(void) {
+    arduino_shim::useRealClock();
+}
+
+int runUnityTests(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_cadence_learns_interval_and_skips_missed_frames);
+    RUN_TEST(test_sleeping_loop_keeps_every_frame_in_stable_mode);
+    RUN_TEST(test_sleeping_loop_keeps_every_frame_in_fast_mode);
+    RUN_TEST(test_light_sleep_wakes_before_the_frame_starts);
+    RUN_TEST(test_light_sleep_in_fast_mode);
+    RUN_TEST(test_sleeping_loop_on_a_noisy_line);
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup() {
+    // NOTE!!! Wait for >2 secs
+    // if board doesn't support software reset via Serial.DTR/RTS
+    delay(2000);
+    runUnityTests();
+}
+
+void loop() {}
+#else
+int main(int, char **) {
+    return runUnityTests();
+}
+#endif
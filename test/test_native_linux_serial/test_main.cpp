@@ -0,0 +1,239 @@
+#include <Arduino.h>
+#include <unity.h>
+
+#if defined(__linux__)
+#include <stdlib.h>
+#include <thread>
+#include <time.h>
+#include <vector>
+#include "../test_air_quality/FrameBuilder.h"
+#include "../src/PMS5003T.h"
+#include "../src/LinuxSerial.h"
+
+typedef debuguear::SpscRingBuffer<1024> PortRing;
+
+/**
+ * @brief A pseudo-terminal standing in for a USB-serial adapter: the test writes sensor bytes
+ *        to `master`, the port under test opens `path`.
+ */
+struct FakeSensorTty {
+    int master;
+    char path[64];
+
+    bool open() {
+        master = posix_openpt(O_RDWR | O_NOCTTY);
+        if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0 || ptsname_r(master, path, sizeof(path)) != 0) {
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+        if (master >= 0) {
+            ::close(master);
+            master = -1;
+        }
+    }
+
+    bool send(const uint8_t *bytes, size_t length) {
+        while (length > 0) {
+            ssize_t written = ::write(master, bytes, length);
+            if (written <= 0) {
+                return false;
+            }
+            bytes += written;
+            length -= (size_t)written;
+        }
+        return true;
+    }
+};
+
+/**
+ * @brief A frame full of bytes a cooked tty would rewrite or swallow: CR, XON/XOFF, ^C, ^D.
+ */
+static void makeFrame(uint16_t sequence, uint8_t *frame) {
+    static const uint8_t special[] = {0x0D, 0x0A, 0x11, 0x13, 0x03, 0x04, 0x7F, 0x1A};
+    beginPmsFrame(frame);
+    setPmsFrameWord(frame, 0, sequence);
+    for (size_t i = 6; i < 30; ++i) {
+        frame[i] = special[(i + sequence) % sizeof(special)];
+    }
+    sealPmsFrame(frame);
+}
+
+static void countReading(void *context, const debuguear::AirQualityModel_PMS5003T *) {
+    (*static_cast<uint32_t *>(context))++;
+}
+
+static double threadCpuMicros() {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+void test_port_reads_raw_bytes_and_sends_commands() {
+    FakeSensorTty tty;
+    TEST_ASSERT_TRUE(tty.open());
+    debuguear::LinuxSerialPort port;
+    TEST_ASSERT_FALSE(port.open(tty.path, 9601));
+    TEST_ASSERT_EQUAL(EINVAL, errno);
+    TEST_ASSERT_TRUE(port.open(tty.path, 9600));
+
+    PortRing ring;
+    debuguear::PMS5003T_FULL_PROCESSOR_T sensor(ring, 1, &port);
+    uint32_t readings = 0;
+    sensor.addObserver(countReading, &readings);
+    debuguear::LinuxSerialHub<4> hub;
+    TEST_ASSERT_TRUE(hub.isValid());
+    TEST_ASSERT_TRUE(hub.add(port, ring, sensor));
+    TEST_ASSERT_FALSE(hub.add(port, ring, sensor));
+
+    TEST_ASSERT_EQUAL(0, hub.run(10));
+    uint8_t frames[32 * 8];
+    for (uint16_t i = 0; i < 8; ++i) {
+        makeFrame(i, &frames[i * 32]);
+    }
+    TEST_ASSERT_TRUE(tty.send(frames, sizeof(frames)));
+    while (readings < 8 && hub.run(1000) > 0) {
+    }
+    TEST_ASSERT_EQUAL_UINT32(8, readings);
+    TEST_ASSERT_EQUAL_UINT32(0, sensor.stats().bytesDiscarded);
+
+    TEST_ASSERT_TRUE(sensor.setPassiveMode());
+    uint8_t command[7];
+    TEST_ASSERT_EQUAL(7, ::read(tty.master, command, sizeof(command)));
+    TEST_ASSERT_EQUAL_HEX8(0x42, command[0]);
+    TEST_ASSERT_EQUAL_HEX8(0xE1, command[2]);
+    tty.close();
+}
+
+void test_hub_closes_a_port_that_hangs_up_and_takes_it_back() {
+    FakeSensorTty tty;
+    TEST_ASSERT_TRUE(tty.open());
+    debuguear::LinuxSerialPort port;
+    TEST_ASSERT_TRUE(port.open(tty.path));
+    PortRing ring;
+    debuguear::PMS5003T_FULL_PROCESSOR_T sensor(ring, 1, &port);
+    uint32_t readings = 0;
+    sensor.addObserver(countReading, &readings);
+    debuguear::LinuxSerialHub<4> hub;
+    TEST_ASSERT_TRUE(hub.add(port, ring, sensor));
+
+    // The adapter is unplugged right after a frame.
+    uint8_t frame[32];
+    makeFrame(1, frame);
+    TEST_ASSERT_TRUE(tty.send(frame, sizeof(frame)));
+    tty.close();
+    for (int i = 0; i < 10 && port.isOpen(); ++i) {
+        hub.run(100);
+    }
+    TEST_ASSERT_FALSE(port.isOpen());
+    TEST_ASSERT_EQUAL(0, hub.run(10));
+
+    // Plugged back in, possibly under another name.
+    TEST_ASSERT_TRUE(tty.open());
+    TEST_ASSERT_TRUE(port.open(tty.path));
+    TEST_ASSERT_TRUE(hub.add(port, ring, sensor));
+    TEST_ASSERT_EQUAL(1, hub.size());
+    makeFrame(2, frame);
+    TEST_ASSERT_TRUE(tty.send(frame, sizeof(frame)));
+    uint32_t before = readings;
+    while (readings == before && hub.run(1000) > 0) {
+    }
+    TEST_ASSERT_EQUAL_UINT32(before + 1, readings);
+    tty.close();
+}
+
+/**
+ * @brief Streams `framesPerPort` frames into each of `portCount` ptys from a writer thread,
+ *        serves them with one hub and stores the hub thread CPU time per frame, in µs.
+ */
+static void serveManyPorts(size_t portCount, uint32_t framesPerPort, double *cpuPerFrameUs) {
+    std::vector<FakeSensorTty> ttys(portCount);
+    std::vector<debuguear::LinuxSerialPort> ports(portCount);
+    std::vector<PortRing> rings(portCount);
+    std::vector<debuguear::PMS5003T_FULL_PROCESSOR_T *> sensors(portCount);
+    std::vector<uint32_t> readings(portCount, 0);
+    debuguear::LinuxSerialHub<32> hub;
+    for (size_t p = 0; p < portCount; ++p) {
+        TEST_ASSERT_TRUE(ttys[p].open());
+        TEST_ASSERT_TRUE(ports[p].open(ttys[p].path));
+        sensors[p] = new debuguear::PMS5003T_FULL_PROCESSOR_T(rings[p], 1, &ports[p]);
+        sensors[p]->addObserver(countReading, &readings[p]);
+        TEST_ASSERT_TRUE(hub.add(ports[p], rings[p], *sensors[p]));
+    }
+
+    std::thread writer([&]() {
+        uint8_t frame[32];
+        for (uint32_t n = 0; n < framesPerPort; ++n) {
+            makeFrame((uint16_t)n, frame);
+            for (size_t p = 0; p < portCount; ++p) {
+                ttys[p].send(frame, sizeof(frame));
+            }
+        }
+    });
+
+    uint64_t expected = (uint64_t)portCount * framesPerPort;
+    uint64_t delivered = 0;
+    double start = threadCpuMicros();
+    while (delivered < expected && hub.run(2000) > 0) {
+        delivered = 0;
+        for (size_t p = 0; p < portCount; ++p) {
+            delivered += readings[p];
+        }
+    }
+    double cpu = threadCpuMicros() - start;
+    writer.join();
+
+    for (size_t p = 0; p < portCount; ++p) {
+        TEST_ASSERT_EQUAL_UINT32(framesPerPort, readings[p]);
+        TEST_ASSERT_EQUAL_UINT32(0, sensors[p]->stats().checksumErrors);
+        TEST_ASSERT_EQUAL_UINT32(0, sensors[p]->stats().overruns);
+        ttys[p].close();
+        delete sensors[p];
+    }
+    *cpuPerFrameUs = cpu / expected;
+    printf("[BENCH] %2u ports: %u frames, %.2f us hub CPU per frame\n", (unsigned)portCount, (unsigned)expected,
+           *cpuPerFrameUs);
+}
+
+void test_hub_cpu_per_sensor_stays_flat() {
+    double one, four, sixteen;
+    serveManyPorts(1, 4000, &one);
+    serveManyPorts(4, 2000, &four);
+    serveManyPorts(16, 1000, &sixteen);
+    // Generous bound: the host scheduler decides how many frames each wake-up finds.
+    TEST_ASSERT_TRUE(four < 2 * one + 2.0);
+    TEST_ASSERT_TRUE(sixteen < 2 * one + 2.0);
+}
+
+#endif
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+int runUnityTests(void) {
+    UNITY_BEGIN();
+#if defined(__linux__)
+    RUN_TEST(test_port_reads_raw_bytes_and_sends_commands);
+    RUN_TEST(test_hub_closes_a_port_that_hangs_up_and_takes_it_back);
+    RUN_TEST(test_hub_cpu_per_sensor_stays_flat);
+#endif
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup() {
+    // NOTE!!! Wait for >2 secs
+    // if board doesn't support software reset via Serial.DTR/RTS
+    delay(2000);
+    runUnityTests();
+}
+
+void loop() {}
+#else
+int main(int, char **) {
+    return runUnityTests();
+}
+#endif
@@ -0,0 +1,236 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "../test_air_quality/FrameBuilder.h"
+#include "../src/PMS5003T.h"
+#include "../src/ReadingLatch.h"
+
+typedef debuguear::AirQualityModel_PMS5003T Model;
+typedef debuguear::ReadingSnapshot<Model> Snapshot;
+
+/**
+ * @brief A reading whose every field is derived from `value`, so that a torn copy, mixing
+ *        two readings, cannot go unnoticed.
+ */
+static Model uniformReading(uint16_t value) {
+    Model data;
+    data.pm10_standard = value;
+    data.pm25_standard = value;
+    data.pm100_standard = value;
+    data.pm10_env = value;
+    data.pm25_env = value;
+    data.pm100_env = value;
+    data.particles_03um = value;
+    data.particles_05um = value;
+    data.particles_10um = value;
+    data.particles_25um = value;
+    data.temperature = (int16_t)value;
+    data.humedity = value;
+    data.reserved = value;
+    return data;
+}
+
+static bool isUniform(const Model &data, uint16_t value) {
+    return data.pm10_standard == value && data.pm25_standard == value && data.pm100_standard == value &&
+           data.pm10_env == value && data.pm25_env == value && data.pm100_env == value &&
+           data.particles_03um == value && data.particles_05um == value && data.particles_10um == value &&
+           data.particles_25um == value && data.temperature == (int16_t)value && data.humedity == value &&
+           data.reserved == value;
+}
+
+/**
+ * @brief The PMS5003T frame decoding to `uniformReading(value)`.
+ */
+static void uniformFrame(uint16_t value, uint8_t *frame) {
+    beginPmsFrame(frame);
+    for (size_t word = 0; word < 13; ++word) {
+        setPmsFrameWord(frame, word, value);
+    }
+    sealPmsFrame(frame);
+}
+
+struct ReaderResult {
+    uint64_t reads;
+    uint64_t torn;
+    uint64_t backwards;
+    uint64_t overtaken;     // failed `tryRead()` attempts
+};
+
+/**
+ * @brief Reads `latch` until `stop`, checking that each snapshot is one whole reading and that
+ *        the sequence never goes back.
+ */
+static void hammer(const debuguear::ReadingLatch<Model> &latch, const std::atomic<bool> &stop, bool single,
+                   ReaderResult *result) {
+    Snapshot snapshot;
+    uint32_t last = 0;
+    *result = ReaderResult();
+    while (!stop.load(std::memory_order_relaxed)) {
+        if (single) {
+            if (!latch.tryRead(snapshot)) {
+                result->overtaken += last != 0 ? 1 : 0;
+                continue;
+            }
+        } else if (!latch.read(snapshot)) {
+            continue;
+        }
+        result->reads++;
+        uint16_t value = (uint16_t)snapshot.sequence;
+        if (!isUniform(snapshot.data, value) || snapshot.timestampMs != snapshot.sequence * 3UL) {
+            result->torn++;
+        }
+        if (snapshot.sequence < last) {
+            result->backwards++;
+        }
+        last = snapshot.sequence;
+    }
+}
+
+void test_latch_keeps_the_latest_reading() {
+    debuguear::ReadingLatch<Model> latch;
+    Snapshot snapshot;
+    TEST_ASSERT_FALSE(latch.read(snapshot));
+    TEST_ASSERT_FALSE(latch.tryRead(snapshot));
+
+    latch.publish(uniformReading(7), 1000);
+    latch.publish(uniformReading(8), 2300);
+    TEST_ASSERT_TRUE(latch.tryRead(snapshot));
+    TEST_ASSERT_TRUE(isUniform(snapshot.data, 8));
+    TEST_ASSERT_EQUAL_UINT32(2, snapshot.sequence);
+    TEST_ASSERT_EQUAL_UINT32(2300, snapshot.timestampMs);
+    TEST_ASSERT_TRUE(latch.read(snapshot));
+    TEST_ASSERT_EQUAL_UINT32(2, snapshot.sequence);
+}
+
+void test_processor_publishes_every_valid_reading() {
+    debuguear::SpscRingBuffer<128> ring;
+    debuguear::PMS5003T_FULL_PROCESSOR_T processor(ring, 1);
+    debuguear::DeadbandFilter<debuguear::LayoutPMS5003T> deadband;
+    deadband.setAll(100);
+    processor.setDeadband(&deadband);
+    debuguear::ReadingSnapshot<Model> snapshot;
+    TEST_ASSERT_FALSE(processor.latestReading(snapshot));
+
+    uint8_t frame[32];
+    uniformFrame(40, frame);
+    ring.push(frame, sizeof(frame));
+    processor.loop();
+    unsigned long parsedAt = millis();
+    TEST_ASSERT_TRUE(processor.latestReading(snapshot));
+    TEST_ASSERT_EQUAL_UINT32(1, snapshot.sequence);
+    TEST_ASSERT_TRUE(isUniform(snapshot.data, 40));
+    TEST_ASSERT_UINT32_WITHIN(5, parsedAt, snapshot.timestampMs);
+
+    // Within the deadband: observers are not told, the snapshot still follows.
+    uniformFrame(41, frame);
+    ring.push(frame, sizeof(frame));
+    frame[31] ^= 0x01;  // and a corrupted one, which is not published
+    ring.push(frame, sizeof(frame));
+    processor.loop();
+    TEST_ASSERT_EQUAL_UINT32(1, deadband.suppressed());
+    TEST_ASSERT_TRUE(processor.readingLatch().tryRead(snapshot));
+    TEST_ASSERT_EQUAL_UINT32(2, snapshot.sequence);
+    TEST_ASSERT_TRUE(isUniform(snapshot.data, 41));
+}
+
+void test_concurrent_readers_never_see_a_torn_reading() {
+    static debuguear::ReadingLatch<Model> latch;
+    std::atomic<bool> stop(false);
+    const size_t readerCount = 4;
+    std::vector<ReaderResult> results(readerCount);
+    std::vector<std::thread> readers;
+    for (size_t r = 0; r < readerCount; ++r) {
+        readers.push_back(std::thread(hammer, std::cref(latch), std::cref(stop), r % 2 == 0, &results[r]));
+    }
+
+    // Far faster than any sensor, to make the writer overtake the readers as often as possible.
+    const uint32_t publishes = 2000000;
+    for (uint32_t n = 1; n <= publishes; ++n) {
+        latch.publish(uniformReading((uint16_t)n), n * 3UL);
+    }
+    stop.store(true);
+    for (size_t r = 0; r < readerCount; ++r) {
+        readers[r].join();
+    }
+
+    for (size_t r = 0; r < readerCount; ++r) {
+        printf("[BENCH] reader %u (%s): %llu reads, %llu torn, %llu backwards, %llu overtaken\n", (unsigned)r,
+               r % 2 == 0 ? "tryRead" : "read", (unsigned long long)results[r].reads,
+               (unsigned long long)results[r].torn, (unsigned long long)results[r].backwards,
+               (unsigned long long)results[r].overtaken);
+        TEST_ASSERT_TRUE(results[r].reads > 0);
+        TEST_ASSERT_EQUAL_UINT64(0, results[r].torn);
+        TEST_ASSERT_EQUAL_UINT64(0, results[r].backwards);
+    }
+}
+
+void test_readers_follow_a_running_processor() {
+    static debuguear::SpscRingBuffer<1024> ring;
+    static debuguear::PMS5003T_FULL_PROCESSOR_T processor(ring, 1);
+    std::atomic<bool> stop(false);
+    std::atomic<uint64_t> torn(0);
+    std::atomic<uint64_t> reads(0);
+    std::vector<std::thread> readers;
+    for (size_t r = 0; r < 3; ++r) {
+        readers.push_back(std::thread([&]() {
+            Snapshot snapshot;
+            while (!stop.load(std::memory_order_relaxed)) {
+                if (processor.latestReading(snapshot)) {
+                    reads++;
+                    if (!isUniform(snapshot.data, snapshot.data.pm10_standard) ||
+                        snapshot.data.pm10_standard != (uint16_t)snapshot.sequence) {
+                        torn++;
+                    }
+                }
+            }
+        }));
+    }
+
+    const uint16_t frames = 50000;
+    uint8_t frame[32];
+    for (uint16_t n = 1; n <= frames; ++n) {
+        uniformFrame(n, frame);
+        ring.push(frame, sizeof(frame));
+        processor.loop();
+    }
+    stop.store(true);
+    for (size_t r = 0; r < readers.size(); ++r) {
+        readers[r].join();
+    }
+
+    Snapshot snapshot;
+    TEST_ASSERT_TRUE(processor.latestReading(snapshot));
+    TEST_ASSERT_EQUAL_UINT32(frames, snapshot.sequence);
+    TEST_ASSERT_TRUE(reads.load() > 0);
+    TEST_ASSERT_EQUAL_UINT64(0, torn.load());
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+int runUnityTests(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_latch_keeps_the_latest_reading);
+    RUN_TEST(test_processor_publishes_every_valid_reading);
+    RUN_TEST(test_concurrent_readers_never_see_a_torn_reading);
+    RUN_TEST(test_readers_follow_a_running_processor);
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup() {
+    // NOTE!!! Wait for >2 secs
+    // if board doesn't support software reset via Serial.DTR/RTS
+    delay(2000);
+    runUnityTests();
+}
+
+void loop() {}
+#else
+int main(int, char **) {
+    return runUnityTests();
+}
+#endif
@@ -0,0 +1,199 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <chrono>
+#include <vector>
+#include "../test_air_quality/FakeStream.h"
+#include "../test_air_quality/FrameBuilder.h"
+#include "../test_native_serial_line/SerialLineSimulator.h"
+#include "../src/PMS5003T.h"
+#include "../src/SerialCapture.h"
+
+/**
+ * @brief `Print` collecting everything written, standing in for a capture file.
+ */
+class MemoryPrint : public Print {
+    public:
+        std::vector<uint8_t> bytes;
+
+        size_t write(uint8_t c) override {
+            bytes.push_back(c);
+            return 1;
+        }
+
+        size_t write(const uint8_t *buffer, size_t size) override {
+            bytes.insert(bytes.end(), buffer, buffer + size);
+            return size;
+        }
+
+        using Print::write;
+};
+
+static void collectSequence(void *context, const debuguear::AirQualityModel_PMS5003T *data) {
+    static_cast<std::vector<uint16_t> *>(context)->push_back(data->pm10_standard);
+}
+
+static void makeFrame(uint16_t sequence, uint8_t *frame) {
+    beginPmsFrame(frame);
+    setPmsFrameWord(frame, 0, sequence);
+    setPmsFrameWord(frame, 1, (uint8_t)(sequence * 7));
+    sealPmsFrame(frame);
+}
+
+void test_capture_replay_reproduces_field_session() {
+    SerialLineConfig config;
+    config.jitterUs = 150000;
+    config.bitErrorPpm = 40;
+    config.dropPpm = 200;
+    SerialLineSimulator line(config);
+    MemoryPrint file;
+    debuguear::CaptureWriter writer(file);
+    debuguear::CaptureStream tee(line, writer);
+
+    debuguear::PMS5003T_FULL_PROCESSOR_T live(&tee, 1);
+    std::vector<uint16_t> liveSequence;
+    live.addObserver(collectSequence, &liveSequence);
+    for (int i = 0; i < 30 * 60 * 100; ++i) {
+        delay(10);
+        live.loop();
+    }
+
+    // Paced on the same loop cadence, the parser sees the bytes exactly as it did live,
+    // partial frame timeouts included.
+    debuguear::ReplayStream paced(file.bytes.data(), file.bytes.size(), debuguear::REPLAY_REAL_TIME);
+    TEST_ASSERT_TRUE(paced.isValid());
+    debuguear::PMS5003T_FULL_PROCESSOR_T offline(&paced, 1);
+    std::vector<uint16_t> pacedSequence;
+    offline.addObserver(collectSequence, &pacedSequence);
+    while (!paced.finished()) {
+        offline.loop();
+        delay(10);
+    }
+
+    debuguear::ProcessorStats a = live.stats();
+    debuguear::ProcessorStats b = offline.stats();
+    TEST_ASSERT_TRUE(a.checksumErrors + a.lengthErrors + a.headerErrors > 0);
+    TEST_ASSERT_EQUAL_UINT32(line.lineStats().bytesSent - line.lineStats().bytesDropped, writer.bytesRecorded());
+    TEST_ASSERT_EQUAL_UINT32(a.framesOk, b.framesOk);
+    TEST_ASSERT_EQUAL_UINT32(a.checksumErrors, b.checksumErrors);
+    TEST_ASSERT_EQUAL_UINT32(a.lengthErrors, b.lengthErrors);
+    TEST_ASSERT_EQUAL_UINT32(a.headerErrors, b.headerErrors);
+    TEST_ASSERT_EQUAL_UINT32(a.bytesDiscarded, b.bytesDiscarded);
+    TEST_ASSERT_TRUE(liveSequence == pacedSequence);
+
+    // As fast as possible there is no time for partial frames to expire, so the error counters
+    // may differ, but the same readings come out.
+    debuguear::ReplayStream fast(file.bytes.data(), file.bytes.size());
+    debuguear::PMS5003T_FULL_PROCESSOR_T batch(&fast, 1);
+    std::vector<uint16_t> fastSequence;
+    batch.addObserver(collectSequence, &fastSequence);
+    while (!fast.finished()) {
+        batch.loop();
+    }
+    TEST_ASSERT_TRUE(liveSequence == fastSequence);
+}
+
+void test_replay_follows_recorded_timing() {
+    MemoryPrint file;
+    debuguear::CaptureWriter writer(file);
+    uint8_t burst[10] = {0};
+    writer.record(burst, sizeof(burst), 5000);
+    writer.record(burst, sizeof(burst), 1005000);
+    writer.record(burst, sizeof(burst), 2005000);
+
+    debuguear::ReplayStream realTime(file.bytes.data(), file.bytes.size(), debuguear::REPLAY_REAL_TIME);
+    TEST_ASSERT_EQUAL(10, realTime.available());
+    delay(999);
+    TEST_ASSERT_EQUAL(10, realTime.available());
+    delay(1);
+    TEST_ASSERT_EQUAL(20, realTime.available());
+
+    debuguear::ReplayStream fourTimes(file.bytes.data(), file.bytes.size(), 4);
+    TEST_ASSERT_EQUAL(10, fourTimes.available());
+    delay(250);
+    TEST_ASSERT_EQUAL(20, fourTimes.available());
+    uint8_t out[32];
+    TEST_ASSERT_EQUAL(20, fourTimes.readBytes(out, sizeof(out)));
+    TEST_ASSERT_FALSE(fourTimes.finished());
+    delay(250);
+    TEST_ASSERT_EQUAL(10, fourTimes.readBytes(out, sizeof(out)));
+    TEST_ASSERT_TRUE(fourTimes.finished());
+    TEST_ASSERT_EQUAL_UINT32(2000000, (uint32_t)fourTimes.replayedMicros());
+
+    const uint8_t notACapture[8] = {0x42, 0x4D, 0x00, 0x1C, 0, 0, 0, 0};
+    debuguear::ReplayStream invalid(notACapture, sizeof(notACapture));
+    TEST_ASSERT_FALSE(invalid.isValid());
+    TEST_ASSERT_EQUAL(0, invalid.available());
+    TEST_ASSERT_TRUE(invalid.finished());
+}
+
+void test_capture_groups_bytes_read_one_at_a_time() {
+    uint8_t frame[32];
+    makeFrame(1, frame);
+    FakeStream stream(frame, sizeof(frame));
+    MemoryPrint file;
+    debuguear::CaptureWriter writer(file);
+    debuguear::CaptureStream tee(stream, writer);
+    while (tee.read() >= 0) {
+    }
+    // Header, then a single record: delta 0, length 32, the frame.
+    TEST_ASSERT_EQUAL(5 + 2 + 32, file.bytes.size());
+    TEST_ASSERT_EQUAL_INT(0, memcmp(frame, &file.bytes[7], sizeof(frame)));
+}
+
+void test_replay_a_day_of_traffic() {
+    static const uint32_t FRAMES = 24 * 3600;
+    MemoryPrint file;
+    debuguear::CaptureWriter writer(file);
+    uint8_t frame[32];
+    for (uint32_t i = 0; i < FRAMES; ++i) {
+        makeFrame((uint16_t)i, frame);
+        // As read by a loop polling every 10 ms: the frame split over two reads.
+        writer.record(frame, 12, i * 1000000UL);
+        writer.record(frame + 12, 20, i * 1000000UL + 10000);
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    debuguear::ReplayStream replay(file.bytes.data(), file.bytes.size());
+    debuguear::PMS5003T_FULL_PROCESSOR_T processor(&replay, 1);
+    while (!replay.finished()) {
+        processor.loop();
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    printf("[BENCH] replayed %u frames (%.1f MB capture, 24 h) in %.1f ms\n", (unsigned)FRAMES,
+           file.bytes.size() / 1e6, ms);
+    TEST_ASSERT_EQUAL_UINT32(FRAMES, processor.stats().framesOk);
+    TEST_ASSERT_EQUAL_UINT32(0, processor.stats().bytesDiscarded);
+}
+
+void setUp(void) {
+    arduino_shim::useVirtualClock(1000000);
+}
+
+void tearDown(void) {
+    arduino_shim::useRealClock();
+}
+
+int runUnityTests(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_capture_replay_reproduces_field_session);
+    RUN_TEST(test_replay_follows_recorded_timing);
+    RUN_TEST(test_capture_groups_bytes_read_one_at_a_time);
+    RUN_TEST(test_replay_a_day_of_traffic);
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup() {
+    // NOTE!!! Wait for >2 secs
+    // if board doesn't support software reset via Serial.DTR/RTS
+    delay(2000);
+    runUnityTests();
+}
+
+void loop() {}
+#else
+int main(int, char **) {
+    return runUnityTests();
+}
+#endif
@@ -0,0 +1,219 @@
+#ifndef AIRQUALITY_TEST_SERIAL_LINE_SIMULATOR
+#define AIRQUALITY_TEST_SERIAL_LINE_SIMULATOR
+
+#include <Arduino.h>
+#include <vector>
+#include "../test_air_quality/FrameBuilder.h"
+
+/**
+ * @brief Parameters of a simulated sensor UART.
+ */
+struct SerialLineConfig {
+    uint32_t baud = 9600;
+    uint8_t bitsPerByte = 10;           // 8N1: start + 8 data + stop
+    uint32_t frameIntervalUs = 1000000; // time between two frame starts
+    uint32_t jitterUs = 0;              // frame starts move by up to +/- jitterUs
+    uint32_t bitErrorPpm = 0;           // per data bit, at most one flipped bit per byte is modelled
+    uint32_t dropPpm = 0;               // bytes lost on the line (framing errors), per million
+    size_t rxBufferSize = 64;           // core RX buffer, bytes arriving while it is full are lost
+};
+
+/**
+ * @brief Counters of what the simulated sensor sent and what the line did to it.
+ */
+struct SerialLineStats {
+    uint32_t framesSent;
+    uint32_t framesCompleted;           // last byte already on the line
+    uint32_t framesIntact;              // every byte reached the RX buffer unchanged
+    uint32_t bytesSent;
+    uint32_t bytesCorrupted;
+    uint32_t bytesDropped;
+    uint32_t bytesOverflowed;
+    uint32_t bytesLostAsleep;           // arrived while the receiver was stopped
+};
+
+/**
+ * @brief `Stream` receiving PMS5003T frames over a simulated serial line, on the virtual clock
+ *        of the native shim.
+ *
+ * Bytes become available one at a time, `bitsPerByte / baud` apart, as the virtual clock moves
+ * (`delay()`, `arduino_shim::advanceMicros()`), so hours of sensor output run in a fraction of
+ * a second. The first data word (`pm10_standard`) of every frame carries its sequence number,
+ * which lets a test match a notification with the arrival time of its frame.
+ *
+ * Frames start `frameIntervalUs` apart plus a random jitter, never before the previous frame
+ * ended. Bit errors, dropped bytes and RX buffer overflows are drawn from a seeded generator,
+ * so a run is reproducible.
+ */
+class SerialLineSimulator : public Stream {
+    public:
+        static const size_t FRAME_LENGTH = 32;
+
+        explicit SerialLineSimulator(const SerialLineConfig &config, uint32_t seed = 0x5EED)
+            : config(config), rx(config.rxBufferSize), rxHead(0), rxCount(0), state(seed ? seed : 1),
+              framePos(FRAME_LENGTH), frameStartNs(0), nextFrameNs(arduino_shim::nowMicros() * 1000),
+              intact(false), receiverStopped(false), stats() {}
+
+        const SerialLineStats &lineStats() const {
+            return stats;
+        }
+
+        /**
+         * @brief Stops or restarts the receiver, as the clock gating of ESP32 light sleep does:
+         *        bytes whose last bit arrives while it is stopped are lost.
+         */
+        void setReceiverStopped(bool stopped) {
+            this->advance();
+            receiverStopped = stopped;
+        }
+
+        /**
+         * @brief Time the last byte of frame `sequence` (as read from `pm10_standard`) was
+         *        received, in virtual microseconds, or 0 if that frame did not arrive intact.
+         */
+        uint64_t arrivalMicros(uint16_t sequence) const {
+            if (arrivals.empty()) {
+                return 0;
+            }
+            uint16_t age = (uint16_t)((uint16_t)(arrivals.size() - 1) - sequence);
+            if (age >= arrivals.size()) {
+                return 0;
+            }
+            return arrivals[arrivals.size() - 1 - age];
+        }
+
+        int available() override {
+            this->advance();
+            return (int)rxCount;
+        }
+
+        int read() override {
+            this->advance();
+            if (rxCount == 0) {
+                return -1;
+            }
+            uint8_t c = rx[rxHead];
+            rxHead = (rxHead + 1) % rx.size();
+            rxCount--;
+            return c;
+        }
+
+        int peek() override {
+            this->advance();
+            return rxCount == 0 ? -1 : rx[rxHead];
+        }
+
+        size_t write(uint8_t) override {
+            // The simulated sensor stays in active mode; commands are ignored.
+            return 1;
+        }
+
+        using Print::write;
+
+    private:
+        SerialLineConfig config;
+        std::vector<uint8_t> rx;
+        size_t rxHead;
+        size_t rxCount;
+        uint32_t state;
+        uint8_t frame[FRAME_LENGTH];
+        size_t framePos;
+        uint64_t frameStartNs;
+        uint64_t nextFrameNs;
+        bool intact;
+        bool receiverStopped;
+        SerialLineStats stats;
+        std::vector<uint64_t> arrivals;   // per frame: last byte received, 0 if not intact
+
+        uint32_t next() {
+            // xorshift32, deterministic across platforms.
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return state;
+        }
+
+        bool chance(uint32_t ppm) {
+            return ppm != 0 && next() % 1000000 < ppm;
+        }
+
+        uint64_t byteTimeNs() const {
+            return (uint64_t)config.bitsPerByte * 1000000000ULL / config.baud;
+        }
+
+        /**
+         * @brief Delivers every byte whose last bit was received by the current virtual time.
+         */
+        void advance() {
+            uint64_t now = arduino_shim::nowMicros() * 1000;
+            while (true) {
+                if (framePos == FRAME_LENGTH) {
+                    if (nextFrameNs + byteTimeNs() > now) {
+                        return;
+                    }
+                    this->startFrame();
+                }
+                uint64_t at = frameStartNs + (framePos + 1) * byteTimeNs();
+                if (at > now) {
+                    return;
+                }
+                this->receive(frame[framePos++]);
+                if (framePos == FRAME_LENGTH) {
+                    arrivals.push_back(intact ? at / 1000 : 0);
+                    stats.framesCompleted++;
+                    stats.framesIntact += intact ? 1 : 0;
+                }
+            }
+        }
+
+        void startFrame() {
+            uint16_t sequence = (uint16_t)stats.framesSent;
+            beginPmsFrame(frame, FRAME_LENGTH);
+            setPmsFrameWord(frame, 0, sequence);
+            for (size_t word = 1; word < (FRAME_LENGTH - 6) / 2; ++word) {
+                setPmsFrameWord(frame, word, (uint16_t)(next() % 1000));
+            }
+            sealPmsFrame(frame, FRAME_LENGTH);
+
+            frameStartNs = nextFrameNs;
+            framePos = 0;
+            intact = true;
+            stats.framesSent++;
+
+            int64_t jitter = 0;
+            if (config.jitterUs != 0) {
+                jitter = (int64_t)(next() % (2 * config.jitterUs + 1)) - (int64_t)config.jitterUs;
+            }
+            uint64_t end = frameStartNs + FRAME_LENGTH * byteTimeNs();
+            int64_t start = (int64_t)frameStartNs + (int64_t)config.frameIntervalUs * 1000 + jitter * 1000;
+            nextFrameNs = start < (int64_t)end ? end : (uint64_t)start;
+        }
+
+        void receive(uint8_t c) {
+            stats.bytesSent++;
+            if (receiverStopped) {
+                stats.bytesLostAsleep++;
+                intact = false;
+                return;
+            }
+            if (this->chance(config.dropPpm)) {
+                stats.bytesDropped++;
+                intact = false;
+                return;
+            }
+            if (this->chance(config.bitErrorPpm * 8)) {
+                c ^= (uint8_t)(1 << (next() % 8));
+                stats.bytesCorrupted++;
+                intact = false;
+            }
+            if (rxCount == rx.size()) {
+                stats.bytesOverflowed++;
+                intact = false;
+                return;
+            }
+            rx[(rxHead + rxCount) % rx.size()] = c;
+            rxCount++;
+        }
+};
+
+#endif
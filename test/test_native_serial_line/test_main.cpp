@@ -0,0 +1,192 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "../src/PMS5003T.h"
+#include "SerialLineSimulator.h"
+#include "../test_air_quality/FakeStream.h"
+
+/**
+ * @brief Matches notifications with the arrival time of their frame.
+ */
+struct DeliveryProbe {
+    SerialLineSimulator *line;
+    uint32_t delivered;
+    uint32_t unmatched;         // frames the line did not deliver intact, should stay 0
+    uint64_t latencySumUs;
+    uint64_t latencyMaxUs;
+
+    static void onReading(void *context, const debuguear::AirQualityModel_PMS5003T *data) {
+        DeliveryProbe *probe = static_cast<DeliveryProbe *>(context);
+        uint64_t arrival = probe->line->arrivalMicros(data->pm10_standard);
+        if (arrival == 0) {
+            probe->unmatched++;
+            return;
+        }
+        uint64_t latency = arduino_shim::nowMicros() - arrival;
+        probe->delivered++;
+        probe->latencySumUs += latency;
+        probe->latencyMaxUs = latency > probe->latencyMaxUs ? latency : probe->latencyMaxUs;
+    }
+};
+
+/**
+ * @brief Calls `loop()` every `loopPeriodUs` for `durationUs` of virtual time.
+ */
+static DeliveryProbe runLine(SerialLineSimulator &line, uint32_t loopPeriodUs, uint64_t durationUs) {
+    debuguear::PMS5003T_PROCESSOR_T processor(&line, 1);
+    DeliveryProbe probe = {&line, 0, 0, 0, 0};
+    processor.addObserver(DeliveryProbe::onReading, &probe);
+    uint64_t end = arduino_shim::nowMicros() + durationUs;
+    while (arduino_shim::nowMicros() < end) {
+        arduino_shim::advanceMicros(loopPeriodUs);
+        processor.loop();
+    }
+    return probe;
+}
+
+void test_line_delivers_bytes_at_baud_rate() {
+    SerialLineConfig config;
+    SerialLineSimulator line(config);
+    // 10 bits at 9600 baud: one byte every 1.04 ms, a frame takes 33.3 ms.
+    delay(20);
+    TEST_ASSERT_EQUAL(19, line.available());
+    delay(14);
+    TEST_ASSERT_EQUAL(32, line.available());
+    uint8_t buffer[32];
+    TEST_ASSERT_EQUAL(32, line.readBytes(buffer, sizeof(buffer)));
+    TEST_ASSERT_EQUAL_HEX8(0x42, buffer[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x4D, buffer[1]);
+
+    // Nothing more until the next frame starts, one interval after the first.
+    delay(960);
+    TEST_ASSERT_EQUAL(0, line.available());
+    delay(10);
+    TEST_ASSERT_TRUE(line.available() > 0);
+    TEST_ASSERT_EQUAL(2, line.lineStats().framesSent);
+}
+
+void test_line_overflows_finite_rx_buffer() {
+    SerialLineConfig config;
+    config.frameIntervalUs = 100000;
+    SerialLineSimulator line(config);
+    delay(1000);
+    TEST_ASSERT_EQUAL(64, line.available());
+    TEST_ASSERT_EQUAL(10, line.lineStats().framesSent);
+    TEST_ASSERT_EQUAL(2, line.lineStats().framesIntact);
+    TEST_ASSERT_EQUAL(8 * 32, line.lineStats().bytesOverflowed);
+}
+
+void test_line_faults_lose_only_damaged_frames() {
+    SerialLineConfig config;
+    config.jitterUs = 200000;
+    config.bitErrorPpm = 50;
+    config.dropPpm = 300;
+    SerialLineSimulator line(config);
+    DeliveryProbe probe = runLine(line, 10000, 3600ULL * 1000000);
+
+    const SerialLineStats &stats = line.lineStats();
+    TEST_ASSERT_TRUE(stats.bytesCorrupted > 0);
+    TEST_ASSERT_TRUE(stats.bytesDropped > 0);
+    TEST_ASSERT_TRUE(stats.framesIntact < stats.framesSent);
+    TEST_ASSERT_EQUAL(0, probe.unmatched);
+    TEST_ASSERT_EQUAL(stats.framesIntact, probe.delivered);
+}
+
+void test_loop_stall_in_the_middle_of_a_frame_keeps_it() {
+    SerialLineConfig config;
+    SerialLineSimulator line(config);
+    debuguear::PMS5003T_FULL_PROCESSOR_T processor(&line, 1);
+    DeliveryProbe probe = {&line, 0, 0, 0, 0};
+    processor.addObserver(DeliveryProbe::onReading, &probe);
+
+    // Half of the first frame is parsed, then the loop stalls for 1.5 s: the tail of that frame
+    // and the whole next one wait in the 64-byte RX buffer.
+    delay(15);
+    processor.loop();
+    TEST_ASSERT_EQUAL(0, probe.delivered);
+    delay(1500);
+    processor.loop();
+    TEST_ASSERT_EQUAL(2, probe.delivered);
+
+    for (int ms = 0; ms < 3000; ++ms) {
+        delay(1);
+        processor.loop();
+    }
+    TEST_ASSERT_EQUAL(0, line.lineStats().bytesOverflowed);
+    TEST_ASSERT_EQUAL(line.lineStats().framesCompleted, probe.delivered);
+    TEST_ASSERT_EQUAL_UINT32(0, processor.stats().bytesDiscarded);
+}
+
+void test_partial_frame_times_out_when_the_line_goes_quiet() {
+    // Only the first 20 bytes of a frame ever arrive.
+    uint8_t partial[20] = {0x42, 0x4D, 0x00, 0x1C};
+    FakeStream stream(partial, sizeof(partial));
+    debuguear::PMS5003T_FULL_PROCESSOR_T processor(&stream, 1);
+    processor.loop();
+    delay(900);
+    processor.loop();
+    TEST_ASSERT_EQUAL_UINT32(0, processor.stats().bytesDiscarded);
+    delay(200);
+    processor.loop();
+    TEST_ASSERT_EQUAL_UINT32(20, processor.stats().bytesDiscarded);
+}
+
+void test_line_loss_and_latency_across_loop_periods() {
+    static const uint32_t periodsMs[] = {1, 10, 50, 200, 500, 1000, 2500};
+    const uint64_t hours = 4;
+
+    for (size_t i = 0; i < sizeof(periodsMs) / sizeof(periodsMs[0]); ++i) {
+        SerialLineConfig config;
+        config.jitterUs = 100000;
+        SerialLineSimulator line(config, 0x1234 + i);
+        DeliveryProbe probe = runLine(line, periodsMs[i] * 1000, hours * 3600 * 1000000);
+
+        const SerialLineStats &stats = line.lineStats();
+        double loss = 100.0 * (stats.framesCompleted - probe.delivered) / stats.framesCompleted;
+        double avgMs = probe.delivered ? probe.latencySumUs / 1000.0 / probe.delivered : 0;
+        printf("[SIM] loop every %4u ms: %6u frames, %6.2f%% lost (%u bytes overflowed), "
+               "latency avg %7.2f ms max %7.2f ms\n",
+               (unsigned)periodsMs[i], (unsigned)stats.framesCompleted, loss, (unsigned)stats.bytesOverflowed,
+               avgMs, probe.latencyMaxUs / 1000.0);
+
+        TEST_ASSERT_EQUAL(0, probe.unmatched);
+        if (periodsMs[i] <= 500) {
+            // The 64-byte buffer holds a whole frame: nothing is lost, and a frame waits at most one period.
+            TEST_ASSERT_EQUAL(stats.framesCompleted, probe.delivered);
+            TEST_ASSERT_TRUE(probe.latencyMaxUs <= periodsMs[i] * 1000ULL);
+        }
+    }
+}
+
+void setUp(void) {
+    arduino_shim::useVirtualClock(1000000);
+}
+
+void tearDown(void) {
+    arduino_shim::useRealClock();
+}
+
+int runUnityTests(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_line_delivers_bytes_at_baud_rate);
+    RUN_TEST(test_line_overflows_finite_rx_buffer);
+    RUN_TEST(test_line_faults_lose_only_damaged_frames);
+    RUN_TEST(test_loop_stall_in_the_middle_of_a_frame_keeps_it);
+    RUN_TEST(test_partial_frame_times_out_when_the_line_goes_quiet);
+    RUN_TEST(test_line_loss_and_latency_across_loop_periods);
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup() {
+    // NOTE!!! Wait for >2 secs
+    // if board doesn't support software reset via Serial.DTR/RTS
+    delay(2000);
+    runUnityTests();
+}
+
+void loop() {}
+#else
+int main(int, char **) {
+    return runUnityTests();
+}
+#endif
@@ -0,0 +1,229 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "../test_air_quality/FakeStream.h"
+#include "../src/PMS5003T.h"
+#include "../src/AirQualityStatistics.h"
+
+typedef debuguear::AirQualityStatistics<debuguear::AirQualityModel_PMS5003T, debuguear::STAT_FIELDS_AQI> Statistics;
+
+static debuguear::AirQualityModel_PMS5003T reading(uint16_t pm25, uint16_t pm100) {
+    debuguear::AirQualityModel_PMS5003T data;
+    data.clean();
+    data.pm25_env = pm25;
+    data.pm100_env = pm100;
+    return data;
+}
+
+void test_field_statistics_one_minute_window() {
+    debuguear::FieldStatistics stats;
+    TEST_ASSERT_FALSE(stats.summary(debuguear::WINDOW_1_MIN).valid);
+
+    // One reading per second: 10 for the first 30 s, then 20.
+    for (unsigned long t = 0; t < 60; ++t) {
+        stats.add(t < 30 ? 10 : 20, t * 1000);
+    }
+    debuguear::WindowSummary minute = stats.summary(debuguear::WINDOW_1_MIN);
+    TEST_ASSERT_TRUE(minute.valid);
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 15.0, minute.mean);
+    TEST_ASSERT_EQUAL_UINT16(10, minute.min);
+    TEST_ASSERT_EQUAL_UINT16(20, minute.max);
+    TEST_ASSERT_TRUE(minute.ema > 10.0f && minute.ema < 20.0f);
+
+    // A minute later the low readings have left the window.
+    for (unsigned long t = 60; t < 120; ++t) {
+        stats.add(20, t * 1000);
+    }
+    minute = stats.summary(debuguear::WINDOW_1_MIN);
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 20.0, minute.mean);
+    TEST_ASSERT_EQUAL_UINT16(20, minute.min);
+
+    debuguear::WindowSummary quarter = stats.summary(debuguear::WINDOW_15_MIN);
+    TEST_ASSERT_EQUAL_UINT16(10, quarter.min);
+    TEST_ASSERT_FLOAT_WITHIN(0.5, 17.5, quarter.mean);
+}
+
+void test_field_statistics_expire_without_readings() {
+    debuguear::FieldStatistics stats;
+    stats.add(30, 0);
+    stats.advance(16UL * 60 * 1000);
+    TEST_ASSERT_FALSE(stats.summary(debuguear::WINDOW_1_MIN).valid);
+    TEST_ASSERT_FALSE(stats.summary(debuguear::WINDOW_15_MIN).valid);
+    TEST_ASSERT_TRUE(stats.summary(debuguear::WINDOW_24_H).valid);
+
+    stats.advance(25UL * 3600 * 1000);
+    TEST_ASSERT_FALSE(stats.summary(debuguear::WINDOW_24_H).valid);
+}
+
+static bool sameSummary(const debuguear::WindowSummary &a, const debuguear::WindowSummary &b) {
+    return a.valid == b.valid && a.mean == b.mean && a.ema == b.ema && a.min == b.min && a.max == b.max;
+}
+
+void test_field_statistics_skip_long_gaps_like_bucket_by_bucket() {
+    // Gaps ending inside a minute, crossing minutes, crossing hours and just short of a day.
+    const unsigned long gaps[] = {7000UL, 185000UL, 8255000UL, 86395000UL};
+    for (size_t g = 0; g < sizeof(gaps) / sizeof(gaps[0]); ++g) {
+        debuguear::FieldStatistics skipped;
+        debuguear::FieldStatistics stepped;
+        unsigned long t = 0;
+        for (; t < 14UL * 3600 * 1000; t += 4000) {
+            uint16_t value = (uint16_t)(20 + (t / 3600000UL) * 7 + (t / 4000) % 5);
+            skipped.add(value, t);
+            stepped.add(value, t);
+        }
+        unsigned long resume = t + gaps[g];
+        for (unsigned long at = t; at < resume; at += 5000) {
+            stepped.advance(at);
+        }
+        skipped.add(50, resume);
+        stepped.add(50, resume);
+
+        for (uint8_t w = 0; w < debuguear::WINDOW_COUNT; ++w) {
+            debuguear::StatWindow window = (debuguear::StatWindow)w;
+            TEST_ASSERT_TRUE(sameSummary(stepped.summary(window), skipped.summary(window)));
+        }
+        TEST_ASSERT_EQUAL_FLOAT(stepped.nowcast(), skipped.nowcast());
+    }
+}
+
+void test_field_statistics_include_open_buckets() {
+    debuguear::FieldStatistics stats;
+    // Right after a restart, a few seconds of readings: no bucket closed yet.
+    stats.add(20, 0);
+    stats.add(30, 1000);
+    for (uint8_t window = 0; window < debuguear::WINDOW_COUNT; ++window) {
+        debuguear::WindowSummary summary = stats.summary((debuguear::StatWindow)window);
+        TEST_ASSERT_TRUE(summary.valid);
+        TEST_ASSERT_FLOAT_WITHIN(0.01, 25.0, summary.mean);
+        TEST_ASSERT_EQUAL_UINT16(30, summary.max);
+    }
+
+    // Two steady hours, then a spike still in the open 5 s bucket.
+    for (unsigned long t = 2; t < 2 * 3600; ++t) {
+        stats.add(10, t * 1000);
+    }
+    stats.add(500, 2UL * 3600 * 1000 + 1000);
+    TEST_ASSERT_EQUAL_UINT16(500, stats.summary(debuguear::WINDOW_15_MIN).max);
+    TEST_ASSERT_EQUAL_UINT16(500, stats.summary(debuguear::WINDOW_24_H).max);
+    TEST_ASSERT_EQUAL_UINT16(10, stats.summary(debuguear::WINDOW_24_H).min);
+}
+
+void test_nowcast_and_aqi() {
+    Statistics stats;
+    // Twelve hours at 40 µg/m³ PM2.5 and 100 µg/m³ PM10, one reading every 10 s.
+    for (unsigned long t = 0; t <= 12UL * 3600; t += 10) {
+        debuguear::AirQualityModel_PMS5003T data = reading(40, 100);
+        stats.add(data, t * 1000);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 40.0, stats.nowcastPm25());
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 100.0, stats.nowcastPm100());
+    TEST_ASSERT_EQUAL_INT16(112, stats.aqiPm25());
+    TEST_ASSERT_EQUAL_INT16(73, stats.aqiPm100());
+    TEST_ASSERT_EQUAL_INT16(112, stats.aqi());
+
+    debuguear::WindowSummary day = stats.summary(Statistics::PM25_ENV, debuguear::WINDOW_24_H);
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 40.0, day.mean);
+}
+
+void test_nowcast_weights_recent_hours() {
+    debuguear::FieldStatistics stats;
+    // Eleven clean hours followed by one very polluted hour.
+    for (unsigned long t = 0; t <= 12UL * 3600; t += 10) {
+        stats.add(t < 11UL * 3600 ? 10 : 100, t * 1000);
+    }
+    // w = 10/100 is floored at 0.5: (100 + 10 * (0.5 + ... + 0.5^11)) / (1 + 0.5 + ... + 0.5^11)
+    TEST_ASSERT_FLOAT_WITHIN(0.05, 55.01, stats.nowcast());
+}
+
+void test_nowcast_requires_recent_hours() {
+    debuguear::FieldStatistics stats;
+    TEST_ASSERT_TRUE(stats.nowcast() < 0);
+    for (unsigned long t = 0; t <= 3600; t += 10) {
+        stats.add(12, t * 1000);
+    }
+    // Only one complete hour so far.
+    TEST_ASSERT_TRUE(stats.nowcast() < 0);
+    TEST_ASSERT_EQUAL_INT16(-1, debuguear::aqiFromPm25(stats.nowcast()));
+}
+
+void test_aqi_breakpoints() {
+    TEST_ASSERT_EQUAL_INT16(0, debuguear::aqiFromPm25(0));
+    TEST_ASSERT_EQUAL_INT16(50, debuguear::aqiFromPm25(9.0f));
+    TEST_ASSERT_EQUAL_INT16(51, debuguear::aqiFromPm25(9.1f));
+    TEST_ASSERT_EQUAL_INT16(100, debuguear::aqiFromPm25(35.49f));
+    TEST_ASSERT_EQUAL_INT16(500, debuguear::aqiFromPm25(500));
+    TEST_ASSERT_EQUAL_INT16(50, debuguear::aqiFromPm100(54.9f));
+    TEST_ASSERT_EQUAL_INT16(151, debuguear::aqiFromPm100(255));
+}
+
+void test_statistics_observer() {
+    static const uint8_t frame[32] = {
+        0x42, 0x4D, 0x00, 0x1C,
+        0x00, 0x32, 0x00, 0x64, 0x00, 0x96,  // PM standard
+        0x00, 0x32, 0x00, 0x64, 0x00, 0x96,  // PM env
+        0x00, 0x32, 0x00, 0x64, 0x00, 0x96, 0x00, 0x96,  // Particles
+        0x00, 0x01,  // Temperature
+        0x00, 0x02,  // Humidity
+        0x00, 0x00,  // Reserved
+        0x04, 0xc8   // Checksum
+    };
+    Statistics stats;
+    FakeStream stream(frame, sizeof(frame));
+    debuguear::PMS5003T_PROCESSOR_T processor(&stream, 1);
+    TEST_ASSERT_TRUE(processor.addObserver(Statistics::onReading, &stats));
+    processor.loop();
+
+    debuguear::WindowSummary minute = stats.summary(Statistics::PM25_ENV, debuguear::WINDOW_1_MIN);
+    TEST_ASSERT_TRUE(minute.valid);
+    TEST_ASSERT_EQUAL_UINT16(100, minute.max);
+}
+
+void test_default_statistics_track_pm25_only() {
+    typedef debuguear::AirQualityStatistics<debuguear::AirQualityModel_PMS5003T> Pm25Statistics;
+    TEST_ASSERT_EQUAL(sizeof(debuguear::FieldStatistics), sizeof(Pm25Statistics));
+    TEST_ASSERT_TRUE(Pm25Statistics::tracks(Pm25Statistics::PM25_ENV));
+    TEST_ASSERT_FALSE(Pm25Statistics::tracks(Pm25Statistics::PM100_ENV));
+
+    Pm25Statistics stats;
+    for (unsigned long t = 0; t <= 3UL * 3600; t += 10) {
+        stats.add(reading(40, 100), t * 1000);
+    }
+    TEST_ASSERT_TRUE(stats.summary(Pm25Statistics::PM25_ENV, debuguear::WINDOW_1_MIN).valid);
+    TEST_ASSERT_FALSE(stats.summary(Pm25Statistics::PM100_ENV, debuguear::WINDOW_1_MIN).valid);
+    TEST_ASSERT_NULL(stats.field(Pm25Statistics::PM100_ENV));
+    TEST_ASSERT_TRUE(stats.nowcastPm100() < 0);
+    TEST_ASSERT_EQUAL_INT16(112, stats.aqi());
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+int runUnityTests(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_field_statistics_one_minute_window);
+    RUN_TEST(test_field_statistics_expire_without_readings);
+    RUN_TEST(test_field_statistics_skip_long_gaps_like_bucket_by_bucket);
+    RUN_TEST(test_field_statistics_include_open_buckets);
+    RUN_TEST(test_nowcast_and_aqi);
+    RUN_TEST(test_nowcast_weights_recent_hours);
+    RUN_TEST(test_nowcast_requires_recent_hours);
+    RUN_TEST(test_aqi_breakpoints);
+    RUN_TEST(test_statistics_observer);
+    RUN_TEST(test_default_statistics_track_pm25_only);
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup() {
+    // NOTE!!! Wait for >2 secs
+    // if board doesn't support software reset via Serial.DTR/RTS
+    delay(2000);
+    runUnityTests();
+}
+
+void loop() {}
+#else
+int main(int, char **) {
+    return runUnityTests();
+}
+#endif
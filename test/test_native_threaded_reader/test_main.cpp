@@ -0,0 +1,240 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "../test_air_quality/FakeStream.h"
+#include "../test_air_quality/FrameBuilder.h"
+#include "../src/PMS5003T.h"
+#include "../src/ThreadedReader.h"
+
+typedef debuguear::AirQualityModel_PMS5003T Model;
+
+/**
+ * @brief PMS5003T frames tagged with a producer id (`pm25_standard`) and a sequence number
+ *        (`pm10_standard`).
+ */
+static std::vector<uint8_t> taggedFrames(uint16_t producer, size_t count) {
+    std::vector<uint8_t> bytes;
+    for (size_t n = 0; n < count; ++n) {
+        uint8_t frame[PMS5003T_FRAME_LENGTH];
+        beginPmsFrame(frame);
+        setPmsFrameWord(frame, 0, (uint16_t)n);
+        setPmsFrameWord(frame, 1, producer);
+        sealPmsFrame(frame);
+        bytes.insert(bytes.end(), frame, frame + sizeof(frame));
+    }
+    return bytes;
+}
+
+/**
+ * @brief Stream releasing its bytes at `bytesPerSecond` of real time from the first call,
+ *        like a UART fed by a sensor.
+ */
+class PacedStream : public Stream {
+    private:
+        const uint8_t *data;
+        size_t size;
+        size_t position;
+        double bytesPerMicro;
+        unsigned long start;
+        bool started;
+
+        size_t arrived() {
+            if (!started) {
+                start = micros();
+                started = true;
+            }
+            size_t count = (size_t)((unsigned long)(micros() - start) * bytesPerMicro);
+            return count < size ? count : size;
+        }
+
+    public:
+        PacedStream(const uint8_t *data, size_t size, uint32_t bytesPerSecond)
+            : data(data), size(size), position(0), bytesPerMicro(bytesPerSecond / 1e6), start(0), started(false) {}
+
+        int available() override {
+            return (int)(arrived() - position);
+        }
+
+        int read() override {
+            return position < arrived() ? data[position++] : -1;
+        }
+
+        int peek() override {
+            return position < arrived() ? data[position] : -1;
+        }
+
+        size_t write(uint8_t) override {
+            return 1;
+        }
+
+        using Print::write;
+};
+
+static Model reading(uint16_t sequence) {
+    Model data;
+    data.clean();
+    data.pm10_standard = sequence;
+    return data;
+}
+
+void test_queue_fifo_and_drop_oldest() {
+    debuguear::BoundedReadingQueue<Model, 4> queue;
+    for (uint16_t i = 0; i < 6; ++i) {
+        queue.push(reading(i));
+    }
+    TEST_ASSERT_EQUAL_UINT32(6, queue.pushed());
+    TEST_ASSERT_EQUAL_UINT32(2, queue.dropped());
+
+    Model out;
+    for (uint16_t i = 2; i < 6; ++i) {
+        TEST_ASSERT_TRUE(queue.tryReceive(out));
+        TEST_ASSERT_EQUAL(i, out.pm10_standard);
+    }
+    TEST_ASSERT_FALSE(queue.tryReceive(out));
+}
+
+void test_queue_receive_waits_for_a_reading() {
+    debuguear::BoundedReadingQueue<Model, 4> queue;
+    Model out;
+    unsigned long start = millis();
+    TEST_ASSERT_FALSE(queue.receive(out, 30));
+    TEST_ASSERT_TRUE(millis() - start >= 29);
+
+    std::thread producer([&queue]() {
+        delay(20);
+        queue.push(reading(7));
+    });
+    TEST_ASSERT_TRUE(queue.receive(out, 2000));
+    TEST_ASSERT_EQUAL(7, out.pm10_standard);
+    producer.join();
+}
+
+void test_reader_publishes_every_frame() {
+    std::vector<uint8_t> bytes = taggedFrames(1, 100);
+    FakeStream stream(bytes.data(), bytes.size());
+    debuguear::PMS5003T_FULL_PROCESSOR_T processor(&stream, 1);
+    debuguear::BoundedReadingQueue<Model, 128> queue;
+    debuguear::ThreadedReader<debuguear::LayoutPMS5003T, debuguear::FULL_MAX_OBSERVERS, debuguear::SENSOR_FEATURES_ALL> reader(processor, queue);
+
+    TEST_ASSERT_TRUE(reader.start());
+    TEST_ASSERT_FALSE(reader.start());
+    Model out;
+    for (uint16_t i = 0; i < 100; ++i) {
+        TEST_ASSERT_TRUE(queue.receive(out, 2000));
+        TEST_ASSERT_EQUAL(i, out.pm10_standard);
+    }
+    reader.stop();
+    TEST_ASSERT_FALSE(reader.isRunning());
+    TEST_ASSERT_EQUAL_UINT32(0, queue.dropped());
+    TEST_ASSERT_EQUAL_UINT32(100, processor.stats().framesOk);
+}
+
+void test_reader_sustained_throughput_many_producers_and_consumers() {
+    static const int PRODUCERS = 4;
+    static const int CONSUMERS = 3;
+    static const size_t FRAMES = 4000;
+    // Each producer streams frames hundreds of times faster than a PMS sensor, yet at a steady
+    // pace: consumers keep up, and the queue covers a 100 ms stall of the host scheduler.
+    static const uint32_t FRAMES_PER_SECOND = 2000;
+    static const size_t QUEUE_SIZE = 1024;
+
+    std::vector<uint8_t> bytes[PRODUCERS];
+    PacedStream *streams[PRODUCERS];
+    debuguear::PMS5003T_FULL_PROCESSOR_T *processors[PRODUCERS];
+    debuguear::ThreadedReader<debuguear::LayoutPMS5003T, debuguear::FULL_MAX_OBSERVERS, debuguear::SENSOR_FEATURES_ALL> *readers[PRODUCERS];
+    static debuguear::BoundedReadingQueue<Model, QUEUE_SIZE> queue;
+    for (int p = 0; p < PRODUCERS; ++p) {
+        bytes[p] = taggedFrames((uint16_t)p, FRAMES);
+        streams[p] = new PacedStream(bytes[p].data(), bytes[p].size(), FRAMES_PER_SECOND * 32);
+        processors[p] = new debuguear::PMS5003T_FULL_PROCESSOR_T(streams[p], 1);
+        readers[p] = new debuguear::ThreadedReader<debuguear::LayoutPMS5003T, debuguear::FULL_MAX_OBSERVERS, debuguear::SENSOR_FEATURES_ALL>(*processors[p], queue);
+    }
+
+    std::atomic<bool> done(false);
+    std::atomic<uint32_t> received(0);
+    std::atomic<uint32_t> outOfOrder(0);
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < CONSUMERS; ++c) {
+        consumers.push_back(std::thread([&]() {
+            int32_t last[PRODUCERS];
+            for (int p = 0; p < PRODUCERS; ++p) {
+                last[p] = -1;
+            }
+            Model out;
+            while (true) {
+                if (!queue.receive(out, 20)) {
+                    if (done.load()) {
+                        break;
+                    }
+                    continue;
+                }
+                // Each consumer sees the readings of a producer in order, with gaps where
+                // other consumers took some.
+                if ((int32_t)out.pm10_standard <= last[out.pm25_standard]) {
+                    outOfOrder++;
+                }
+                last[out.pm25_standard] = out.pm10_standard;
+                received++;
+            }
+        }));
+    }
+
+    unsigned long start = millis();
+    for (int p = 0; p < PRODUCERS; ++p) {
+        TEST_ASSERT_TRUE(readers[p]->start());
+    }
+    while (queue.pushed() < PRODUCERS * FRAMES && millis() - start < 10000) {
+        delay(1);
+    }
+    unsigned long elapsed = millis() - start;
+    for (int p = 0; p < PRODUCERS; ++p) {
+        readers[p]->stop();
+    }
+    done.store(true);
+    for (size_t c = 0; c < consumers.size(); ++c) {
+        consumers[c].join();
+    }
+
+    printf("[BENCH] %d readers -> %d consumers: %u readings in %lu ms, %u dropped\n", PRODUCERS, CONSUMERS,
+           (unsigned)queue.pushed(), elapsed, (unsigned)queue.dropped());
+    TEST_ASSERT_EQUAL_UINT32(PRODUCERS * FRAMES, queue.pushed());
+    TEST_ASSERT_EQUAL_UINT32(0, queue.dropped());
+    TEST_ASSERT_EQUAL_UINT32(queue.pushed(), received.load());
+    TEST_ASSERT_EQUAL_UINT32(0, outOfOrder.load());
+
+    for (int p = 0; p < PRODUCERS; ++p) {
+        delete readers[p];
+        delete processors[p];
+        delete streams[p];
+    }
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+int runUnityTests(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_queue_fifo_and_drop_oldest);
+    RUN_TEST(test_queue_receive_waits_for_a_reading);
+    RUN_TEST(test_reader_publishes_every_frame);
+    RUN_TEST(test_reader_sustained_throughput_many_producers_and_consumers);
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup() {
+    // NOTE!!! Wait for >2 secs
+    // if board doesn't support software reset via Serial.DTR/RTS
+    delay(2000);
+    runUnityTests();
+}
+
+void loop() {}
+#else
+int main(int, char **) {
+    return runUnityTests();
+}
+#endif
@@ -0,0 +1,144 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "../src/PMS5003T.h"
+#include "../src/PMS5003ST.h"
+#include "../src/ReadingFormat.h"
+
+typedef debuguear::AirQualityModel_PMS5003T Model;
+
+/**
+ * @brief `Print` sink collecting the output as a C string.
+ */
+class BufferPrint : public Print {
+    public:
+        char text[256];
+        size_t length = 0;
+        size_t writes = 0;
+
+        size_t write(uint8_t c) override {
+            return this->write(&c, 1);
+        }
+
+        size_t write(const uint8_t *buffer, size_t size) override {
+            writes++;
+            for (size_t i = 0; i < size && length + 1 < sizeof(text); ++i) {
+                text[length++] = (char)buffer[i];
+            }
+            text[length] = '\0';
+            return size;
+        }
+};
+
+static Model sample() {
+    Model data;
+    data.clean();
+    data.pm10_standard = 5;
+    data.pm25_standard = 8;
+    data.pm100_standard = 11;
+    data.pm10_env = 5;
+    data.pm25_env = 8;
+    data.pm100_env = 12;
+    data.particles_03um = 1203;
+    data.particles_05um = 360;
+    data.particles_10um = 61;
+    data.particles_25um = 4;
+    data.temperature = -5;
+    data.humedity = 457;
+    return data;
+}
+
+void test_format_csv() {
+    char buf[debuguear::FormatBounds<Model>::CSV];
+    size_t length = debuguear::formatCsv(sample(), buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_STRING("5,8,11,5,8,12,1203,360,61,4,-0.5,45.7\n", buf);
+    TEST_ASSERT_EQUAL(strlen(buf), length);
+
+    char header[debuguear::FormatBounds<Model>::CSV_HEADER];
+    debuguear::formatCsvHeader<Model>(header, sizeof(header));
+    TEST_ASSERT_EQUAL_STRING("pm10_standard,pm25_standard,pm100_standard,pm10_env,pm25_env,pm100_env,"
+                             "particles_03um,particles_05um,particles_10um,particles_25um,temperature,humidity\n", header);
+}
+
+void test_format_json() {
+    char buf[debuguear::FormatBounds<Model>::JSON];
+    debuguear::formatJson(sample(), buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_STRING("{\"pm10_standard\":5,\"pm25_standard\":8,\"pm100_standard\":11,\"pm10_env\":5,"
+                             "\"pm25_env\":8,\"pm100_env\":12,\"particles_03um\":1203,\"particles_05um\":360,"
+                             "\"particles_10um\":61,\"particles_25um\":4,\"temperature\":-0.5,\"humidity\":45.7}", buf);
+}
+
+void test_format_line_protocol() {
+    char buf[debuguear::FormatBounds<Model>::lineProtocol(12)];
+    debuguear::formatLineProtocol(sample(), "pms,room=lab", buf, sizeof(buf), 1700000000123ULL);
+    TEST_ASSERT_EQUAL_STRING("pms,room=lab pm10_standard=5i,pm25_standard=8i,pm100_standard=11i,pm10_env=5i,"
+                             "pm25_env=8i,pm100_env=12i,particles_03um=1203i,particles_05um=360i,particles_10um=61i,"
+                             "particles_25um=4i,temperature=-0.5,humidity=45.7 1700000000123\n", buf);
+}
+
+void test_format_bounds_hold_extreme_values() {
+    debuguear::AirQualityModel_PMS5003ST data;
+    data.clean();
+    data.pm10_standard = data.pm25_standard = data.pm100_standard = 65535;
+    data.pm10_env = data.pm25_env = data.pm100_env = 65535;
+    data.particles_03um = data.particles_05um = data.particles_10um = 65535;
+    data.particles_25um = data.particles_50um = data.particles_100um = 65535;
+    data.formaldehyde = 65535;
+    data.temperature = -32768;
+    data.humedity = 65535;
+
+    typedef debuguear::FormatBounds<debuguear::AirQualityModel_PMS5003ST> Bounds;
+    char buf[Bounds::lineProtocol(3)];
+    TEST_ASSERT_GREATER_THAN(0, debuguear::formatCsv(data, buf, Bounds::CSV));
+    TEST_ASSERT_GREATER_THAN(0, debuguear::formatCsvHeader<debuguear::AirQualityModel_PMS5003ST>(buf, Bounds::CSV_HEADER));
+    TEST_ASSERT_GREATER_THAN(0, debuguear::formatJson(data, buf, Bounds::JSON));
+    TEST_ASSERT_TRUE(strstr(buf, "\"formaldehyde\":65.535,\"temperature\":-3276.8,\"humidity\":6553.5}") != nullptr);
+    TEST_ASSERT_GREATER_THAN(0, debuguear::formatLineProtocol(data, "pms", buf, sizeof(buf), 18446744073709551615ULL));
+    TEST_ASSERT_TRUE(strstr(buf, " 18446744073709551615\n") != nullptr);
+}
+
+void test_format_too_small_buffer() {
+    char buf[16];
+    TEST_ASSERT_EQUAL(0, debuguear::formatJson(sample(), buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_STRING("", buf);
+}
+
+void test_format_to_print() {
+    char expected[debuguear::FormatBounds<Model>::JSON];
+    size_t length = debuguear::formatJson(sample(), expected, sizeof(expected));
+
+    BufferPrint out;
+    TEST_ASSERT_EQUAL(length, debuguear::formatJson(sample(), out));
+    TEST_ASSERT_EQUAL_STRING(expected, out.text);
+    // Output is handed over in chunks, not byte by byte.
+    TEST_ASSERT_LESS_THAN(length / 8, out.writes);
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+int runUnityTests(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_format_csv);
+    RUN_TEST(test_format_json);
+    RUN_TEST(test_format_line_protocol);
+    RUN_TEST(test_format_bounds_hold_extreme_values);
+    RUN_TEST(test_format_too_small_buffer);
+    RUN_TEST(test_format_to_print);
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup() {
+    // NOTE!!! Wait for >2 secs
+    // if board doesn't support software reset via Serial.DTR/RTS
+    delay(2000);
+    runUnityTests();
+}
+
+void loop() {}
+#else
+int main(int, char **) {
+    return runUnityTests();
+}
+#endif
@@ -0,0 +1,200 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "../src/PMS5003T.h"
+#include "../src/internal/ByteRingBuffer.h"
+
+#ifndef ARDUINO
+#include <thread>
+#endif
+
+static const uint8_t validFrame[32] = {
+        0x42, 0x4D, 0x00, 0x1C,
+        0x00, 0x32, 0x00, 0x64, 0x00, 0x96,  // PM standard
+        0x00, 0x32, 0x00, 0x64, 0x00, 0x96,  // PM env
+        0x00, 0x32, 0x00, 0x64, 0x00, 0x96, 0x00, 0x96,  // Particles
+        0x00, 0x01,  // Temperature
+        0x00, 0x02,  // Humidity
+        0x00, 0x00,  // Reserved
+        0x04, 0xc8   // Checksum
+    };
+
+int observerCalls = 0;
+uint16_t lastPm25Env = 0;
+
+void observerFunction(debuguear::AirQualityModel_PMS5003T* data) {
+    observerCalls++;
+    lastPm25Env = data->pm25_env;
+}
+
+void test_ring_push_pop_and_overrun() {
+    debuguear::SpscRingBuffer<4> ring;
+    TEST_ASSERT_TRUE(ring.push(1));
+    TEST_ASSERT_TRUE(ring.push(2));
+    TEST_ASSERT_TRUE(ring.push(3));
+    TEST_ASSERT_TRUE(ring.push(4));
+    TEST_ASSERT_FALSE(ring.push(5));
+    TEST_ASSERT_EQUAL(1, ring.overrunCount());
+    TEST_ASSERT_EQUAL(4, ring.available());
+    TEST_ASSERT_EQUAL(1, ring.pop());
+    TEST_ASSERT_EQUAL(3, ring.peek(1));
+    ring.skip(3);
+    TEST_ASSERT_EQUAL(-1, ring.pop());
+}
+
+void test_ring_writable_and_commit() {
+    debuguear::SpscRingBuffer<8> ring;
+    size_t room;
+    uint8_t *dst = ring.writable(room);
+    TEST_ASSERT_EQUAL(8, room);
+    memcpy(dst, "abcdef", 6);
+    ring.commit(6);
+    ring.skip(4);
+
+    // The free space wraps around the end of the storage: two contiguous runs.
+    dst = ring.writable(room);
+    TEST_ASSERT_EQUAL(2, room);
+    memcpy(dst, "gh", 2);
+    ring.commit(2);
+    dst = ring.writable(room);
+    TEST_ASSERT_EQUAL(4, room);
+    memcpy(dst, "ijkl", 4);
+    ring.commit(4);
+    ring.writable(room);
+    TEST_ASSERT_EQUAL(0, room);
+
+    uint8_t scratch[8];
+    TEST_ASSERT_EQUAL(8, ring.available());
+    TEST_ASSERT_EQUAL_MEMORY("efghijkl", ring.linearize(8, scratch), 8);
+}
+
+void test_ring_processor_waits_for_complete_frame() {
+    debuguear::SpscRingBuffer<64> ring;
+    debuguear::PMS5003T_FULL_PROCESSOR_T processor(ring, 1);
+    processor.addObserver(observerFunction);
+
+    ring.push(0x00); // line noise
+    ring.push(validFrame, 20);
+    processor.loop();
+    TEST_ASSERT_EQUAL(0, observerCalls);
+
+    ring.push(&validFrame[20], 12);
+    processor.loop();
+    TEST_ASSERT_EQUAL(1, observerCalls);
+    TEST_ASSERT_EQUAL_UINT16(100, lastPm25Env);
+    TEST_ASSERT_EQUAL(0, ring.available());
+}
+
+void test_ring_processor_frame_wrapping_storage() {
+    debuguear::SpscRingBuffer<64> ring;
+    debuguear::PMS5003T_FULL_PROCESSOR_T processor(ring, 1);
+    processor.addObserver(observerFunction);
+
+    // Move the indices so the next frame straddles the end of the storage.
+    uint8_t filler[50] = {0};
+    ring.push(filler, sizeof(filler));
+    processor.loop();
+    ring.skip(ring.available());
+
+    ring.push(validFrame, sizeof(validFrame));
+    processor.loop();
+    TEST_ASSERT_EQUAL(1, observerCalls);
+}
+
+void test_ring_processor_acknowledgements() {
+    // Passive mode acknowledgement, then a frame, through a ring processor with a transmit side.
+    static const uint8_t ack[8] = {0x42, 0x4D, 0x00, 0x04, 0xE1, 0x00, 0x01, 0x74};
+    debuguear::SpscRingBuffer<64> ring;
+    debuguear::PMS5003T_FULL_PROCESSOR_T silent(ring, 1);
+    TEST_ASSERT_FALSE(silent.setPassiveMode());
+
+    debuguear::PMS5003T_FULL_PROCESSOR_T processor(ring, 1, &Serial);
+    processor.addObserver(observerFunction);
+    ring.push(ack, sizeof(ack));
+    processor.loop();
+    TEST_ASSERT_EQUAL(1, processor.acksReceived());
+    TEST_ASSERT_EQUAL_UINT8(debuguear::PMS_CMD_CHANGE_MODE, processor.lastAcknowledgedCommand());
+    TEST_ASSERT_EQUAL(0, ring.available());
+
+    ring.push(validFrame, sizeof(validFrame));
+    processor.loop();
+    TEST_ASSERT_EQUAL(1, observerCalls);
+    TEST_ASSERT_EQUAL(1, processor.framesReceived());
+}
+
+void test_ring_processor_latest_wins() {
+    debuguear::SpscRingBuffer<128> ring;
+    debuguear::PMS5003T_FULL_PROCESSOR_T processor(ring, 1);
+    processor.addObserver(observerFunction);
+    processor.setBacklogPolicy(debuguear::BACKLOG_LATEST_WINS);
+
+    for (int i = 0; i < 3; ++i) {
+        ring.push(validFrame, sizeof(validFrame));
+    }
+    ring.push(validFrame, 10); // partial frame, left for the next call
+    processor.loop();
+    TEST_ASSERT_EQUAL(1, observerCalls);
+    TEST_ASSERT_EQUAL_UINT32(2, processor.stats().framesSuperseded);
+    TEST_ASSERT_EQUAL(10, ring.available());
+}
+
+#ifndef ARDUINO
+void test_ring_threaded_producer() {
+    static const int FRAMES = 2000;
+    debuguear::SpscRingBuffer<128> ring;
+    debuguear::PMS5003T_FULL_PROCESSOR_T processor(ring, 1);
+    processor.addObserver(observerFunction);
+
+    // The producer thread stands in for the UART RX interrupt.
+    std::thread producer([&ring]() {
+        for (int n = 0; n < FRAMES; ++n) {
+            for (size_t i = 0; i < sizeof(validFrame); ++i) {
+                while (!ring.push(validFrame[i])) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+    });
+
+    while (observerCalls < FRAMES) {
+        processor.loop();
+    }
+    producer.join();
+    TEST_ASSERT_EQUAL(FRAMES, observerCalls);
+}
+#endif
+
+void setUp(void) {
+    observerCalls = 0;
+    lastPm25Env = 0;
+}
+
+void tearDown(void) {}
+
+int runUnityTests(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_ring_push_pop_and_overrun);
+    RUN_TEST(test_ring_writable_and_commit);
+    RUN_TEST(test_ring_processor_waits_for_complete_frame);
+    RUN_TEST(test_ring_processor_frame_wrapping_storage);
+    RUN_TEST(test_ring_processor_acknowledgements);
+    RUN_TEST(test_ring_processor_latest_wins);
+#ifndef ARDUINO
+    RUN_TEST(test_ring_threaded_producer);
+#endif
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup() {
+    // NOTE!!! Wait for >2 secs
+    // if board doesn't support software reset via Serial.DTR/RTS
+    delay(2000);
+    runUnityTests();
+}
+
+void loop() {}
+#else
+int main(int, char **) {
+    return runUnityTests();
+}
+#endif
@@ -0,0 +1,176 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <type_traits>
+#include "../test_air_quality/FakeStream.h"
+#include "../src/PMS5003T.h"
+#include "../src/SensorPoller.h"
+#include "../src/RequestScheduler.h"
+
+static const uint8_t validFrame[32] = {
+        0x42, 0x4D, 0x00, 0x1C,
+        0x00, 0x32, 0x00, 0x64, 0x00, 0x96,  // PM standard
+        0x00, 0x32, 0x00, 0x64, 0x00, 0x96,  // PM env
+        0x00, 0x32, 0x00, 0x64, 0x00, 0x96, 0x00, 0x96,  // Particles
+        0x00, 0x01,  // Temperature
+        0x00, 0x02,  // Humidity
+        0x00, 0x00,  // Reserved
+        0x04, 0xc8   // Checksum
+    };
+
+static const size_t NOISE_LENGTH = 600;
+uint8_t noisyStream[NOISE_LENGTH + 32];
+
+int calls[4] = {0, 0, 0, 0};
+
+void observer0(debuguear::AirQualityModel_PMS5003T*) { calls[0]++; }
+void observer1(debuguear::AirQualityModel_PMS5003T*) { calls[1]++; }
+void observer2(debuguear::AirQualityModel_PMS5003T*) { calls[2]++; }
+void observer3(debuguear::AirQualityModel_PMS5003T*) { calls[3]++; }
+
+void test_processors_are_independent() {
+    static_assert(!std::is_copy_constructible<debuguear::PMS5003T_PROCESSOR_T>::value, "processors must not be copied");
+    FakeStream first(validFrame, sizeof(validFrame));
+    FakeStream second(validFrame, sizeof(validFrame));
+    debuguear::PMS5003T_PROCESSOR_T a(&first, 1);
+    debuguear::PMS5003T_PROCESSOR_T b(&second, 1);
+    a.addObserver(observer0);
+    b.addObserver(observer1);
+    a.loop();
+    b.loop();
+    TEST_ASSERT_EQUAL(1, calls[0]);
+    TEST_ASSERT_EQUAL(1, calls[1]);
+}
+
+void test_poller_does_not_starve_quiet_sensors() {
+    // Sensor 0 is desynchronized and flooding the loop with garbage.
+    memset(noisyStream, 0x55, NOISE_LENGTH);
+    memcpy(&noisyStream[NOISE_LENGTH], validFrame, sizeof(validFrame));
+
+    FakeStream noisy(noisyStream, sizeof(noisyStream));
+    FakeStream quiet1(validFrame, sizeof(validFrame));
+    FakeStream quiet2(validFrame, sizeof(validFrame));
+    FakeStream quiet3(validFrame, sizeof(validFrame));
+    debuguear::PMS5003T_FULL_PROCESSOR_T s0(&noisy, 1), s1(&quiet1, 1), s2(&quiet2, 1), s3(&quiet3, 1);
+    s0.addObserver(observer0);
+    s1.addObserver(observer1);
+    s2.addObserver(observer2);
+    s3.addObserver(observer3);
+
+    debuguear::SensorPoller<4> poller(64);
+    TEST_ASSERT_TRUE(poller.add(s0));
+    TEST_ASSERT_TRUE(poller.add(s1));
+    TEST_ASSERT_TRUE(poller.add(s2));
+    TEST_ASSERT_TRUE(poller.add(s3));
+
+    // Every quiet sensor is notified in the very first tick.
+    TEST_ASSERT_EQUAL(64 + 32 * 3, poller.tick());
+    TEST_ASSERT_EQUAL(0, calls[0]);
+    TEST_ASSERT_EQUAL(1, calls[1]);
+    TEST_ASSERT_EQUAL(1, calls[2]);
+    TEST_ASSERT_EQUAL(1, calls[3]);
+
+    // The noisy sensor keeps draining at its own budget and eventually recovers.
+    int ticks = 1;
+    while (calls[0] == 0 && ticks < 100) {
+        poller.tick();
+        ticks++;
+    }
+    TEST_ASSERT_EQUAL(1, calls[0]);
+    TEST_ASSERT_EQUAL((NOISE_LENGTH + 32 + 63) / 64, ticks);
+}
+
+void test_poller_capacity() {
+    FakeStream stream(validFrame, sizeof(validFrame));
+    debuguear::PMS5003T_FULL_PROCESSOR_T s0(&stream, 1), s1(&stream, 1);
+    debuguear::SensorPoller<1> poller(32);
+    TEST_ASSERT_TRUE(poller.add(s0));
+    TEST_ASSERT_FALSE(poller.add(s1));
+    TEST_ASSERT_EQUAL(1, poller.size());
+}
+
+void test_scheduler_pipelines_requests() {
+    uint8_t frames[32 * 4];
+    for (int i = 0; i < 4; ++i) {
+        memcpy(&frames[i * 32], validFrame, 32);
+    }
+    FakeStream first(frames, sizeof(frames));
+    FakeStream second(frames, sizeof(frames));
+    debuguear::PMS5003T_FULL_PROCESSOR_T s0(&first, 1), s1(&second, 1);
+    s0.addObserver(observer0);
+    s1.addObserver(observer1);
+
+    debuguear::RequestScheduler<2> scheduler(1000, 50);
+    TEST_ASSERT_TRUE(scheduler.add(s0));
+    TEST_ASSERT_TRUE(scheduler.add(s1));
+    TEST_ASSERT_EQUAL(2, scheduler.begin());
+    TEST_ASSERT_TRUE(first.isPassive());
+
+    // Both requests go out in the same tick, before either sensor answered.
+    TEST_ASSERT_EQUAL(2, scheduler.tick());
+    TEST_ASSERT_EQUAL(2, scheduler.inFlight());
+    TEST_ASSERT_EQUAL(0, scheduler.tick());
+    TEST_ASSERT_EQUAL(0, scheduler.inFlight());
+    TEST_ASSERT_EQUAL(1, calls[0]);
+    TEST_ASSERT_EQUAL(1, calls[1]);
+    TEST_ASSERT_EQUAL(1, scheduler.status(0).completed);
+    TEST_ASSERT_EQUAL(1, scheduler.status(1).completed);
+
+    // Not due again before the interval.
+    TEST_ASSERT_EQUAL(0, scheduler.tick());
+}
+
+void test_scheduler_times_out_and_retries() {
+    FakeStream stream(validFrame, sizeof(validFrame));
+    debuguear::PMS5003T_FULL_PROCESSOR_T sensor(&stream, 1);
+    sensor.addObserver(observer0);
+    debuguear::RequestScheduler<1> scheduler(1000, 20);
+    scheduler.add(sensor);
+    scheduler.begin();
+
+    stream.ignoreReads(1);
+    TEST_ASSERT_EQUAL(1, scheduler.tick());
+    TEST_ASSERT_EQUAL(0, scheduler.tick());
+    TEST_ASSERT_EQUAL(1, scheduler.inFlight());
+
+    delay(25);
+    // The lost request expires and is sent again right away.
+    TEST_ASSERT_EQUAL(1, scheduler.tick());
+    TEST_ASSERT_EQUAL(1, scheduler.status(0).timeouts);
+    scheduler.tick();
+    TEST_ASSERT_EQUAL(1, calls[0]);
+    TEST_ASSERT_EQUAL(1, scheduler.status(0).completed);
+    TEST_ASSERT_FALSE(scheduler.status(0).inFlight);
+}
+
+void setUp(void) {
+    for (int i = 0; i < 4; ++i) {
+        calls[i] = 0;
+    }
+}
+
+void tearDown(void) {}
+
+int runUnityTests(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_processors_are_independent);
+    RUN_TEST(test_poller_does_not_starve_quiet_sensors);
+    RUN_TEST(test_poller_capacity);
+    RUN_TEST(test_scheduler_pipelines_requests);
+    RUN_TEST(test_scheduler_times_out_and_retries);
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup() {
+    // NOTE!!! Wait for >2 secs
+    // if board doesn't support software reset via Serial.DTR/RTS
+    delay(2000);
+    runUnityTests();
+}
+
+void loop() {}
+#else
+int main(int, char **) {
+    return runUnityTests();
+}
+#endif